@@ -0,0 +1,157 @@
+/**
+ * @brief Coroutine versions of reading, parsing, packing and writing and helpers to compose them
+ *
+ * @copyright maksimshchavelev © 2025 maksimshchavelev@gmail.com
+ * @license MIT
+ */
+
+#pragma once
+
+#include "async/scheduler.hpp"
+#include "async/task.hpp"
+#include "base_struct/base_struct.hpp"
+#include <functional>
+#include <optional>
+#include <string>
+#include <vector>
+
+namespace optoctreeparser {
+
+/**
+ * @brief Coroutine versions of `Reader`, `Parser` and `Writer` and helpers to compose them
+ *
+ * Every operation first moves to the given scheduler, so I/O and CPU work can run on different
+ * thread pools and overlap. Arguments are taken by value, because they must outlive the
+ * suspended coroutine.
+ *
+ * @section example_usage Example usage
+ *
+ * @code{.cpp}
+ * Scheduler io(2);
+ * Scheduler cpu;
+ *
+ * // At most 4 batches are in memory at once
+ * Async::sync_wait(Async::for_each(paths.size(), 4, [&](std::size_t i) -> Task<void> {
+ *     OptocRoot batch = co_await Async::parse_batch(cpu, co_await Async::read(io, paths[i]));
+ *     transform(batch);
+ *     co_await Async::write(io, out_paths[i], co_await Async::pack_batch(cpu, std::move(batch)));
+ * }));
+ * @endcode
+ */
+class Async {
+  public:
+    /**
+     * @brief Reads file on scheduler
+     * @param scheduler Scheduler
+     * @param path Path to file
+     * @return Task with `OptocTreeView`
+     *
+     * @throws `std::system_error` when:
+     * - file opening error
+     */
+    static Task<OptocTreeView> read(Scheduler& scheduler, std::string path);
+
+    /**
+     * @brief Writes file on scheduler
+     * @param scheduler Scheduler
+     * @param path Path to file
+     * @param view Bytes to write
+     * @return Task
+     *
+     * @throws `std::system_error` when:
+     * - file opening error
+     */
+    static Task<void> write(Scheduler& scheduler, std::string path, OptocTreeView view);
+
+    /**
+     * @brief Parses batch on scheduler
+     * @param scheduler Scheduler
+     * @param view Bytes of `.optoctrees`
+     * @return Task with `OptocRoot`
+     *
+     * @throws `std::out_of_range` when:
+     * - input is truncated
+     */
+    static Task<OptocRoot> parse_batch(Scheduler& scheduler, OptocTreeView view);
+
+    /**
+     * @brief Packs batch on scheduler
+     * @param scheduler Scheduler
+     * @param batch `OptocRoot`
+     * @return Task with `OptocTreeView`
+     */
+    static Task<OptocTreeView> pack_batch(Scheduler& scheduler, OptocRoot batch);
+
+    /**
+     * @brief Parses patch on scheduler
+     * @param scheduler Scheduler
+     * @param view Bytes of `.optoctreepatch`
+     * @return Task with `OptocPatchRoot`
+     *
+     * @throws `std::out_of_range` when:
+     * - input is truncated
+     */
+    static Task<OptocPatchRoot> parse_patch(Scheduler& scheduler, OptocTreeView view);
+
+    /**
+     * @brief Packs patch on scheduler
+     * @param scheduler Scheduler
+     * @param patch `OptocPatchRoot`
+     * @return Task with `OptocTreeView`
+     */
+    static Task<OptocTreeView> pack_patch(Scheduler& scheduler, OptocPatchRoot patch);
+
+    /**
+     * @brief Runs tasks concurrently and waits for all of them
+     * @param tasks Tasks
+     * @return Task that is finished when all tasks are finished
+     *
+     * @throws The first exception thrown by tasks, after all of them are finished
+     */
+    static Task<void> when_all(std::vector<Task<void>> tasks);
+
+    /**
+     * @brief Runs `function(index)` for every index in `[0, count)` with at most
+     * `max_in_flight` of them unfinished at once. The next index starts only when one of the
+     * running ones is finished, so memory used by the pipeline is bounded
+     * @param count Count of items
+     * @param max_in_flight Maximum count of unfinished items. `0` is treated as 1
+     * @param function Function that makes task for index
+     * @return Task that is finished when all items are finished
+     *
+     * @throws The first exception thrown by tasks. No new items are started after it
+     */
+    static Task<void> for_each(std::size_t                                   count,
+                               std::size_t                                   max_in_flight,
+                               std::function<Task<void>(std::size_t index)> function);
+
+    /**
+     * @brief Runs task and blocks the calling thread until it is finished
+     * @param task Task
+     *
+     * @throws Exception thrown by the task
+     *
+     * @note Must not be called from a thread of a scheduler the task needs, it would deadlock
+     * when the scheduler has one thread
+     */
+    static void sync_wait(Task<void> task);
+
+    /**
+     * @brief Runs task and blocks the calling thread until it is finished
+     * @param task Task
+     * @return Value of the task
+     *
+     * @throws Exception thrown by the task
+     */
+    template <typename T> static T sync_wait(Task<T> task) {
+        std::optional<T> result;
+        auto             store = [&result](Task<T> inner) -> Task<void> {
+            result.emplace(co_await std::move(inner));
+        };
+
+        sync_wait(store(std::move(task)));
+        return std::move(*result);
+    }
+};
+
+} // namespace optoctreeparser
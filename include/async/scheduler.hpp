@@ -0,0 +1,87 @@
+/**
+ * @brief Thread pool that resumes coroutines
+ *
+ * @copyright maksimshchavelev © 2025 maksimshchavelev@gmail.com
+ * @license MIT
+ */
+
+#pragma once
+
+#include <condition_variable>
+#include <coroutine>
+#include <deque>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace optoctreeparser {
+
+/**
+ * @brief Thread pool that resumes coroutines
+ *
+ * A coroutine moves to a thread of the scheduler with `co_await scheduler.schedule()`. Using
+ * separate schedulers for file I/O and for parsing keeps both busy at the same time.
+ *
+ * @note Coroutines queued before the scheduler is destroyed are still resumed by its threads
+ */
+class Scheduler {
+  public:
+    /**
+     * @brief Awaiter that resumes the awaiting coroutine on a thread of the scheduler
+     */
+    struct ScheduleAwaiter {
+        Scheduler& scheduler; ///< Scheduler to resume on
+
+        bool await_ready() const noexcept {
+            return false;
+        }
+
+        void await_suspend(std::coroutine_handle<> handle) const {
+            scheduler.post(handle);
+        }
+
+        void await_resume() const noexcept {}
+    };
+
+    /**
+     * @brief Starts threads
+     * @param thread_count Count of threads. `0` means hardware concurrency
+     */
+    explicit Scheduler(std::size_t thread_count = 0);
+
+    Scheduler(const Scheduler&) = delete;
+    Scheduler& operator=(const Scheduler&) = delete;
+
+    /**
+     * @brief Awaitable that moves the awaiting coroutine to a thread of the scheduler
+     * @return `ScheduleAwaiter`
+     */
+    ScheduleAwaiter schedule() noexcept;
+
+    /**
+     * @brief Queues coroutine to be resumed on a thread of the scheduler
+     * @param handle Suspended coroutine
+     */
+    void post(std::coroutine_handle<> handle);
+
+    /**
+     * @brief Count of threads
+     * @return Count of threads
+     */
+    std::size_t thread_count() const;
+
+  private:
+    std::mutex                          mutex_;
+    std::condition_variable_any         ready_;
+    std::deque<std::coroutine_handle<>> queue_;
+    std::vector<std::jthread>           threads_; ///< Last member, so threads are joined first
+
+    /**
+     * @brief Loop of one thread. Resumes queued coroutines until stop is requested and the
+     * queue is empty
+     * @param stop Stop token of thread
+     */
+    void run(std::stop_token stop);
+};
+
+} // namespace optoctreeparser
@@ -0,0 +1,254 @@
+/**
+ * @brief Lazy coroutine task
+ *
+ * @copyright maksimshchavelev © 2025 maksimshchavelev@gmail.com
+ * @license MIT
+ */
+
+#pragma once
+
+#include <coroutine>
+#include <exception>
+#include <optional>
+#include <stdexcept>
+#include <utility>
+
+namespace optoctreeparser {
+
+template <typename T> class Task;
+
+
+namespace detail {
+
+/**
+ * @brief Part of promise shared by all `Task` types
+ */
+class TaskPromiseBase {
+  public:
+    /**
+     * @brief Resumes the awaiting coroutine when the task is finished
+     */
+    struct FinalAwaiter {
+        bool await_ready() const noexcept {
+            return false;
+        }
+
+        template <typename Promise>
+        std::coroutine_handle<> await_suspend(std::coroutine_handle<Promise> handle) noexcept {
+            std::coroutine_handle<> continuation = handle.promise().continuation_;
+            return continuation ? continuation : std::noop_coroutine();
+        }
+
+        void await_resume() const noexcept {}
+    };
+
+    std::suspend_always initial_suspend() const noexcept {
+        return {};
+    }
+
+    FinalAwaiter final_suspend() const noexcept {
+        return {};
+    }
+
+    void unhandled_exception() noexcept {
+        error_ = std::current_exception();
+    }
+
+    /**
+     * @brief Sets coroutine to resume when the task is finished
+     * @param continuation Awaiting coroutine
+     */
+    void set_continuation(std::coroutine_handle<> continuation) noexcept {
+        continuation_ = continuation;
+    }
+
+  protected:
+    std::coroutine_handle<> continuation_;
+    std::exception_ptr      error_;
+
+    /**
+     * @brief Rethrows exception of the task body, if any
+     */
+    void rethrow_if_failed() const {
+        if (error_)
+            std::rethrow_exception(error_);
+    }
+};
+
+
+/**
+ * @brief Promise of `Task<T>`
+ */
+template <typename T> class TaskPromise : public TaskPromiseBase {
+  public:
+    Task<T> get_return_object() noexcept;
+
+    template <typename Value> void return_value(Value&& value) {
+        value_.emplace(std::forward<Value>(value));
+    }
+
+    /**
+     * @brief Result of the task
+     * @return Value returned by the task body
+     *
+     * @throws Exception thrown by the task body
+     */
+    T result() {
+        rethrow_if_failed();
+        return std::move(*value_);
+    }
+
+  private:
+    std::optional<T> value_;
+};
+
+
+/**
+ * @brief Promise of `Task<void>`
+ */
+template <> class TaskPromise<void> : public TaskPromiseBase {
+  public:
+    Task<void> get_return_object() noexcept;
+
+    void return_void() const noexcept {}
+
+    /**
+     * @brief Result of the task
+     *
+     * @throws Exception thrown by the task body
+     */
+    void result() const {
+        rethrow_if_failed();
+    }
+};
+
+
+/**
+ * @brief Coroutine that starts immediately and destroys itself when finished
+ */
+struct DetachedTask {
+    struct promise_type {
+        DetachedTask get_return_object() const noexcept {
+            return {};
+        }
+
+        std::suspend_never initial_suspend() const noexcept {
+            return {};
+        }
+
+        std::suspend_never final_suspend() const noexcept {
+            return {};
+        }
+
+        void return_void() const noexcept {}
+
+        void unhandled_exception() const noexcept {
+            std::terminate();
+        }
+    };
+};
+
+} // namespace detail
+
+
+/**
+ * @brief Lazy coroutine that produces a value of type `T`
+ *
+ * The body does not run until the task is awaited. The awaiting coroutine is suspended and
+ * resumed on the thread that finishes the task, exceptions of the body are rethrown from
+ * `co_await`. A task can be awaited only once, awaiting a moved-from task throws
+ * `std::logic_error`.
+ *
+ * @code{.cpp}
+ * Task<int> answer() {
+ *     co_return 42;
+ * }
+ *
+ * Task<void> print() {
+ *     std::cout << co_await answer();
+ * }
+ * @endcode
+ */
+template <typename T = void> class [[nodiscard]] Task {
+  public:
+    using promise_type = detail::TaskPromise<T>;
+    using Handle = std::coroutine_handle<promise_type>;
+
+    /**
+     * @brief Creates task that owns coroutine
+     * @param handle Coroutine handle
+     */
+    explicit Task(Handle handle) noexcept : handle_(handle) {}
+
+    Task(Task&& other) noexcept : handle_(std::exchange(other.handle_, {})) {}
+
+    Task& operator=(Task&& other) noexcept {
+        if (this != &other) {
+            if (handle_)
+                handle_.destroy();
+            handle_ = std::exchange(other.handle_, {});
+        }
+        return *this;
+    }
+
+    Task(const Task&) = delete;
+    Task& operator=(const Task&) = delete;
+
+    ~Task() {
+        if (handle_)
+            handle_.destroy();
+    }
+
+    /**
+     * @brief Awaiter that starts the task and resumes the caller when it is finished
+     */
+    struct Awaiter {
+        Handle handle;
+
+        bool await_ready() const noexcept {
+            return handle.done();
+        }
+
+        std::coroutine_handle<> await_suspend(std::coroutine_handle<> caller) noexcept {
+            handle.promise().set_continuation(caller);
+            return handle;
+        }
+
+        T await_resume() {
+            return handle.promise().result();
+        }
+    };
+
+    /**
+     * @brief Starts the task
+     * @return `Awaiter`
+     *
+     * @throws `std::logic_error` when:
+     * - task does not own a coroutine (it was moved from)
+     */
+    Awaiter operator co_await() && {
+        if (!handle_)
+            throw std::logic_error("Awaiting a task that does not own a coroutine");
+
+        return Awaiter{handle_};
+    }
+
+  private:
+    Handle handle_;
+};
+
+
+namespace detail {
+
+template <typename T> Task<T> TaskPromise<T>::get_return_object() noexcept {
+    return Task<T>(std::coroutine_handle<TaskPromise<T>>::from_promise(*this));
+}
+
+
+inline Task<void> TaskPromise<void>::get_return_object() noexcept {
+    return Task<void>(std::coroutine_handle<TaskPromise<void>>::from_promise(*this));
+}
+
+} // namespace detail
+
+} // namespace optoctreeparser
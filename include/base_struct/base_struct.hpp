@@ -22,6 +22,10 @@ struct OptocPatchRoot;  // Forward declaration
 struct OptocPatchBatch; // Forward declaration
 struct OptocPatchTree;  // Forward declaration
 
+struct OptocFlatPatchRoot;  // Forward declaration
+struct OptocFlatPatchBatch; // Forward declaration
+struct OptocFlatPatchTree;  // Forward declaration
+
 
 /**
  * @brief Root of `optoctreepatch` file
@@ -66,6 +70,49 @@ struct OptocPatchTree {
 };
 
 
+/**
+ * @brief Root of `optoctreepatch` file with all trees and nodes in two shared buffers
+ *
+ * Same data as `OptocPatchRoot`, but a patch of any size takes three allocations. Trees of batch
+ * `b` are `trees[b.first_tree, b.first_tree + b.octree_count)` and nodes of tree `t` are
+ * `nodes[t.first_node, t.first_node + t.node_count)`
+ */
+struct OptocFlatPatchRoot {
+    int32_t                          version; ///< version of optoctreepatch file
+    std::vector<OptocFlatPatchBatch> batches; ///< Patched batches
+    std::vector<OptocFlatPatchTree>  trees;   ///< Trees of all batches
+    std::vector<OptocNode>           nodes;   ///< Nodes of all trees
+
+    bool operator==(const OptocFlatPatchRoot& other) const = default;
+};
+
+
+/**
+ * @brief Patched batch of `OptocFlatPatchRoot`
+ */
+struct OptocFlatPatchBatch {
+    int16_t  x_position;   ///< X position of batch
+    int16_t  y_position;   ///< Y position of batch
+    int16_t  z_position;   ///< Z position of batch
+    byte     octree_count; ///< Count of octrees
+    uint32_t first_tree;   ///< Index of the first tree of batch in `OptocFlatPatchRoot::trees`
+
+    bool operator==(const OptocFlatPatchBatch& other) const = default;
+};
+
+
+/**
+ * @brief Patched tree of `OptocFlatPatchRoot`
+ */
+struct OptocFlatPatchTree {
+    byte     octree_number; ///< Number of octree
+    uint16_t node_count;    ///< Count of nodes
+    uint32_t first_node;    ///< Index of the first node of tree in `OptocFlatPatchRoot::nodes`
+
+    bool operator==(const OptocFlatPatchTree& other) const = default;
+};
+
+
 /**
  * @brief Root of `optoctree` file
  */
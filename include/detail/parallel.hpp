@@ -0,0 +1,85 @@
+/**
+ * @brief Small helpers to run work on several threads
+ *
+ * @copyright maksimshchavelev © 2025 maksimshchavelev@gmail.com
+ * @license MIT
+ */
+
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <exception>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace optoctreeparser::detail {
+
+/**
+ * @brief Resolves count of threads to use
+ * @param thread_count Requested count of threads. `0` means hardware concurrency
+ * @param count Count of work items
+ * @return Count of threads in range `[1, count]` (or 1 if `count` is 0)
+ */
+inline std::size_t resolve_thread_count(std::size_t thread_count, std::size_t count) {
+    if (thread_count == 0) {
+        thread_count = std::max<std::size_t>(1, std::thread::hardware_concurrency());
+    }
+
+    return std::max<std::size_t>(1, std::min(thread_count, count));
+}
+
+
+/**
+ * @brief Calls `function(index)` for every index in `[0, count)` on up to `thread_count` threads
+ * @param count Count of work items
+ * @param thread_count Count of threads. `0` means hardware concurrency
+ * @param function Function to call. Must be safe to call concurrently for different indices
+ *
+ * @note The first exception thrown by `function` is rethrown after all threads have finished
+ */
+template <typename Function>
+void parallel_for(std::size_t count, std::size_t thread_count, Function&& function) {
+    thread_count = resolve_thread_count(thread_count, count);
+
+    if (thread_count == 1) {
+        for (std::size_t index = 0; index < count; ++index) {
+            function(index);
+        }
+        return;
+    }
+
+    std::atomic<std::size_t> next{0};
+    std::exception_ptr       error;
+    std::mutex               error_mutex;
+
+    auto worker = [&]() {
+        for (std::size_t index = next.fetch_add(1); index < count; index = next.fetch_add(1)) {
+            try {
+                function(index);
+            } catch (...) {
+                std::scoped_lock lock(error_mutex);
+                if (!error)
+                    error = std::current_exception();
+            }
+        }
+    };
+
+    {
+        std::vector<std::jthread> threads;
+        threads.reserve(thread_count - 1);
+
+        for (std::size_t thread = 1; thread < thread_count; ++thread) {
+            threads.emplace_back(worker);
+        }
+
+        worker();
+    } // Threads are joined here
+
+    if (error)
+        std::rethrow_exception(error);
+}
+
+} // namespace optoctreeparser::detail
@@ -8,6 +8,10 @@
 #pragma once
 
 #include "base_struct/base_struct.hpp"
+#include "hasher/hasher.hpp"
+#include "manifest/manifest.hpp"
+#include "snapshot/snapshot.hpp"
+#include <span>
 
 namespace optoctreeparser {
 
@@ -31,6 +35,99 @@ class Differ {
     static std::vector<OptocPatchTree> find_difference(const OptocRoot& old_root,
                                                        const OptocRoot& new_root);
 
+    /**
+     * @brief Finds the difference between old batch known only by its hashes and `new_root`
+     * @param old_hashes Hashes of the old "base" batch (see `Hasher::hash_root`)
+     * @param new_root New batch
+     * @param new_hashes Hashes of `new_root`
+     * @return Same as `find_difference(const OptocRoot&, const OptocRoot&)`
+     *
+     * @note Trees are compared by their hashes only, so every comparison is O(1) and the old
+     * batch does not have to be kept in memory. If `root_hash` of both batches are equal, the
+     * result is empty without looking at trees at all. Hashes are 64-bit, so the probability of
+     * treating a changed tree as unchanged is negligible, but not zero
+     *
+     * @throws `std::invalid_argument` when:
+     * - count of tree hashes in `new_hashes` differs from count of trees in `new_root`
+     */
+    static std::vector<OptocPatchTree> find_difference(const OptocRootHashes& old_hashes,
+                                                       const OptocRoot&       new_root,
+                                                       const OptocRootHashes& new_hashes);
+
+    /**
+     * @brief Finds the difference between old batch known only by its hashes and `new_root`
+     * @param old_hashes Hashes of the old "base" batch (see `Hasher::hash_root`)
+     * @param new_root New batch. Its hashes are computed by this method
+     * @return Same as `find_difference(const OptocRoot&, const OptocRoot&)`
+     */
+    static std::vector<OptocPatchTree> find_difference(const OptocRootHashes& old_hashes,
+                                                       const OptocRoot&       new_root);
+
+    /**
+     * @brief Finds the difference between a batch of baseline manifest and a new batch
+     * @param old_batch Batch of baseline `OptocManifest`
+     * @param new_batch Byte representation of new batch
+     * @return Same as `find_difference(const OptocRoot&, const OptocRoot&)`
+     *
+     * @note The baseline batch is never read. If bytes of `new_batch` have the same hash as the
+     * baseline file, `new_batch` is not even parsed
+     */
+    static std::vector<OptocPatchTree> find_difference(const OptocManifestBatch& old_batch,
+                                                       const OptocTreeView&      new_batch);
+
+    /**
+     * @brief Finds the difference between two `OptocRoot` looking only at some trees
+     * @param old_root The old "base" batch
+     * @param new_root New batch
+     * @param candidate_trees Indices of trees that may differ (e.g. returned by `Editor::apply`).
+     * Other trees are treated as equal and are not compared
+     * @return Same as `find_difference(const OptocRoot&, const OptocRoot&)`
+     */
+    static std::vector<OptocPatchTree>
+    find_difference(const OptocRoot&             old_root,
+                    const OptocRoot&             new_root,
+                    std::span<const std::size_t> candidate_trees);
+
+    /**
+     * @brief Finds the difference between two snapshots
+     * @param old_snapshot The old "base" batch
+     * @param new_snapshot New batch
+     * @return Same as `find_difference(const OptocRoot&, const OptocRoot&)`
+     *
+     * @note Trees shared by both snapshots are equal without comparing their nodes
+     */
+    static std::vector<OptocPatchTree> find_difference(const Snapshot& old_snapshot,
+                                                       const Snapshot& new_snapshot);
+
+    /**
+     * @brief Finds the difference between two encoded batches and appends it to encoded patch.
+     * Trees are compared as byte ranges and copied to the patch as they are, nodes are never
+     * decoded
+     * @param old_batch Byte representation of the old "base" batch
+     * @param new_batch Byte representation of new batch
+     * @param x_position X position of batch in patch
+     * @param y_position Y position of batch in patch
+     * @param z_position Z position of batch in patch
+     * @param patch Byte representation of `.optoctreepatch` to append batch with changed trees
+     * to. Must contain at least the version
+     * @return Count of changed trees. Nothing is appended if there are none
+     *
+     * @throws `std::out_of_range` when:
+     * - `old_batch` or `new_batch` ends before all declared trees and nodes are read
+     *
+     * @code{.cpp}
+     * OptocTreeView patch = Parser::pack_optoctreepatch({.version = 1, .batches = {}});
+     * Differ::append_difference(vanilla_view, modified_view, 12, 18, 10, patch);
+     * Writer::optoctreeview_to_file("mod.optoctreepatch", patch);
+     * @endcode
+     */
+    static std::size_t append_difference(const OptocTreeView& old_batch,
+                                         const OptocTreeView& new_batch,
+                                         int16_t              x_position,
+                                         int16_t              y_position,
+                                         int16_t              z_position,
+                                         OptocTreeView&       patch);
+
   private:
     /**
      * @brief Compares two trees
@@ -0,0 +1,150 @@
+/**
+ * @brief Recomputation of signed distances from materials
+ *
+ * @copyright maksimshchavelev © 2025 maksimshchavelev@gmail.com
+ * @license MIT
+ */
+
+#pragma once
+
+#include "grid/grid.hpp"
+#include "world_index/world_index.hpp"
+#include <span>
+#include <vector>
+
+namespace optoctreeparser {
+
+/**
+ * @brief Rebuilds signed distances so that they agree with the surface given by materials
+ *
+ * Voxels with material other than 0 are solid. The surface lies between solid and empty voxels,
+ * so a voxel next to it is half a voxel away. Distances are exact Euclidean distances between voxel
+ * centers (separable distance transform), then encoded with `SignedDistance::encode`: empty voxels
+ * get 1–125, solid ones 127–252.
+ *
+ * @section example_usage Example usage
+ *
+ * @code{.cpp}
+ * Editor::apply(batch, operations);
+ * DistanceField::recompute(batch, world, {12, 18, 10}); // no offline fixup, no seams
+ * @endcode
+ */
+class DistanceField {
+  public:
+    static constexpr std::size_t border = Octree::tree_size; ///< Voxels of neighbours around batch
+
+    /**
+     * @brief Recomputes signed distances of grid in parallel
+     * @param grid Grid. Only `signed_distance` is written
+     * @param thread_count Count of threads. 0 means hardware concurrency
+     *
+     * @throws `std::invalid_argument` when:
+     * - sizes of `material_type` or `signed_distance` are not `grid.size³`
+     */
+    static void recompute(OptocGrid& grid, std::size_t thread_count = 0);
+
+    /**
+     * @brief Recomputes signed distances of batch in parallel. Shape of trees and materials are
+     * kept, only `signed_distance` of nodes is written: a leaf gets the distance at its center,
+     * an inner node the average of its children
+     * @param batch `OptocRoot`
+     * @param thread_count Count of threads. 0 means hardware concurrency
+     *
+     * @note Distances are computed on the full-resolution grid of the batch, then sampled once
+     * per node, so the size of batch does not change
+     *
+     * @note Only materials of `batch` are seen. Near its faces, surfaces of neighbouring batches
+     * are ignored, so recomputed neighbours do not agree at their common face. Use the
+     * `WorldIndex` overload for batches of a world
+     */
+    static void recompute(OptocRoot& batch, std::size_t thread_count = 0);
+
+    /**
+     * @brief Recomputes signed distances of batch of world in parallel, like
+     * `recompute(OptocRoot&, std::size_t)`, but also sees surfaces of neighbouring batches
+     * @param batch `OptocRoot`. Used instead of the batch stored in `world` at `coordinate`
+     * @param world Batches of world
+     * @param coordinate Coordinate of `batch`
+     * @param thread_count Count of threads. 0 means hardware concurrency
+     *
+     * @note The grid of batch is padded with `border` voxels of its neighbours on every side, so
+     * distances up to `border` voxels are exact across faces of batches. Recomputing neighbouring
+     * batches this way gives distances that agree at their common face
+     */
+    static void recompute(OptocRoot&                  batch,
+                          const WorldIndex&           world,
+                          const OptocBatchCoordinate& coordinate,
+                          std::size_t                 thread_count = 0);
+
+  private:
+    /**
+     * @brief Squared distance of voxels without feature. Larger than any distance that encoding
+     * can represent, so no real distance is ever lost to it
+     */
+    static constexpr float far = 256.0f * 256.0f;
+
+    /**
+     * @brief Computes signed distance of every voxel of grid in parallel
+     * @param grid Grid. Only `material_type` is read
+     * @param thread_count Count of threads. 0 means hardware concurrency
+     * @return Decoded signed distances, in the same order as voxels
+     */
+    static std::vector<float> signed_distances(const OptocGrid& grid, std::size_t thread_count);
+
+    /**
+     * @brief Copies materials of leaves of node into grid. Voxels outside of grid are skipped
+     * @param tree `OptocTree`
+     * @param node Index of node
+     * @param origin Position of the first voxel of node in `grid`, may be outside of it
+     * @param size Count of voxels along edge of node
+     * @param grid Grid of empty voxels, only `material_type` is written
+     */
+    static void rasterize(const OptocTree&  tree,
+                          std::size_t       node,
+                          const OptocVoxel& origin,
+                          std::size_t       size,
+                          OptocGrid&        grid);
+
+    /**
+     * @brief Writes distances of node and its children
+     * @param tree `OptocTree`
+     * @param node Index of node
+     * @param origin Position of the first voxel of node in `grid`
+     * @param size Count of voxels along edge of node
+     * @param grid Grid of batch
+     * @param distances Result of `signed_distances` for `grid`
+     * @return Decoded distance written to node, before rounding
+     */
+    static float assign(OptocTree&             tree,
+                        std::size_t            node,
+                        const OptocVoxel&      origin,
+                        std::size_t            size,
+                        const OptocGrid&       grid,
+                        std::span<const float> distances);
+
+    /**
+     * @brief Transforms squared distances of grid along one axis in parallel
+     * @param size Count of voxels along edge
+     * @param values Squared distances, transformed in place
+     * @param axis Axis: 0 - X, 1 - Y, 2 - Z
+     * @param thread_count Count of threads. 0 means hardware concurrency
+     */
+    static void transform_axis(std::size_t      size,
+                               std::span<float> values,
+                               std::size_t      axis,
+                               std::size_t      thread_count);
+
+    /**
+     * @brief 1D squared distance transform (lower envelope of parabolas)
+     * @param line Squared distances, transformed in place
+     * @param vertices Scratch buffer of `line.size()` elements
+     * @param bounds Scratch buffer of `line.size() + 1` elements
+     * @param result Scratch buffer of `line.size()` elements
+     */
+    static void transform_line(std::span<float>       line,
+                               std::span<std::size_t> vertices,
+                               std::span<float>       bounds,
+                               std::span<float>       result);
+};
+
+} // namespace optoctreeparser
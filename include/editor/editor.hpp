@@ -0,0 +1,139 @@
+/**
+ * @brief Bulk editing of batches with shapes and brushes
+ *
+ * @copyright maksimshchavelev © 2025 maksimshchavelev@gmail.com
+ * @license MIT
+ */
+
+#pragma once
+
+#include "base_struct/base_struct.hpp"
+#include "octree/octree.hpp"
+#include <functional>
+#include <span>
+
+namespace optoctreeparser {
+
+/**
+ * @brief What an edit operation writes into voxels inside its shape
+ */
+enum class EditMode {
+    add,    ///< Sets material and unites signed distance with the shape
+    remove, ///< Sets material 0 and subtracts the shape from signed distance
+    paint   ///< Sets material of non-empty voxels, signed distance is kept
+};
+
+
+/**
+ * @brief One edit operation. Coordinates are voxels from the batch origin
+ */
+struct EditOperation {
+    EditMode   mode;          ///< What to write
+    byte       material_type; ///< Material to write (ignored by `EditMode::remove`)
+    OptocPoint min;           ///< Minimum corner of region affected by the operation
+    OptocPoint max;           ///< Maximum corner of region affected by the operation
+    std::function<float(const OptocPoint&)> distance; ///< Signed distance to the shape, in voxels.
+                                                      ///< Negative inside of the shape
+};
+
+
+/**
+ * @brief Applies lists of edit operations to batches
+ *
+ * Every tree touched by at least one operation is decoded into a dense grid once, all operations
+ * are applied to the grid, and the tree is rebuilt once. Uniform regions are collapsed while
+ * rebuilding.
+ *
+ * @section example_usage Example usage
+ *
+ * @code{.cpp}
+ * std::vector<EditOperation> strokes = {
+ *     Editor::sphere(EditMode::add, 37, {40.0f, 60.0f, 40.0f}, 6.0f),
+ *     Editor::box(EditMode::remove, 0, {10.0f, 10.0f, 10.0f}, {20.0f, 20.0f, 20.0f}),
+ * };
+ *
+ * std::vector<std::size_t> changed = Editor::apply(batch, strokes);
+ * auto patch = Differ::find_difference(vanilla, batch, changed);
+ * @endcode
+ */
+class Editor {
+  public:
+    /// Voxels around shape bounds whose signed distance is updated too
+    static constexpr float distance_margin = 2.0f;
+
+    /**
+     * @brief Makes sphere operation
+     * @param mode `EditMode`
+     * @param material_type Material to write
+     * @param center Center of sphere
+     * @param radius Radius of sphere
+     * @return `EditOperation`
+     */
+    static EditOperation sphere(EditMode          mode,
+                                byte              material_type,
+                                const OptocPoint& center,
+                                float             radius);
+
+    /**
+     * @brief Makes axis-aligned box operation
+     * @param mode `EditMode`
+     * @param material_type Material to write
+     * @param min Minimum corner of box
+     * @param max Maximum corner of box
+     * @return `EditOperation`
+     */
+    static EditOperation box(EditMode          mode,
+                             byte              material_type,
+                             const OptocPoint& min,
+                             const OptocPoint& max);
+
+    /**
+     * @brief Makes operation with custom signed distance function
+     * @param mode `EditMode`
+     * @param material_type Material to write
+     * @param min Minimum corner of brush bounds
+     * @param max Maximum corner of brush bounds
+     * @param distance Signed distance to the brush, negative inside
+     * @return `EditOperation`. Bounds are extended by `distance_margin`
+     */
+    static EditOperation brush(EditMode                                mode,
+                               byte                                    material_type,
+                               const OptocPoint&                       min,
+                               const OptocPoint&                       max,
+                               std::function<float(const OptocPoint&)> distance);
+
+    /**
+     * @brief Applies operations to batch. Operations are applied in order
+     * @param batch Batch to edit
+     * @param operations Operations
+     * @param thread_count Count of threads used for independent trees. 0 means hardware concurrency
+     * @return Ascending indices of trees that have changed
+     */
+    static std::vector<std::size_t> apply(OptocRoot&                     batch,
+                                          std::span<const EditOperation> operations,
+                                          std::size_t                    thread_count = 0);
+
+  private:
+    /**
+     * @brief Checks whether operation bounds overlap tree
+     * @param operation `EditOperation`
+     * @param tree Index of tree
+     * @return `true` if they overlap
+     */
+    static bool overlaps(const EditOperation& operation, std::size_t tree);
+
+    /**
+     * @brief Applies operations to one tree
+     * @param tree Tree to edit
+     * @param tree_index Index of tree in batch
+     * @param operations All operations
+     * @param affecting Indices of operations that overlap the tree
+     * @return `true` if the tree has changed
+     */
+    static bool apply_to_tree(OptocTree&                     tree,
+                              std::size_t                    tree_index,
+                              std::span<const EditOperation> operations,
+                              std::span<const std::size_t>   affecting);
+};
+
+} // namespace optoctreeparser
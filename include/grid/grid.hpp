@@ -0,0 +1,162 @@
+/**
+ * @brief Dense voxel grid and conversion of octrees to it and back
+ *
+ * @copyright maksimshchavelev © 2025 maksimshchavelev@gmail.com
+ * @license MIT
+ */
+
+#pragma once
+
+#include "base_struct/base_struct.hpp"
+#include "octree/octree.hpp"
+
+namespace optoctreeparser {
+
+/**
+ * @brief Dense cube of voxels. Voxel `{x, y, z}` is stored at `x + size * (y + size * z)`
+ */
+struct OptocGrid {
+    std::size_t       size;            ///< Count of voxels along edge
+    std::vector<byte> material_type;   ///< Material of every voxel
+    std::vector<byte> signed_distance; ///< Encoded signed distance of every voxel
+
+    bool operator==(const OptocGrid& other) const = default;
+};
+
+
+/**
+ * @brief Converts `OptocTree` and `OptocRoot` to dense `OptocGrid` and back
+ *
+ * A grid can have lower resolution than the tree. Then one voxel of the grid is a cube of
+ * `Octree::tree_size / resolution` voxels of the tree and gets the values of the node at that
+ * level (inner nodes store the aggregate of their children).
+ *
+ * @code{.cpp}
+ * OptocGrid grid = Grid::from_batch(batch);  // 160³ voxels
+ * erode(grid);
+ * batch = Grid::to_batch(grid, batch.version);
+ * @endcode
+ */
+class Grid {
+  public:
+    /**
+     * @brief Decodes tree into grid of `Octree::tree_size` voxels
+     * @param tree `OptocTree`
+     * @return `OptocGrid`. Tree without nodes gives grid of empty voxels
+     *
+     * @note Nodes deeper than `Octree::max_depth` are not visited, their voxel gets the values of
+     * the node at `Octree::max_depth`
+     */
+    static OptocGrid from_tree(const OptocTree& tree);
+
+    /**
+     * @brief Decodes tree into grid of chosen resolution
+     * @param tree `OptocTree`
+     * @param resolution Count of voxels along edge of grid
+     * @return `OptocGrid`. Tree without nodes gives grid of empty voxels
+     *
+     * @throws `std::invalid_argument` when:
+     * - `resolution` is not a power of two or is greater than `Octree::tree_size`
+     */
+    static OptocGrid from_tree(const OptocTree& tree, std::size_t resolution);
+
+    /**
+     * @brief Decodes batch into one grid. Trees are decoded in parallel
+     * @param batch `OptocRoot`
+     * @param resolution Count of voxels along edge of one tree in grid
+     * @param thread_count Count of threads. `0` means hardware concurrency
+     * @return `OptocGrid` of `Octree::trees_per_side * resolution` voxels. Missing trees and trees
+     * without nodes give empty voxels
+     *
+     * @throws `std::invalid_argument` when:
+     * - `resolution` is not a power of two or is greater than `Octree::tree_size`
+     */
+    static OptocGrid from_batch(const OptocRoot& batch,
+                                std::size_t      resolution = Octree::tree_size,
+                                std::size_t      thread_count = 0);
+
+    /**
+     * @brief Builds tree from grid. Uniform regions are collapsed into one leaf
+     * @param grid `OptocGrid`. Size must be a power of two
+     * @return `OptocTree`. Inner nodes get majority material and average distance of children
+     */
+    static OptocTree to_tree(const OptocGrid& grid);
+
+    /**
+     * @brief Builds batch from grid. Trees are built in parallel, uniform regions are collapsed
+     * @param grid `OptocGrid`. Size must be `Octree::trees_per_side` times a power of two
+     * @param version Version of batch
+     * @param thread_count Count of threads. `0` means hardware concurrency
+     * @return `OptocRoot` with `Octree::trees_per_batch` trees
+     *
+     * @throws `std::invalid_argument` when:
+     * - size of `grid` is not `Octree::trees_per_side` times a power of two
+     */
+    static OptocRoot to_batch(const OptocGrid& grid, int32_t version, std::size_t thread_count = 0);
+
+    /**
+     * @brief Index of voxel in grid
+     * @param grid `OptocGrid`
+     * @param x X coordinate
+     * @param y Y coordinate
+     * @param z Z coordinate
+     * @return Index in `material_type` and `signed_distance`
+     */
+    static std::size_t index(const OptocGrid& grid, std::size_t x, std::size_t y, std::size_t z);
+
+  private:
+    /**
+     * @brief Creates grid of empty voxels
+     * @param size Count of voxels along edge
+     * @return `OptocGrid`
+     */
+    static OptocGrid make_grid(std::size_t size);
+
+    /**
+     * @brief Checks resolution of tree in grid
+     * @param resolution Count of voxels along edge of tree
+     *
+     * @throws `std::invalid_argument` when:
+     * - `resolution` is not a power of two or is greater than `Octree::tree_size`
+     */
+    static void validate_resolution(std::size_t resolution);
+
+    /**
+     * @brief Builds tree from cube of grid
+     * @param grid `OptocGrid`
+     * @param origin First voxel of cube
+     * @param size Size of cube, power of two
+     * @return `OptocTree`
+     */
+    static OptocTree build_tree(const OptocGrid& grid, const OptocVoxel& origin, std::size_t size);
+
+    /**
+     * @brief Fills cube of grid with node and its children
+     * @param tree `OptocTree`
+     * @param node Index of node
+     * @param origin First voxel of cube
+     * @param size Size of cube
+     * @param grid Grid to fill
+     */
+    static void fill(const OptocTree&  tree,
+                     std::size_t       node,
+                     const OptocVoxel& origin,
+                     std::size_t       size,
+                     OptocGrid&        grid);
+
+    /**
+     * @brief Builds node of tree from cube of grid. Children are built first and collapsed into
+     * one leaf if they are equal leaves, so every voxel is read once
+     * @param grid `OptocGrid`
+     * @param origin First voxel of cube
+     * @param size Size of cube
+     * @param tree Tree to append children to
+     * @return Node for the cube
+     */
+    static OptocNode build(const OptocGrid&  grid,
+                           const OptocVoxel& origin,
+                           std::size_t       size,
+                           OptocTree&        tree);
+};
+
+} // namespace optoctreeparser
@@ -0,0 +1,116 @@
+/**
+ * @brief Hasher to compute content hashes of optoctree data
+ *
+ * @copyright maksimshchavelev © 2025 maksimshchavelev@gmail.com
+ * @license MIT
+ */
+
+#pragma once
+
+#include "base_struct/base_struct.hpp"
+#include <span>
+
+namespace optoctreeparser {
+
+using OptocHash = uint64_t;
+
+
+/**
+ * @brief Content hashes of one `OptocRoot`
+ */
+struct OptocRootHashes {
+    OptocHash              root_hash;   ///< Hash of the whole batch (version + all tree hashes)
+    std::vector<OptocHash> tree_hashes; ///< Hash of every tree, in the same order as `trees`
+
+    bool operator==(const OptocRootHashes& other) const = default;
+};
+
+
+/**
+ * @brief Computes 64-bit content hashes (XXH64) of trees and batches
+ *
+ * The hash of a tree is the XXH64 of its encoded nodes (exactly the bytes stored in `.optoctree`)
+ * seeded with its `node_count`. Because of that the hash of a tree can be computed either from a
+ * parsed `OptocTree` or directly from the file bytes, and both give the same value.
+ *
+ * @code{.cpp}
+ * OptocRootHashes hashes{};
+ * OptocRoot batch = Parser::parse_optoctree_batch(view, hashes); // hashes computed while parsing
+ * bool same = hashes.tree_hashes[3] == Hasher::hash_tree(other.trees[3]);
+ * @endcode
+ */
+class Hasher {
+  public:
+    /**
+     * @brief Computes XXH64 of bytes
+     * @param bytes Bytes to hash
+     * @param seed Seed
+     * @return `OptocHash`
+     */
+    static OptocHash hash_bytes(std::span<const byte> bytes, uint64_t seed = 0);
+
+    /**
+     * @brief Computes hash of tree
+     * @param tree `OptocTree`
+     * @return `OptocHash`
+     */
+    static OptocHash hash_tree(const OptocTree& tree);
+
+    /**
+     * @brief Computes hash of encoded tree
+     * @param node_count Count of nodes
+     * @param encoded_nodes Bytes of nodes as they are stored in `.optoctree` (4 bytes per node)
+     * @return `OptocHash` equal to `hash_tree` of the decoded tree
+     */
+    static OptocHash hash_encoded_tree(uint16_t node_count, std::span<const byte> encoded_nodes);
+
+    /**
+     * @brief Computes hashes of batch and of all its trees
+     * @param root `OptocRoot`
+     * @return `OptocRootHashes`
+     */
+    static OptocRootHashes hash_root(const OptocRoot& root);
+
+    /**
+     * @brief Computes hash of batch from hashes of its trees
+     * @param version Version of batch
+     * @param tree_hashes Hashes of trees
+     * @return `OptocHash`
+     */
+    static OptocHash hash_root(int32_t version, std::span<const OptocHash> tree_hashes);
+
+  private:
+    /**
+     * @brief Reads uint64_t in **little endian** from the buffer at the specified offset
+     * @param buffer Buffer with data
+     * @param offset Offset
+     * @return `uint64_t`
+     */
+    static uint64_t read_u64_le(std::span<const byte> buffer, size_t offset);
+
+    /**
+     * @brief Reads uint32_t in **little endian** from the buffer at the specified offset
+     * @param buffer Buffer with data
+     * @param offset Offset
+     * @return `uint32_t`
+     */
+    static uint32_t read_u32_le(std::span<const byte> buffer, size_t offset);
+
+    /**
+     * @brief One XXH64 accumulation round
+     * @param accumulator Lane accumulator
+     * @param input 8 bytes of input
+     * @return New accumulator
+     */
+    static uint64_t round(uint64_t accumulator, uint64_t input);
+
+    /**
+     * @brief Merges lane accumulator into the hash
+     * @param hash Hash
+     * @param accumulator Lane accumulator
+     * @return New hash
+     */
+    static uint64_t merge_round(uint64_t hash, uint64_t accumulator);
+};
+
+} // namespace optoctreeparser
@@ -0,0 +1,171 @@
+/**
+ * @brief Codec of batches with nodes of a layout
+ *
+ * @copyright maksimshchavelev © 2025 maksimshchavelev@gmail.com
+ * @license MIT
+ */
+
+#pragma once
+
+#include "base_struct/base_struct.hpp"
+#include "layout/node_layout.hpp"
+#include "parser/codec.hpp"
+#include <span>
+#include <vector>
+
+namespace optoctreeparser {
+
+/**
+ * @brief Parser, packer and differ of batches with nodes of `Layout`
+ *
+ * Parsing and packing are `Codec::read_batch` and `Codec::write_batch` instantiated with `Layout`,
+ * so `decode` and `encode` are inlined into the same node loops `Parser` runs. Results are the same
+ * as of `Parser` and `Differ` for the encoded part of nodes.
+ *
+ * @section example_usage Example usage
+ *
+ * @code{.cpp}
+ * struct FlaggedNode {
+ *     OptocNode node;
+ *     bool      dirty;
+ * };
+ *
+ * struct FlaggedLayout {
+ *     using node_type = FlaggedNode;
+ *     static constexpr FlaggedNode decode(const OptocNode& encoded) { return {encoded, false}; }
+ *     static constexpr OptocNode encode(const FlaggedNode& node) { return node.node; }
+ * };
+ *
+ * auto batch = LayoutCodec<FlaggedLayout>::parse_batch(view);
+ * batch.trees[3].nodes[0].dirty = true;
+ * OptocTreeView packed = LayoutCodec<FlaggedLayout>::pack_batch(batch); // same bytes as `view`
+ * @endcode
+ */
+template <NodeLayout Layout> class LayoutCodec {
+  public:
+    using node_type = typename Layout::node_type;
+    using tree_type = typename LayoutTypes<Layout>::tree_type;
+    using root_type = typename LayoutTypes<Layout>::root_type;
+
+    /**
+     * @brief Parses optoctree from its binary representation
+     * @param optoctree Byte representation of optoctree
+     * @return Parsed batch
+     *
+     * @throws `std::out_of_range` when:
+     * - optoctree ends before all declared trees and nodes are read
+     */
+    static constexpr root_type parse_batch(std::span<const byte> optoctree) {
+        return Codec::read_batch<Layout>(optoctree);
+    }
+
+    /**
+     * @brief Packs batch into binary representation
+     * @param batch Batch
+     * @return `OptocTreeView` with binary representation
+     */
+    static constexpr OptocTreeView pack_batch(const root_type& batch) {
+        return Codec::write_batch<Layout>(batch);
+    }
+
+    /**
+     * @brief Finds trees whose encoded nodes differ, like `Differ::find_difference`
+     * @param old_root Old batch
+     * @param new_root New batch
+     * @return Changed and added trees of `new_root`
+     */
+    static std::vector<OptocPatchTree> find_difference(const root_type& old_root,
+                                                       const root_type& new_root) {
+        std::vector<OptocPatchTree> patches;
+
+        // Removed trees are skipped like in `Differ`
+        for (std::size_t tree = 0; tree < new_root.trees.size(); ++tree) {
+            if (tree < old_root.trees.size() &&
+                trees_equal(old_root.trees[tree], new_root.trees[tree])) {
+                continue;
+            }
+
+            patches.push_back({.octree_number = static_cast<byte>(tree),
+                               .node_count = new_root.trees[tree].node_count,
+                               .nodes = encode_nodes(new_root.trees[tree])});
+        }
+
+        return patches;
+    }
+
+    /**
+     * @brief Converts `OptocRoot` to batch of `Layout`
+     * @param root `OptocRoot`
+     * @return Batch with decoded nodes
+     */
+    static root_type from_root(const OptocRoot& root) {
+        root_type batch{.version = root.version, .trees = {}};
+        batch.trees.reserve(root.trees.size());
+
+        for (const auto& tree : root.trees) {
+            tree_type converted{.node_count = tree.node_count, .nodes = {}};
+            converted.nodes.reserve(tree.nodes.size());
+
+            for (const auto& node : tree.nodes) {
+                converted.nodes.push_back(Layout::decode(node));
+            }
+
+            batch.trees.push_back(std::move(converted));
+        }
+
+        return batch;
+    }
+
+    /**
+     * @brief Converts batch of `Layout` to `OptocRoot`. In-memory data of nodes is dropped
+     * @param batch Batch
+     * @return `OptocRoot` with encoded nodes
+     */
+    static OptocRoot to_root(const root_type& batch) {
+        OptocRoot root{.version = batch.version, .trees = {}};
+        root.trees.reserve(batch.trees.size());
+
+        for (const auto& tree : batch.trees) {
+            root.trees.push_back({.node_count = tree.node_count, .nodes = encode_nodes(tree)});
+        }
+
+        return root;
+    }
+
+  private:
+    /**
+     * @brief Compares encoded nodes of trees
+     * @param a Tree
+     * @param b Tree
+     * @return `true` if node counts and encoded nodes are equal
+     */
+    static bool trees_equal(const tree_type& a, const tree_type& b) {
+        if (a.node_count != b.node_count || a.nodes.size() != b.nodes.size())
+            return false;
+
+        for (std::size_t i = 0; i < a.nodes.size(); ++i) {
+            if (Layout::encode(a.nodes[i]) != Layout::encode(b.nodes[i]))
+                return false;
+        }
+
+        return true;
+    }
+
+    /**
+     * @brief Encodes nodes of tree
+     * @param tree Tree
+     * @return Encoded nodes
+     */
+    static std::vector<OptocNode> encode_nodes(const tree_type& tree) {
+        std::vector<OptocNode> nodes;
+        nodes.reserve(tree.nodes.size());
+
+        for (const auto& node : tree.nodes) {
+            nodes.push_back(Layout::encode(node));
+        }
+
+        return nodes;
+    }
+};
+
+} // namespace optoctreeparser
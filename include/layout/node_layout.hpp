@@ -0,0 +1,86 @@
+/**
+ * @brief Node layouts: descriptors of in-memory nodes and the trees and batches that store them
+ *
+ * @copyright maksimshchavelev © 2025 maksimshchavelev@gmail.com
+ * @license MIT
+ */
+
+#pragma once
+
+#include "base_struct/base_struct.hpp"
+#include <concepts>
+#include <vector>
+
+namespace optoctreeparser {
+
+/**
+ * @brief Compile-time descriptor of in-memory node
+ *
+ * `node_type` is what trees store. `decode` builds it from the 4 encoded bytes of node (given as
+ * `OptocNode`) and `encode` gives those bytes back. Whatever else `node_type` holds lives only in
+ * memory: it is not written to files and does not take part in diffs.
+ */
+template <class Layout>
+concept NodeLayout = requires(const typename Layout::node_type& node, const OptocNode& encoded) {
+    { Layout::decode(encoded) } -> std::same_as<typename Layout::node_type>;
+    { Layout::encode(node) } -> std::same_as<OptocNode>;
+};
+
+
+/**
+ * @brief Layout of plain `OptocNode`
+ */
+struct DefaultLayout {
+    using node_type = OptocNode;
+
+    static constexpr OptocNode decode(const OptocNode& encoded) {
+        return encoded;
+    }
+
+    static constexpr OptocNode encode(const OptocNode& node) {
+        return node;
+    }
+};
+
+
+/**
+ * @brief `OptocTree` with nodes of `Layout`
+ */
+template <NodeLayout Layout> struct BasicOptocTree {
+    uint16_t                                node_count; ///< Count of nodes
+    std::vector<typename Layout::node_type> nodes;      ///< Nodes
+
+    bool operator==(const BasicOptocTree& other) const = default;
+};
+
+
+/**
+ * @brief `OptocRoot` with nodes of `Layout`
+ */
+template <NodeLayout Layout> struct BasicOptocRoot {
+    int32_t                             version; ///< version of optoctree file
+    std::vector<BasicOptocTree<Layout>> trees;   ///< Optoctrees
+
+    bool operator==(const BasicOptocRoot& other) const = default;
+};
+
+
+/**
+ * @brief Tree and batch types of `Layout`. `DefaultLayout` uses `OptocTree` and `OptocRoot`, so
+ * code instantiated with it works on the plain structures of the rest of the library
+ */
+template <NodeLayout Layout> struct LayoutTypes {
+    using tree_type = BasicOptocTree<Layout>; ///< Tree
+    using root_type = BasicOptocRoot<Layout>; ///< Batch
+};
+
+
+/**
+ * @brief Tree and batch types of `DefaultLayout`
+ */
+template <> struct LayoutTypes<DefaultLayout> {
+    using tree_type = OptocTree; ///< Tree
+    using root_type = OptocRoot; ///< Batch
+};
+
+} // namespace optoctreeparser
@@ -0,0 +1,116 @@
+/**
+ * @brief Level-of-detail downsampling of octrees
+ *
+ * @copyright maksimshchavelev © 2025 maksimshchavelev@gmail.com
+ * @license MIT
+ */
+
+#pragma once
+
+#include "base_struct/base_struct.hpp"
+#include <span>
+
+namespace optoctreeparser {
+
+/**
+ * @brief How signed distance of collapsed subtree is computed
+ */
+enum class DistanceAggregation {
+    min,    ///< Minimum distance of leaves (the most solid one). Keeps thin walls solid
+    average ///< Volume-weighted average distance of leaves
+};
+
+
+/**
+ * @brief Builds coarse versions of trees by truncating them at a chosen depth
+ *
+ * Every inner node at the chosen depth becomes a leaf. Its material is the material that fills
+ * the largest volume of the subtree, its signed distance is aggregated from the leaves of the
+ * subtree as set by `DistanceAggregation`.
+ *
+ * @section example_usage Example usage
+ *
+ * @code{.cpp}
+ * // Overview of a region: keep only 3 levels below the root
+ * std::vector<OptocTreeView> coarse =
+ *     Lod::pack_truncated_batches(batches, 3, DistanceAggregation::min);
+ * @endcode
+ */
+class Lod {
+  public:
+    /**
+     * @brief Truncates tree at the specified depth
+     * @param tree `OptocTree`
+     * @param depth Count of levels to keep below the root. 0 keeps only the root
+     * @param aggregation How to aggregate signed distance
+     * @return Truncated `OptocTree`. Children are stored in breadth-first order
+     */
+    static OptocTree truncate_tree(const OptocTree&    tree,
+                                   std::size_t         depth,
+                                   DistanceAggregation aggregation);
+
+    /**
+     * @brief Truncates every tree of batch at the specified depth
+     * @param batch `OptocRoot`
+     * @param depth Count of levels to keep below the root
+     * @param aggregation How to aggregate signed distance
+     * @return Truncated `OptocRoot`
+     */
+    static OptocRoot truncate_batch(const OptocRoot&    batch,
+                                    std::size_t         depth,
+                                    DistanceAggregation aggregation);
+
+    /**
+     * @brief Truncates batches in parallel
+     * @param batches Batches
+     * @param depth Count of levels to keep below the root
+     * @param aggregation How to aggregate signed distance
+     * @param thread_count Count of threads. 0 means hardware concurrency
+     * @return Truncated batches in the same order
+     */
+    static std::vector<OptocRoot> truncate_batches(std::span<const OptocRoot> batches,
+                                                   std::size_t                depth,
+                                                   DistanceAggregation        aggregation,
+                                                   std::size_t                thread_count = 0);
+
+    /**
+     * @brief Truncates batches in parallel and packs them with `Parser::pack_optoctree_batch`
+     * @param batches Batches
+     * @param depth Count of levels to keep below the root
+     * @param aggregation How to aggregate signed distance
+     * @param thread_count Count of threads. 0 means hardware concurrency
+     * @return `.optoctree` bytes of truncated batches in the same order
+     */
+    static std::vector<OptocTreeView> pack_truncated_batches(std::span<const OptocRoot> batches,
+                                                             std::size_t                depth,
+                                                             DistanceAggregation aggregation,
+                                                             std::size_t         thread_count = 0);
+
+  private:
+    struct Aggregate; // Defined in lod.cpp
+
+    /**
+     * @brief Accumulates material volume and distance of leaves of subtree
+     * @param tree `OptocTree`
+     * @param node Index of subtree root
+     * @param volume Volume of subtree relative to the collapsed node
+     * @param aggregate Accumulator
+     */
+    static void accumulate(const OptocTree& tree,
+                           std::size_t      node,
+                           double           volume,
+                           Aggregate&       aggregate);
+
+    /**
+     * @brief Collapses subtree into one leaf
+     * @param tree `OptocTree`
+     * @param node Index of subtree root
+     * @param aggregation How to aggregate signed distance
+     * @return Leaf `OptocNode`
+     */
+    static OptocNode collapse(const OptocTree&    tree,
+                              std::size_t         node,
+                              DistanceAggregation aggregation);
+};
+
+} // namespace optoctreeparser
@@ -0,0 +1,177 @@
+/**
+ * @brief Manifest with content hashes of a world of optoctree files
+ *
+ * @copyright maksimshchavelev © 2025 maksimshchavelev@gmail.com
+ * @license MIT
+ */
+
+#pragma once
+
+#include "base_struct/base_struct.hpp"
+#include "hasher/hasher.hpp"
+#include <span>
+#include <string>
+#include <string_view>
+
+namespace optoctreeparser {
+
+/**
+ * @brief One batch file of `OptocManifest`
+ */
+struct OptocManifestBatch {
+    std::string     path;       ///< Path to `.optoctrees` file as it was passed to `Manifest`
+    uint64_t        file_size;  ///< Size of file in bytes
+    int64_t         file_mtime; ///< Last write time of file (`file_time_type` ticks)
+    OptocHash       file_hash;  ///< Hash of raw bytes of file
+    OptocRootHashes hashes;     ///< Hashes of parsed batch and its trees
+
+    bool operator==(const OptocManifestBatch& other) const = default;
+};
+
+
+/**
+ * @brief Manifest of a world. Stores hashes of batches instead of the batches themselves
+ */
+struct OptocManifest {
+    int32_t                         version; ///< Version of manifest format
+    std::vector<OptocManifestBatch> batches; ///< Batches
+
+    bool operator==(const OptocManifest& other) const = default;
+};
+
+
+/**
+ * @brief Builds, updates and (de)serializes `OptocManifest`
+ *
+ * @section example_usage Example usage
+ *
+ * @code{.cpp}
+ * // Once: hash the baseline world and save the manifest
+ * OptocManifest manifest = Manifest::make(vanilla_paths);
+ * Writer::optoctreeview_to_file("vanilla.optocmanifest", Manifest::pack_manifest(manifest));
+ *
+ * // Later: diff modified batches against the manifest without reading the vanilla world
+ * OptocManifest vanilla =
+ *     Manifest::parse_manifest(Reader::optoctreeview_from_file("vanilla.optocmanifest"));
+ * auto changed =
+ *     Differ::find_difference(vanilla.batches[i], Reader::optoctreeview_from_file(path));
+ * @endcode
+ *
+ * Binary format (all numbers are little endian):
+ * ```
+ * int32  version
+ * uint32 batch count
+ * per batch:
+ *   uint16 path length, path bytes
+ *   uint64 file size
+ *   int64  file mtime
+ *   uint64 file hash
+ *   uint64 root hash
+ *   uint16 tree count
+ *   uint64 tree hash (tree count times)
+ * ```
+ */
+class Manifest {
+  public:
+    static constexpr int32_t current_version = 1; ///< Version written by `pack_manifest`
+
+    /**
+     * @brief Reads, parses and hashes one batch file
+     * @param path Path to `.optoctrees`
+     * @return `OptocManifestBatch`
+     *
+     * @throws `std::system_error` when:
+     * - file opening error
+     */
+    static OptocManifestBatch make_batch(const std::string_view path);
+
+    /**
+     * @brief Builds manifest of batch files
+     * @param paths Paths to `.optoctrees`
+     * @return `OptocManifest`
+     *
+     * @throws `std::system_error` when:
+     * - file opening error
+     */
+    static OptocManifest make(std::span<const std::string> paths);
+
+    /**
+     * @brief Updates manifest. Only files whose size or mtime changed, or that are absent from
+     * the manifest, are re-read. Batches whose paths are not in `paths` are removed
+     * @param manifest Manifest to update
+     * @param paths Paths to `.optoctrees`
+     * @return Count of re-read files
+     *
+     * @throws `std::system_error` when:
+     * - file opening error
+     */
+    static std::size_t update(OptocManifest& manifest, std::span<const std::string> paths);
+
+    /**
+     * @brief Checks size and mtime of batch file without reading it
+     * @param batch Batch of manifest
+     * @return `true` if file exists and its size and mtime are the same as in `batch`
+     */
+    static bool is_up_to_date(const OptocManifestBatch& batch);
+
+    /**
+     * @brief Finds batch by path
+     * @param manifest Manifest
+     * @param path Path to `.optoctrees` as it was passed to `make`
+     * @return Pointer to batch or `nullptr` if not found
+     */
+    static const OptocManifestBatch* find_batch(const OptocManifest& manifest,
+                                                const std::string_view path);
+
+    /**
+     * @brief Packs `OptocManifest` into binary representation
+     * @param manifest `OptocManifest`
+     * @return `OptocTreeView` with binary representation
+     *
+     * @throws `std::invalid_argument` when:
+     * - path of a batch is longer than 65535 bytes
+     * - a batch has more than 65535 tree hashes
+     */
+    static OptocTreeView pack_manifest(const OptocManifest& manifest);
+
+    /**
+     * @brief Parses `OptocManifest` from its binary representation
+     * @param view Byte representation of manifest
+     * @return Parsed `OptocManifest`
+     *
+     * @throws `std::out_of_range` when:
+     * - `view` ends before all declared batches, paths and hashes are read
+     */
+    static OptocManifest parse_manifest(const OptocTreeView& view);
+
+  private:
+    static constexpr std::size_t min_batch_size = 2 + 8 * 4 + 2; ///< Batch with empty path
+
+    /**
+     * @brief Makes manifest batch from bytes of file
+     * @param path Path to `.optoctrees`
+     * @param optoctreeview Bytes of file
+     * @return `OptocManifestBatch` without size and mtime
+     */
+    static OptocManifestBatch hash_batch(const std::string_view path,
+                                         const OptocTreeView&   optoctreeview);
+
+    /**
+     * @brief Appends unsigned value in **little endian** to the buffer
+     * @param buffer Buffer
+     * @param value Value to write
+     * @param size Count of bytes to write (1..8)
+     */
+    static void append_le(OptocTreeView& buffer, uint64_t value, std::size_t size);
+
+    /**
+     * @brief Reads unsigned value in **little endian** from the buffer at the specified offset
+     * @param buffer Buffer with data
+     * @param offset Offset
+     * @param size Count of bytes to read (1..8)
+     * @return `uint64_t`
+     */
+    static uint64_t read_le(std::span<const byte> buffer, size_t offset, std::size_t size);
+};
+
+} // namespace optoctreeparser
@@ -0,0 +1,161 @@
+/**
+ * @brief Memory footprint of parsed optoctree data and its trimming
+ *
+ * @copyright maksimshchavelev © 2025 maksimshchavelev@gmail.com
+ * @license MIT
+ */
+
+#pragma once
+
+#include "base_struct/base_struct.hpp"
+#include <span>
+
+namespace optoctreeparser {
+
+/**
+ * @brief Memory taken by an object and everything it owns
+ */
+struct OptocMemoryUsage {
+    uint64_t used;     ///< Bytes of the object and of the elements its vectors hold
+    uint64_t reserved; ///< Bytes of the object and of the whole capacity of its vectors
+
+    bool operator==(const OptocMemoryUsage& other) const = default;
+};
+
+
+/**
+ * @brief Measures and trims memory of trees, batches and patches
+ *
+ * Usage counts `sizeof` of the object itself and the heap buffers of its vectors, recursively.
+ * Allocator bookkeeping is not counted, so real RSS is slightly higher.
+ *
+ * `shrink` drops unused capacity. `compact` also drops nodes that are not reachable from the root
+ * (see `Octree::has_children`) and lays the rest out the way `Grid` builds trees: the root first,
+ * then every group of 8 children followed by the groups of their descendants.
+ *
+ * @section example_usage Example usage
+ *
+ * @code{.cpp}
+ * Editor::apply(batch, operations);
+ * std::size_t released = Memory::compact(batch);
+ * OptocMemoryUsage usage = Memory::of_batch(batch); // usage.used == usage.reserved
+ * @endcode
+ */
+class Memory {
+  public:
+    /**
+     * @brief Measures tree
+     * @param tree `OptocTree`
+     * @return `OptocMemoryUsage`
+     */
+    static OptocMemoryUsage of_tree(const OptocTree& tree);
+
+    /**
+     * @brief Measures batch and its trees
+     * @param batch `OptocRoot`
+     * @return `OptocMemoryUsage`
+     */
+    static OptocMemoryUsage of_batch(const OptocRoot& batch);
+
+    /**
+     * @brief Measures batches together
+     * @param batches Batches
+     * @return Sum of `of_batch` of every batch
+     */
+    static OptocMemoryUsage of_batches(std::span<const OptocRoot> batches);
+
+    /**
+     * @brief Measures patched tree
+     * @param tree `OptocPatchTree`
+     * @return `OptocMemoryUsage`
+     */
+    static OptocMemoryUsage of_patch_tree(const OptocPatchTree& tree);
+
+    /**
+     * @brief Measures patched batch and its trees
+     * @param batch `OptocPatchBatch`
+     * @return `OptocMemoryUsage`
+     */
+    static OptocMemoryUsage of_patch_batch(const OptocPatchBatch& batch);
+
+    /**
+     * @brief Measures patch, its batches and trees
+     * @param patch `OptocPatchRoot`
+     * @return `OptocMemoryUsage`
+     */
+    static OptocMemoryUsage of_patch(const OptocPatchRoot& patch);
+
+    /**
+     * @brief Measures flat patch and its shared buffers
+     * @param patch `OptocFlatPatchRoot`
+     * @return `OptocMemoryUsage`
+     */
+    static OptocMemoryUsage of_flat_patch(const OptocFlatPatchRoot& patch);
+
+    /**
+     * @brief Drops unused capacity of tree
+     * @param tree `OptocTree`
+     * @return Count of released bytes
+     */
+    static std::size_t shrink(OptocTree& tree);
+
+    /**
+     * @brief Drops unused capacity of batch and its trees
+     * @param batch `OptocRoot`
+     * @return Count of released bytes
+     */
+    static std::size_t shrink(OptocRoot& batch);
+
+    /**
+     * @brief Drops unused capacity of patch, its batches and trees
+     * @param patch `OptocPatchRoot`
+     * @return Count of released bytes
+     */
+    static std::size_t shrink(OptocPatchRoot& patch);
+
+    /**
+     * @brief Drops unreachable nodes and unused capacity of tree. `node_count` is updated. Trees
+     * whose nodes share children are only shrunk
+     * @param tree `OptocTree`
+     * @return Count of released bytes
+     */
+    static std::size_t compact(OptocTree& tree);
+
+    /**
+     * @brief Compacts every tree of batch and drops unused capacity of batch
+     * @param batch `OptocRoot`
+     * @return Count of released bytes
+     */
+    static std::size_t compact(OptocRoot& batch);
+
+  private:
+    /**
+     * @brief Adds usage of a part to usage of the whole
+     * @param total Usage of the whole
+     * @param part Usage of the part
+     */
+    static void add(OptocMemoryUsage& total, const OptocMemoryUsage& part);
+
+    /**
+     * @brief Copies node and its reachable descendants
+     * @param source Tree to copy from
+     * @param node Index of node in `source`
+     * @param target Tree to copy to. Slot of node must already exist
+     * @param slot Index of node in `target`
+     * @return `false` if `target` would get more nodes than `source` (shared children)
+     */
+    static bool copy_reachable(const OptocTree& source,
+                               std::size_t      node,
+                               OptocTree&       target,
+                               std::size_t      slot);
+
+    /**
+     * @brief Difference of reserved bytes
+     * @param before Usage before trimming
+     * @param after Usage after trimming
+     * @return Count of released bytes
+     */
+    static std::size_t released(const OptocMemoryUsage& before, const OptocMemoryUsage& after);
+};
+
+} // namespace optoctreeparser
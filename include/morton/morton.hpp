@@ -0,0 +1,125 @@
+/**
+ * @brief Morton-ordered (Z-curve) linear form of `OptocTree`
+ *
+ * @copyright maksimshchavelev © 2025 maksimshchavelev@gmail.com
+ * @license MIT
+ */
+
+#pragma once
+
+#include "base_struct/base_struct.hpp"
+#include "octree/octree.hpp"
+#include <span>
+
+namespace optoctreeparser {
+
+/**
+ * @brief Leaf of linearized tree
+ */
+struct OptocMortonLeaf {
+    uint16_t code;            ///< Morton code of the first voxel of leaf
+    byte     depth;           ///< Depth of leaf, its edge is `Octree::tree_size >> depth` voxels
+    byte     material_type;   ///< Material type
+    byte     signed_distance; ///< Signed distance
+
+    bool operator==(const OptocMortonLeaf& other) const = default;
+};
+
+
+/**
+ * @brief Converts `OptocTree` to a list of leaves sorted by Morton code and back
+ *
+ * Bits of child index already follow Morton order (x is bit 0, y is bit 1, z is bit 2), so
+ * the Morton code of a voxel is the path of child indices from the root, 3 bits per level.
+ * Leaves of one cube are a contiguous run of the list, and leaves that are close in space are
+ * close in memory.
+ *
+ * @code{.cpp}
+ * auto leaves = Morton::linearize(tree);
+ * const OptocMortonLeaf* leaf = Morton::find(leaves, {4, 17, 30});
+ * const OptocMortonLeaf* right = Morton::find(leaves, {5, 17, 30}); // neighbour along x
+ * OptocTree same = Morton::to_tree(leaves);
+ * @endcode
+ */
+class Morton {
+  public:
+    /**
+     * @brief Morton code of voxel of tree
+     * @param voxel Position inside tree, every coordinate is in `[0, Octree::tree_size)`
+     * @return Morton code
+     */
+    static uint16_t encode(const OptocVoxel& voxel);
+
+    /**
+     * @brief Voxel of tree by its Morton code
+     * @param code Morton code
+     * @return Position inside tree
+     */
+    static OptocVoxel decode(uint16_t code);
+
+    /**
+     * @brief Lists leaves of tree in Morton order
+     * @param tree `OptocTree`
+     * @return Leaves sorted by `code`. Tree without nodes gives empty list
+     *
+     * @note Nodes deeper than `Octree::max_depth` are not visited, the node at
+     * `Octree::max_depth` becomes a leaf
+     */
+    static std::vector<OptocMortonLeaf> linearize(const OptocTree& tree);
+
+    /**
+     * @brief Encodes leaves back into tree. Children are stored contiguously after their parent
+     * in depth-first order, the same layout as `Grid::to_tree`
+     * @param leaves Leaves sorted by `code` that cover the whole tree without overlaps
+     * @return `OptocTree`. Inner nodes get majority material and average distance of children
+     *
+     * @throws `std::invalid_argument` when:
+     * - leaves are not sorted or overlap
+     * - leaves do not cover the whole tree
+     * - depth of leaf is greater than `Octree::max_depth`
+     */
+    static OptocTree to_tree(std::span<const OptocMortonLeaf> leaves);
+
+    /**
+     * @brief Finds leaf that contains voxel
+     * @param leaves Leaves returned by `linearize`
+     * @param voxel Position inside tree
+     * @return Pointer to leaf or `nullptr` if `leaves` is empty
+     */
+    static const OptocMortonLeaf* find(std::span<const OptocMortonLeaf> leaves,
+                                       const OptocVoxel&                voxel);
+
+    /**
+     * @brief Leaves inside cube of tree
+     * @param leaves Leaves returned by `linearize`
+     * @param origin First voxel of cube
+     * @param depth Depth of cube, its edge is `Octree::tree_size >> depth` voxels
+     * @return Contiguous run of `leaves`. Empty if the cube is inside a bigger leaf
+     */
+    static std::span<const OptocMortonLeaf> subtree(std::span<const OptocMortonLeaf> leaves,
+                                                    const OptocVoxel&                origin,
+                                                    std::size_t                      depth);
+
+  private:
+    /**
+     * @brief Count of codes covered by cube
+     * @param depth Depth of cube
+     * @return `8^(Octree::max_depth - depth)`
+     */
+    static std::size_t span_of(std::size_t depth);
+
+    /**
+     * @brief Builds node for cube from its leaves
+     * @param leaves Leaves inside cube
+     * @param code Morton code of the first voxel of cube
+     * @param depth Depth of cube
+     * @param tree Tree to append children to
+     * @return Node for the cube
+     */
+    static OptocNode build(std::span<const OptocMortonLeaf> leaves,
+                           std::size_t                      code,
+                           std::size_t                      depth,
+                           OptocTree&                       tree);
+};
+
+} // namespace optoctreeparser
@@ -0,0 +1,135 @@
+/**
+ * @brief Helpers to walk the node structure of `OptocTree`
+ *
+ * @copyright maksimshchavelev © 2025 maksimshchavelev@gmail.com
+ * @license MIT
+ */
+
+#pragma once
+
+#include "base_struct/base_struct.hpp"
+#include <span>
+#include <unordered_map>
+
+namespace optoctreeparser {
+
+/**
+ * @brief Integer position of voxel
+ */
+struct OptocVoxel {
+    int32_t x; ///< X coordinate
+    int32_t y; ///< Y coordinate
+    int32_t z; ///< Z coordinate
+
+    bool operator==(const OptocVoxel& other) const = default;
+};
+
+
+/**
+ * @brief Point in voxel space. Voxel `{x, y, z}` covers `[x, x + 1)` along every axis
+ */
+struct OptocPoint {
+    float x; ///< X coordinate
+    float y; ///< Y coordinate
+    float z; ///< Z coordinate
+
+    bool operator==(const OptocPoint& other) const = default;
+};
+
+
+/**
+ * @brief Position of batch in a world, in batches
+ */
+struct OptocBatchCoordinate {
+    int32_t x; ///< X coordinate
+    int32_t y; ///< Y coordinate
+    int32_t z; ///< Z coordinate
+
+    bool operator==(const OptocBatchCoordinate& other) const = default;
+};
+
+
+/**
+ * @brief Hash of `OptocBatchCoordinate` for unordered containers
+ */
+struct OptocBatchCoordinateHash {
+    std::size_t operator()(const OptocBatchCoordinate& coordinate) const;
+};
+
+
+/**
+ * @brief Batches of a world by their position
+ */
+using OptocWorld = std::unordered_map<OptocBatchCoordinate, OptocRoot, OptocBatchCoordinateHash>;
+
+
+/**
+ * @brief Helpers to walk the node structure of `OptocTree`
+ *
+ * Node 0 is the root of a tree. A node with `first_child_node` ≠ 0 has 8 children stored
+ * contiguously starting from `first_child_node`. Children must be stored after their parent, so
+ * links pointing backwards (or outside of `nodes`) are treated as leaves. This keeps every walk
+ * finite even for malformed input.
+ *
+ * Geometry used by the library:
+ * - a tree is a cube of `tree_size` voxels, its leaves at depth `d` are cubes of `tree_size >> d`
+ * - child `i` of a node is shifted by `{i & 1, (i >> 1) & 1, (i >> 2) & 1}` halves of the node
+ * - a batch is a cube of `trees_per_side`³ trees, tree `i` of `OptocRoot::trees` is at
+ *   `{i % 5, (i / 5) % 5, i / 25}` trees from the batch origin
+ */
+class Octree {
+  public:
+    static constexpr std::size_t children_count = 8;   ///< Count of children of inner node
+    static constexpr std::size_t trees_per_batch = 125; ///< Count of trees in one batch (5×5×5)
+    static constexpr std::size_t trees_per_side = 5;    ///< Count of trees along batch edge
+    static constexpr std::size_t tree_size = 32;        ///< Count of voxels along tree edge
+    static constexpr std::size_t max_depth = 5;         ///< Depth of 1-voxel leaves
+    static constexpr std::size_t batch_size = 160;      ///< Count of voxels along batch edge
+
+    /**
+     * @brief Checks whether node has valid children
+     * @param tree `OptocTree`
+     * @param node Index of node
+     * @return `true` if node is inner node
+     */
+    static bool has_children(const OptocTree& tree, std::size_t node);
+
+    /**
+     * @brief Computes depth of tree
+     * @param tree `OptocTree`
+     * @return Count of levels below the root. 0 for tree with only root or without nodes
+     */
+    static std::size_t depth(const OptocTree& tree);
+
+    /**
+     * @brief Offset of child inside its parent
+     * @param child Number of child (0..7)
+     * @return Offset in halves of parent, every coordinate is 0 or 1
+     */
+    static OptocVoxel child_offset(std::size_t child);
+
+    /**
+     * @brief Position of the first voxel of tree inside batch
+     * @param tree Index of tree in `OptocRoot::trees`
+     * @return Position in voxels from the batch origin
+     */
+    static OptocVoxel tree_origin(std::size_t tree);
+
+    /**
+     * @brief Index of tree that contains voxel
+     * @param voxel Position in voxels from the batch origin. Must be inside the batch
+     * @return Index of tree in `OptocRoot::trees`
+     */
+    static std::size_t tree_index(const OptocVoxel& voxel);
+
+    /**
+     * @brief Makes inner node from its children
+     * @param children The 8 children of node
+     * @param first_child Index of the first child in `OptocTree::nodes`
+     * @return `OptocNode` with majority material of children (ties go to the first child with
+     * that count) and their average decoded distance
+     */
+    static OptocNode parent_of(std::span<const OptocNode> children, std::size_t first_child);
+};
+
+} // namespace optoctreeparser
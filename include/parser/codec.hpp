@@ -0,0 +1,486 @@
+/**
+ * @brief Header-only constexpr codec of optoctree and optoctreepatch
+ *
+ * @copyright maksimshchavelev © 2025 maksimshchavelev@gmail.com
+ * @license MIT
+ */
+
+#pragma once
+
+#include "base_struct/base_struct.hpp"
+#include "layout/node_layout.hpp"
+#include "octree/octree.hpp"
+#include <array>
+#include <format>
+#include <span>
+#include <stdexcept>
+
+namespace optoctreeparser {
+
+/**
+ * @brief Reads and writes nodes, trees, batches and patch headers. Everything is `constexpr`
+ *
+ * This is the core that `Parser` wraps. Include it to inline decoding into your own loops or to
+ * check encoded data at compile time:
+ *
+ * @code{.cpp}
+ * constexpr std::array<byte, 8> bytes = {0x25, 0x80, 0x02, 0x00, 0x00, 0x7E, 0x00, 0x00};
+ * static_assert(Codec::read_node(bytes, 4).signed_distance == 0x7E);
+ * @endcode
+ *
+ * Readers of whole trees, batches and patches check bounds and throw `std::out_of_range`; at
+ * compile time that is a compilation error. Readers and writers of single values do not check
+ * bounds.
+ *
+ * Readers and writers of trees and batches take a `NodeLayout` (`DefaultLayout` by default), so
+ * `LayoutCodec` runs the same loops with its own nodes:
+ *
+ * @code{.cpp}
+ * auto batch = Codec::read_batch<FlaggedLayout>(view); // BasicOptocRoot<FlaggedLayout>
+ * @endcode
+ */
+class Codec {
+  public:
+    static constexpr std::size_t version_size = 4;     ///< Bytes of version
+    static constexpr std::size_t node_size = 4;        ///< Bytes of node
+    static constexpr std::size_t tree_header_size = 2; ///< Bytes of node count of batch tree
+    static constexpr std::size_t patch_batch_size = 7; ///< Bytes of position and octree count
+    static constexpr std::size_t patch_tree_size = 3;  ///< Bytes of octree number and node count
+    static constexpr std::size_t trees_per_batch = Octree::trees_per_batch; ///< Trees in batch
+
+    /**
+     * @brief Tree callback of `read_batch` that does nothing
+     */
+    struct SkipTree {
+        constexpr void operator()(const auto& /*tree*/, std::span<const byte> /*nodes*/) const {}
+    };
+
+    /**
+     * @brief Counts of batches, trees and nodes of optoctreepatch
+     */
+    struct PatchCounts {
+        std::size_t batches; ///< Count of batches
+        std::size_t trees;   ///< Count of trees
+        std::size_t nodes;   ///< Count of nodes
+    };
+
+    /**
+     * @brief Checks that the buffer has `size` bytes starting from `offset`
+     * @param buffer Buffer with data
+     * @param offset Offset
+     * @param size Count of bytes to be read
+     *
+     * @throws `std::out_of_range` when:
+     * - buffer is too short
+     */
+    static constexpr void require(std::span<const byte> buffer,
+                                  std::size_t           offset,
+                                  std::size_t           size) {
+        if (offset > buffer.size() || buffer.size() - offset < size) {
+            throw std::out_of_range(std::format(
+                "Unexpected end of data: {} bytes needed at offset {}, but size is {}",
+                size,
+                offset,
+                buffer.size()));
+        }
+    }
+
+    /**
+     * @brief Reads uint16_t in **little endian** from the buffer at the specified offset
+     * @param buffer Buffer with data
+     * @param offset Offset
+     * @return `uint16_t`
+     */
+    static constexpr uint16_t read_u16_le(std::span<const byte> buffer, std::size_t offset) {
+        return static_cast<uint16_t>(buffer[offset] | (buffer[offset + 1] << 8));
+    }
+
+    /**
+     * @brief Reads int16_t in **little endian** from the buffer at the specified offset
+     * @param buffer Buffer with data
+     * @param offset Offset
+     * @return `int16_t`
+     */
+    static constexpr int16_t read_i16_le(std::span<const byte> buffer, std::size_t offset) {
+        return static_cast<int16_t>(read_u16_le(buffer, offset));
+    }
+
+    /**
+     * @brief Reads int32_t in **little endian** from the buffer at the specified offset
+     * @param buffer Buffer with data
+     * @param offset Offset
+     * @return `int32_t`
+     */
+    static constexpr int32_t read_i32_le(std::span<const byte> buffer, std::size_t offset) {
+        uint32_t bits{0};
+        for (std::size_t i = 0; i < 4; ++i) {
+            bits |= static_cast<uint32_t>(buffer[offset + i]) << (i * 8);
+        }
+
+        return static_cast<int32_t>(bits);
+    }
+
+    /**
+     * @brief Writes uint16_t in **little endian** to the buffer at the specified offset
+     * @param buffer Buffer
+     * @param offset Offset
+     * @param value Value to write
+     */
+    static constexpr void write_u16_le(std::span<byte> buffer, std::size_t offset, uint16_t value) {
+        buffer[offset] = static_cast<byte>(value & 0xFF);
+        buffer[offset + 1] = static_cast<byte>((value >> 8) & 0xFF);
+    }
+
+    /**
+     * @brief Writes int16_t in **little endian** to the buffer at the specified offset
+     * @param buffer Buffer
+     * @param offset Offset
+     * @param value Value to write
+     */
+    static constexpr void write_i16_le(std::span<byte> buffer, std::size_t offset, int16_t value) {
+        write_u16_le(buffer, offset, static_cast<uint16_t>(value));
+    }
+
+    /**
+     * @brief Writes int32_t in **little endian** to the buffer at the specified offset
+     * @param buffer Buffer
+     * @param offset Offset
+     * @param value Value to write
+     */
+    static constexpr void write_i32_le(std::span<byte> buffer, std::size_t offset, int32_t value) {
+        auto bits = static_cast<uint32_t>(value);
+        for (std::size_t i = 0; i < 4; ++i) {
+            buffer[offset + i] = static_cast<byte>((bits >> (i * 8)) & 0xFF);
+        }
+    }
+
+    /**
+     * @brief Reads node from the buffer at the specified offset
+     * @param buffer Buffer with data
+     * @param offset Offset
+     * @return `OptocNode`
+     */
+    static constexpr OptocNode read_node(std::span<const byte> buffer, std::size_t offset) {
+        return {.material_type = buffer[offset],
+                .signed_distance = buffer[offset + 1],
+                .first_child_node = read_u16_le(buffer, offset + 2)};
+    }
+
+    /**
+     * @brief Writes node to the buffer at the specified offset
+     * @param buffer Buffer
+     * @param offset Offset
+     * @param node `OptocNode`
+     */
+    static constexpr void write_node(std::span<byte>  buffer,
+                                     std::size_t      offset,
+                                     const OptocNode& node) {
+        buffer[offset] = node.material_type;
+        buffer[offset + 1] = node.signed_distance;
+        write_u16_le(buffer, offset + 2, node.first_child_node);
+    }
+
+    /**
+     * @brief Reads tree of batch (node count and nodes)
+     * @tparam Layout Layout of nodes
+     * @param buffer Buffer with data
+     * @param offset Offset of tree. Moved to the end of tree
+     * @return Tree of `Layout` (`OptocTree` for `DefaultLayout`)
+     *
+     * @throws `std::out_of_range` when:
+     * - buffer ends before all declared nodes are read
+     */
+    template <NodeLayout Layout = DefaultLayout>
+    static constexpr typename LayoutTypes<Layout>::tree_type
+    read_tree(std::span<const byte> buffer, std::size_t& offset) {
+        typename LayoutTypes<Layout>::tree_type tree{};
+
+        require(buffer, offset, tree_header_size);
+        tree.node_count = read_u16_le(buffer, offset);
+        offset += tree_header_size;
+
+        // One check per tree keeps the node loop free of bounds checks
+        require(buffer, offset, std::size_t{tree.node_count} * node_size);
+        tree.nodes.reserve(tree.node_count);
+
+        for (std::size_t node = 0; node < tree.node_count; ++node) {
+            tree.nodes.push_back(Layout::decode(read_node(buffer, offset)));
+            offset += node_size;
+        }
+
+        return tree;
+    }
+
+    /**
+     * @brief Reads batch
+     * @tparam Layout Layout of nodes
+     * @param buffer Byte representation of optoctree
+     * @param on_tree Called with every tree and its encoded nodes right after the tree is read
+     * @return Batch of `Layout` (`OptocRoot` for `DefaultLayout`)
+     *
+     * @throws `std::out_of_range` when:
+     * - buffer ends before all declared trees and nodes are read
+     */
+    template <NodeLayout Layout = DefaultLayout, class OnTree = SkipTree>
+    static constexpr typename LayoutTypes<Layout>::root_type
+    read_batch(std::span<const byte> buffer, OnTree on_tree = {}) {
+        typename LayoutTypes<Layout>::root_type batch{};
+
+        require(buffer, 0, version_size);
+        batch.version = read_i32_le(buffer, 0);
+
+        std::size_t offset = version_size;
+        batch.trees.reserve(trees_per_batch);
+
+        for (std::size_t tree = 0; tree < trees_per_batch; ++tree) {
+            std::size_t nodes_offset = offset + tree_header_size;
+            batch.trees.push_back(read_tree<Layout>(buffer, offset));
+
+            on_tree(batch.trees.back(), buffer.subspan(nodes_offset, offset - nodes_offset));
+        }
+
+        return batch;
+    }
+
+    /**
+     * @brief Writes batch
+     * @tparam Layout Layout of nodes
+     * @param batch Batch of `Layout` (`OptocRoot` for `DefaultLayout`)
+     * @return Byte representation of optoctree
+     */
+    template <NodeLayout Layout = DefaultLayout>
+    static constexpr OptocTreeView
+    write_batch(const typename LayoutTypes<Layout>::root_type& batch) {
+        std::size_t size = version_size;
+        for (const auto& tree : batch.trees) {
+            size += tree_header_size + tree.nodes.size() * node_size;
+        }
+
+        OptocTreeView   view(size, 0x00);
+        std::span<byte> buffer(view);
+
+        write_i32_le(buffer, 0, batch.version);
+        std::size_t offset = version_size;
+
+        for (const auto& tree : batch.trees) {
+            write_u16_le(buffer, offset, tree.node_count);
+            offset += tree_header_size;
+
+            for (const auto& node : tree.nodes) {
+                write_node(buffer, offset, Layout::encode(node));
+                offset += node_size;
+            }
+        }
+
+        return view;
+    }
+
+    /**
+     * @brief Reads position and octree count of patched batch
+     * @param buffer Buffer with data
+     * @param offset Offset of batch
+     * @return `OptocPatchBatch` without octrees
+     *
+     * @throws `std::out_of_range` when:
+     * - buffer is too short
+     */
+    static constexpr OptocPatchBatch read_patch_batch_header(std::span<const byte> buffer,
+                                                             std::size_t           offset) {
+        require(buffer, offset, patch_batch_size);
+
+        return {.x_position = read_i16_le(buffer, offset),
+                .y_position = read_i16_le(buffer, offset + 2),
+                .z_position = read_i16_le(buffer, offset + 4),
+                .octree_count = buffer[offset + 6],
+                .octrees = {}};
+    }
+
+    /**
+     * @brief Reads octree number and node count of patched tree
+     * @param buffer Buffer with data
+     * @param offset Offset of tree
+     * @return `OptocPatchTree` without nodes
+     *
+     * @throws `std::out_of_range` when:
+     * - buffer is too short
+     */
+    static constexpr OptocPatchTree read_patch_tree_header(std::span<const byte> buffer,
+                                                           std::size_t           offset) {
+        require(buffer, offset, patch_tree_size);
+
+        return {.octree_number = buffer[offset],
+                .node_count = read_u16_le(buffer, offset + 1),
+                .nodes = {}};
+    }
+
+    /**
+     * @brief Writes position and octree count of patched batch
+     * @param buffer Buffer
+     * @param offset Offset of batch
+     * @param batch `OptocPatchBatch`. Octrees are not written
+     */
+    static constexpr void write_patch_batch_header(std::span<byte>        buffer,
+                                                   std::size_t            offset,
+                                                   const OptocPatchBatch& batch) {
+        write_i16_le(buffer, offset, batch.x_position);
+        write_i16_le(buffer, offset + 2, batch.y_position);
+        write_i16_le(buffer, offset + 4, batch.z_position);
+        buffer[offset + 6] = batch.octree_count;
+    }
+
+    /**
+     * @brief Writes octree number and node count of patched tree
+     * @param buffer Buffer
+     * @param offset Offset of tree
+     * @param octree_number Number of octree
+     * @param node_count Count of nodes
+     */
+    static constexpr void write_patch_tree_header(std::span<byte> buffer,
+                                                  std::size_t     offset,
+                                                  byte            octree_number,
+                                                  uint16_t        node_count) {
+        buffer[offset] = octree_number;
+        write_u16_le(buffer, offset + 1, node_count);
+    }
+
+    /**
+     * @brief Counts batches, trees and nodes of optoctreepatch by walking their headers
+     * @param buffer Byte representation of optoctreepatch
+     * @return `PatchCounts`. Truncated buffer gives the counts of what starts in it
+     */
+    static constexpr PatchCounts count_patch(std::span<const byte> buffer) {
+        PatchCounts counts{};
+
+        for (std::size_t offset = version_size; offset + patch_batch_size <= buffer.size();
+             ++counts.batches) {
+            std::size_t octree_count = buffer[offset + 6];
+            offset += patch_batch_size;
+
+            for (std::size_t i = 0; i < octree_count && offset + patch_tree_size <= buffer.size();
+                 ++i) {
+                std::size_t node_count = read_u16_le(buffer, offset + 1);
+                offset += patch_tree_size + node_count * node_size;
+
+                ++counts.trees;
+                counts.nodes += node_count;
+            }
+        }
+
+        return counts;
+    }
+
+    /**
+     * @brief Reads optoctreepatch
+     * @param buffer Byte representation of optoctreepatch
+     * @return `OptocPatchRoot`
+     *
+     * @throws `std::out_of_range` when:
+     * - buffer ends in the middle of a batch, tree or node
+     */
+    static constexpr OptocPatchRoot read_patch(std::span<const byte> buffer) {
+        OptocPatchRoot root{};
+
+        require(buffer, 0, version_size);
+        root.version = read_i32_le(buffer, 0);
+
+        // The format has no batch count, so batch headers are counted before parsing
+        root.batches.reserve(count_patch(buffer).batches);
+
+        for (std::size_t offset = version_size; offset < buffer.size();) {
+            OptocPatchBatch batch = read_patch_batch_header(buffer, offset);
+            offset += patch_batch_size;
+
+            batch.octrees.reserve(batch.octree_count);
+
+            for (std::size_t i = 0; i < batch.octree_count; ++i) {
+                OptocPatchTree tree = read_patch_tree_header(buffer, offset);
+                offset += patch_tree_size;
+
+                require(buffer, offset, std::size_t{tree.node_count} * node_size);
+                tree.nodes.reserve(tree.node_count);
+
+                for (std::size_t node = 0; node < tree.node_count; ++node) {
+                    tree.nodes.push_back(read_node(buffer, offset));
+                    offset += node_size;
+                }
+
+                batch.octrees.push_back(std::move(tree));
+            }
+
+            root.batches.push_back(std::move(batch));
+        }
+
+        return root;
+    }
+
+    /**
+     * @brief Writes optoctreepatch
+     * @param patch `OptocPatchRoot`
+     * @return Byte representation of optoctreepatch
+     */
+    static constexpr OptocTreeView write_patch(const OptocPatchRoot& patch) {
+        std::size_t size = version_size;
+        for (const auto& batch : patch.batches) {
+            size += patch_batch_size;
+
+            for (const auto& tree : batch.octrees) {
+                size += patch_tree_size + tree.nodes.size() * node_size;
+            }
+        }
+
+        OptocTreeView   view(size, 0x00);
+        std::span<byte> buffer(view);
+
+        write_i32_le(buffer, 0, patch.version);
+        std::size_t offset = version_size;
+
+        for (const auto& batch : patch.batches) {
+            write_patch_batch_header(buffer, offset, batch);
+            offset += patch_batch_size;
+
+            for (const auto& tree : batch.octrees) {
+                write_patch_tree_header(buffer, offset, tree.octree_number, tree.node_count);
+                offset += patch_tree_size;
+
+                for (const auto& node : tree.nodes) {
+                    write_node(buffer, offset, node);
+                    offset += node_size;
+                }
+            }
+        }
+
+        return view;
+    }
+
+    /**
+     * @brief Finds where every tree of encoded batch starts without decoding nodes
+     * @param buffer Byte representation of optoctree
+     * @return Offsets of the 125 trees and the offset of the end of the last tree
+     *
+     * @throws `std::out_of_range` when:
+     * - buffer ends before all declared trees and nodes are read
+     */
+    static constexpr std::array<std::size_t, trees_per_batch + 1>
+    find_tree_offsets(std::span<const byte> buffer) {
+        std::array<std::size_t, trees_per_batch + 1> offsets{};
+
+        require(buffer, 0, version_size);
+        std::size_t offset = version_size;
+
+        for (std::size_t tree = 0; tree < trees_per_batch; ++tree) {
+            offsets[tree] = offset;
+
+            require(buffer, offset, tree_header_size);
+            std::size_t node_count = read_u16_le(buffer, offset);
+            offset += tree_header_size;
+
+            require(buffer, offset, node_count * node_size);
+            offset += node_count * node_size;
+        }
+
+        offsets[trees_per_batch] = offset;
+        return offsets;
+    }
+};
+
+} // namespace optoctreeparser
@@ -8,6 +8,8 @@
 #pragma once
 
 #include "base_struct/base_struct.hpp"
+#include "hasher/hasher.hpp"
+#include <array>
 #include <span>
 
 namespace optoctreeparser {
@@ -63,6 +65,8 @@ namespace optoctreeparser {
  *
  * @note `OptocTreeView` is just `std::vector<byte>`. This is necessary for representing OptocTree
  * bytes. Use `Reader::optoctreeview_from_file` to read bytes from file
+ *
+ * @see `Codec` for the header-only `constexpr` core that `Parser` wraps
  */
 class Parser {
   public:
@@ -71,9 +75,25 @@ class Parser {
      * @param optoctree Byte representation of optoctree
      * @return Parsed `OptocRoot`
      * @see `OptocTreeView`
+     *
+     * @throws `std::out_of_range` when:
+     * - optoctree ends before all declared trees and nodes are read
      */
     static OptocRoot parse_optoctree_batch(const OptocTreeView& optoctree);
 
+    /**
+     * @brief Parses optoctree from its binary representation and computes content hashes of its
+     * trees while parsing
+     * @param optoctree Byte representation of optoctree
+     * @param hashes Output. Hashes of parsed batch, same as `Hasher::hash_root` of the result
+     * @return Parsed `OptocRoot`
+     * @see `Hasher`
+     *
+     * @throws `std::out_of_range` when:
+     * - optoctree ends before all declared trees and nodes are read
+     */
+    static OptocRoot parse_optoctree_batch(const OptocTreeView& optoctree, OptocRootHashes& hashes);
+
     /**
      * @brief Packs `OptocRoot` into binary representation
      * @param batch `OptocBatch`
@@ -86,6 +106,9 @@ class Parser {
      * @param optoctree Byte representation of optoctreepatch
      * @return Parsed `OptocPatchRoot`
      * @see `OptocTreeView`
+     *
+     * @throws `std::out_of_range` when:
+     * - optoctreepatch ends in the middle of a batch, tree or node
      */
     static OptocPatchRoot parse_optoctreepatch(const OptocTreeView& optoctree);
 
@@ -96,76 +119,73 @@ class Parser {
      */
     static OptocTreeView pack_optoctreepatch(const OptocPatchRoot& patch);
 
-  private:
-    /**
-     * @brief Reads uint16_t in **little endian** (used in optoctree) from the buffer at the
-     * specified offset
-     * @param buffer Buffer with data
-     * @param offset Offset
-     * @return `uint16_t`
-     */
-    static uint16_t read_u16_le(std::span<const byte> buffer, size_t offset);
-
     /**
-     * @brief Reads int16_t in **little endian** (used in optoctreepatch) from the buffer at the
-     * specified offset
-     * @param buffer Buffer with data
-     * @param offset Offset
-     * @return `int16_t`
+     * @brief Parses optoctreepatch into shared buffers. Takes three allocations for any patch
+     * @param optoctree Byte representation of optoctreepatch
+     * @return Parsed `OptocFlatPatchRoot`
+     * @see `OptocTreeView`
+     *
+     * @throws `std::out_of_range` when:
+     * - optoctreepatch ends in the middle of a batch, tree or node
      */
-    static int16_t read_i16_le(std::span<const byte> buffer, size_t offset);
+    static OptocFlatPatchRoot parse_optoctreepatch_flat(const OptocTreeView& optoctree);
 
     /**
-     * @brief Reads int32_t in **little endian** (used in optoctree) from the buffer at the
-     * specified offset
-     * @param buffer Buffer with data
-     * @param offset Offset
-     * @return `uint16_t`
+     * @brief Packs `OptocFlatPatchRoot` into binary representation. Batches are written in order,
+     * each with its range of trees
+     * @param patch `OptocFlatPatchRoot`
+     * @return `OptocTreeView` with binary representation
+     *
+     * @throws `std::out_of_range` when:
+     * - range of trees of batch or range of nodes of tree is outside its buffer
      */
-    static int32_t read_i32_le(std::span<const byte> buffer, size_t offset);
+    static OptocTreeView pack_optoctreepatch_flat(const OptocFlatPatchRoot& patch);
 
     /**
-     * @brief Writes uint16_t in **little endian** (used in optoctree) from the buffer at the
-     * specified offset
-     * @param buffer Buffer with data
-     * @param offset Offset
-     * @param value Value for writing
+     * @brief Converts `OptocPatchRoot` to `OptocFlatPatchRoot`
+     * @param patch `OptocPatchRoot`
+     * @return `OptocFlatPatchRoot` with the same batches, trees and nodes
      */
-    static void write_u16_le(std::span<byte> buffer, size_t offset, uint16_t value);
+    static OptocFlatPatchRoot flatten_patch(const OptocPatchRoot& patch);
 
     /**
-     * @brief Writes int32_t in **little endian** (used in optoctree) from the buffer at the
-     * specified offset
-     * @param buffer Buffer with data
-     * @param offset Offset
-     * @param value Value for writing
+     * @brief Converts `OptocFlatPatchRoot` to `OptocPatchRoot`
+     * @param patch `OptocFlatPatchRoot`
+     * @return `OptocPatchRoot` with the same batches, trees and nodes
+     *
+     * @throws `std::out_of_range` when:
+     * - range of trees of batch or range of nodes of tree is outside its buffer
      */
-    static void write_i32_le(std::span<byte> buffer, size_t offset, int32_t value);
+    static OptocPatchRoot expand_patch(const OptocFlatPatchRoot& patch);
 
     /**
-     * @brief Writes int16_t in **little endian** (used in optoctreepatch) to the buffer at the
-     * specified offset
-     * @param buffer Buffer with data
-     * @param offset Offset
-     * @param value Value to write
+     * @brief Finds where every tree of encoded batch starts without decoding nodes
+     * @param optoctree Byte representation of optoctree
+     * @return Offsets of the 125 trees and the offset of the end of the last tree. Tree `i`
+     * (its node count and nodes) is the range `[offsets[i], offsets[i + 1])`
+     *
+     * @throws `std::out_of_range` when:
+     * - optoctree ends before all declared trees and nodes are read
      */
-    static void write_i16_le(std::span<byte> buffer, size_t offset, int16_t value);
+    static std::array<std::size_t, 126> find_tree_offsets(std::span<const byte> optoctree);
 
+  private:
     /**
-     * @brief Reads node from the buffer at the specified offset
-     * @param buffer Buffer with data
-     * @param offset offset
-     * @return `OptocNode`
+     * @brief Parses optoctree from its binary representation
+     * @param buffer Byte representation of optoctree
+     * @param hashes Output for hashes of trees. Hashes are not computed if `nullptr`
+     * @return Parsed `OptocRoot`
      */
-    static OptocNode read_node(std::span<const byte> buffer, size_t offset);
+    static OptocRoot parse_batch(std::span<const byte> buffer, OptocRootHashes* hashes);
 
     /**
-     * @brief Writes node from the buffer at the specified offset
-     * @param buffer Buffer with data
-     * @param offset offset
-     * @param node `OptocNode` node
+     * @brief Checks ranges of trees and nodes of flat patch
+     * @param patch `OptocFlatPatchRoot`
+     *
+     * @throws `std::out_of_range` when:
+     * - range of trees of batch or range of nodes of tree is outside its buffer
      */
-    static void write_node(std::span<byte> buffer, size_t offset, const OptocNode& node);
+    static void validate_flat_patch(const OptocFlatPatchRoot& patch);
 };
 
 } // namespace optoctreeparser
@@ -0,0 +1,193 @@
+/**
+ * @brief Applies `.optoctreepatch` to batches and builds patches that undo it
+ *
+ * @copyright maksimshchavelev © 2025 maksimshchavelev@gmail.com
+ * @license MIT
+ */
+
+#pragma once
+
+#include "base_struct/base_struct.hpp"
+#include "octree/octree.hpp"
+#include "world_index/world_index.hpp"
+#include <bitset>
+
+namespace optoctreeparser {
+
+/**
+ * @brief Applies `OptocPatchRoot` to batches and builds inverse patches
+ *
+ * The inverse of a patch holds the original versions of only the trees the patch replaces.
+ * Applying the inverse after the patch restores the world exactly, and costs as much as applying
+ * the patch itself. Every world operation accepts both `OptocWorld` and `WorldIndex`.
+ *
+ * @section example_usage Example usage
+ *
+ * @code{.cpp}
+ * // Install: one pass that also remembers what is replaced
+ * OptocPatchRoot inverse = Patcher::apply_with_inverse(world, patch);
+ * Writer::optoctreeview_to_file("uninstall.optoctreepatch", Parser::pack_optoctreepatch(inverse));
+ *
+ * // Uninstall
+ * Patcher::apply(world, inverse);
+ * @endcode
+ */
+class Patcher {
+  public:
+    /**
+     * @brief Replaces trees of batch with trees of patch batch
+     * @param batch `OptocRoot`
+     * @param patch_batch Patched batch. Its position is not checked
+     *
+     * @throws `std::out_of_range` when:
+     * - octree number of patch tree is not less than count of trees of `batch`. `batch` is not
+     *   changed in that case
+     */
+    static void apply(OptocRoot& batch, const OptocPatchBatch& patch_batch);
+
+    /**
+     * @brief Applies patch to world
+     * @param world Batches of world
+     * @param patch `OptocPatchRoot`
+     *
+     * @throws `std::out_of_range` when:
+     * - batch of patch is absent from `world`
+     * - octree number of patch tree is not less than count of trees of its batch
+     *
+     * `world` is not changed if an exception is thrown
+     */
+    static void apply(OptocWorld& world, const OptocPatchRoot& patch);
+
+    /**
+     * @brief Applies patch to world
+     * @param world Batches of world
+     * @param patch `OptocPatchRoot`
+     *
+     * @throws Same as `apply(OptocWorld&, const OptocPatchRoot&)`
+     */
+    static void apply(WorldIndex& world, const OptocPatchRoot& patch);
+
+    /**
+     * @brief Applies patch batch and returns its inverse
+     * @param batch `OptocRoot`
+     * @param patch_batch Patched batch
+     * @return Patched batch with the same position and the replaced trees
+     *
+     * @throws Same as `apply(OptocRoot&, const OptocPatchBatch&)`
+     */
+    static OptocPatchBatch apply_with_inverse(OptocRoot& batch, const OptocPatchBatch& patch_batch);
+
+    /**
+     * @brief Applies patch to world and returns its inverse. Replaced trees are moved into the
+     * inverse, so the world is passed once and no tree is copied
+     * @param world Batches of world
+     * @param patch `OptocPatchRoot`
+     * @return Inverse patch with the same version
+     *
+     * @throws Same as `apply(OptocWorld&, const OptocPatchRoot&)`
+     */
+    static OptocPatchRoot apply_with_inverse(OptocWorld& world, const OptocPatchRoot& patch);
+
+    /**
+     * @brief Applies patch to world and returns its inverse
+     * @param world Batches of world
+     * @param patch `OptocPatchRoot`
+     * @return Inverse patch with the same version
+     *
+     * @throws Same as `apply(OptocWorld&, const OptocPatchRoot&)`
+     */
+    static OptocPatchRoot apply_with_inverse(WorldIndex& world, const OptocPatchRoot& patch);
+
+    /**
+     * @brief Builds inverse of patch without applying it
+     * @param world Batches of world before the patch
+     * @param patch `OptocPatchRoot`
+     * @return Inverse patch with the same version
+     *
+     * @throws Same as `apply(OptocWorld&, const OptocPatchRoot&)`
+     */
+    static OptocPatchRoot make_inverse(const OptocWorld& world, const OptocPatchRoot& patch);
+
+    /**
+     * @brief Builds inverse of patch without applying it
+     * @param world Batches of world before the patch
+     * @param patch `OptocPatchRoot`
+     * @return Inverse patch with the same version
+     *
+     * @throws Same as `apply(OptocWorld&, const OptocPatchRoot&)`
+     */
+    static OptocPatchRoot make_inverse(const WorldIndex& world, const OptocPatchRoot& patch);
+
+  private:
+    /**
+     * @brief Coordinate of patched batch
+     * @param patch_batch Patched batch
+     * @return `OptocBatchCoordinate`
+     */
+    static OptocBatchCoordinate coordinate_of(const OptocPatchBatch& patch_batch);
+
+    /**
+     * @brief Checks that every tree of patch batch exists in batch
+     * @param batch `OptocRoot`
+     * @param patch_batch Patched batch
+     *
+     * @throws `std::out_of_range` when:
+     * - octree number of patch tree is not less than count of trees of `batch`
+     */
+    static void validate(const OptocRoot& batch, const OptocPatchBatch& patch_batch);
+
+    /**
+     * @brief Finds batch of patch batch in world
+     * @tparam World `OptocWorld` or `WorldIndex`, possibly const
+     * @param world Batches of world
+     * @param patch_batch Patched batch
+     * @return Batch
+     *
+     * @throws `std::out_of_range` when:
+     * - batch is absent from `world`
+     */
+    template <class World>
+    static auto& find_batch(World& world, const OptocPatchBatch& patch_batch);
+
+    /**
+     * @brief `apply` for any world
+     * @tparam World `OptocWorld` or `WorldIndex`
+     * @param world Batches of world
+     * @param patch `OptocPatchRoot`
+     */
+    template <class World> static void apply_world(World& world, const OptocPatchRoot& patch);
+
+    /**
+     * @brief `apply_with_inverse` for any world
+     * @tparam World `OptocWorld` or `WorldIndex`
+     * @param world Batches of world
+     * @param patch `OptocPatchRoot`
+     * @return Inverse patch
+     */
+    template <class World>
+    static OptocPatchRoot apply_world_with_inverse(World& world, const OptocPatchRoot& patch);
+
+    /**
+     * @brief `make_inverse` for any world
+     * @tparam World `OptocWorld` or `WorldIndex`
+     * @param world Batches of world before the patch
+     * @param patch `OptocPatchRoot`
+     * @return Inverse patch
+     */
+    template <class World>
+    static OptocPatchRoot make_world_inverse(const World& world, const OptocPatchRoot& patch);
+
+    /**
+     * @brief Applies validated patch batch and moves replaced trees into its inverse
+     * @param batch `OptocRoot`
+     * @param patch_batch Patched batch
+     * @param touched Trees of `batch` already replaced by this patch. Their originals are already
+     * in another inverse batch, so they are not added again
+     * @return Inverse batch
+     */
+    static OptocPatchBatch apply_batch(OptocRoot&             batch,
+                                       const OptocPatchBatch& patch_batch,
+                                       std::bitset<256>&      touched);
+};
+
+} // namespace optoctreeparser
@@ -0,0 +1,152 @@
+/**
+ * @brief Ray casting against batches and worlds
+ *
+ * @copyright maksimshchavelev © 2025 maksimshchavelev@gmail.com
+ * @license MIT
+ */
+
+#pragma once
+
+#include "base_struct/base_struct.hpp"
+#include "octree/octree.hpp"
+#include "world_index/world_index.hpp"
+#include <limits>
+#include <optional>
+#include <span>
+
+namespace optoctreeparser {
+
+/**
+ * @brief Ray in voxel space
+ */
+struct OptocRay {
+    OptocPoint origin;    ///< Start of ray
+    OptocPoint direction; ///< Direction of ray. Does not have to be normalized, must not be zero
+
+    bool operator==(const OptocRay& other) const = default;
+};
+
+
+/**
+ * @brief The first non-empty leaf hit by a ray
+ */
+struct OptocRayHit {
+    float                distance;        ///< Distance from origin of ray to hit, in voxels
+    OptocPoint           position;        ///< Point where ray enters the leaf
+    OptocBatchCoordinate batch;           ///< Batch of hit. `{0, 0, 0}` for a single batch
+    std::size_t          tree;            ///< Index of tree in `OptocRoot::trees`
+    byte                 material_type;   ///< Material of leaf
+    byte                 signed_distance; ///< Encoded signed distance of leaf
+
+    bool operator==(const OptocRayHit& other) const = default;
+};
+
+
+/**
+ * @brief Casts rays against batches and worlds
+ *
+ * Rays step from tree to tree (3D DDA over cubes of `Octree::tree_size`) and descend into every
+ * tree front to back, so one empty leaf skips its whole cube at once. A hit is the first leaf
+ * with material other than 0. A ray that starts inside a solid leaf hits it at distance 0.
+ *
+ * Batch `{x, y, z}` of a world covers `[x * Octree::batch_size, (x + 1) * Octree::batch_size)`
+ * along X in world voxel space, and the same along Y and Z. A world is either `OptocWorld` or
+ * `WorldIndex`.
+ *
+ * @code{.cpp}
+ * auto hit = Raycaster::cast(batch, {.origin = {0.5f, 150.0f, 0.5f}, .direction = {0, -1, 0}});
+ * if (hit && hit->material_type == 37) {
+ *     // sand below
+ * }
+ * @endcode
+ */
+class Raycaster {
+  public:
+    static constexpr float infinity = std::numeric_limits<float>::infinity(); ///< No limit
+
+    /**
+     * @brief Casts ray against batch
+     * @param batch `OptocRoot`, its origin is at `{0, 0, 0}`
+     * @param ray `OptocRay`
+     * @param max_distance Hits farther than this are ignored
+     * @return `OptocRayHit` or `std::nullopt`
+     *
+     * @throws `std::invalid_argument` when:
+     * - direction of ray is zero
+     */
+    static std::optional<OptocRayHit>
+    cast(const OptocRoot& batch, const OptocRay& ray, float max_distance = infinity);
+
+    /**
+     * @brief Casts ray against world
+     * @param world Batches of world
+     * @param ray `OptocRay` in world voxel space
+     * @param max_distance Hits farther than this are ignored. Must be finite
+     * @return `OptocRayHit` or `std::nullopt`
+     *
+     * @throws `std::invalid_argument` when:
+     * - direction of ray is zero
+     * - `max_distance` is not finite
+     */
+    static std::optional<OptocRayHit>
+    cast(const OptocWorld& world, const OptocRay& ray, float max_distance);
+
+    /**
+     * @brief Casts ray against world
+     * @param world Batches of world
+     * @param ray `OptocRay` in world voxel space
+     * @param max_distance Hits farther than this are ignored. Must be finite
+     * @return `OptocRayHit` or `std::nullopt`
+     *
+     * @throws Same as `cast(const OptocWorld&, const OptocRay&, float)`
+     */
+    static std::optional<OptocRayHit>
+    cast(const WorldIndex& world, const OptocRay& ray, float max_distance);
+
+    /**
+     * @brief Casts many rays against batch in parallel
+     * @param batch `OptocRoot`
+     * @param rays Rays
+     * @param max_distance Hits farther than this are ignored
+     * @param thread_count Count of threads. `0` means hardware concurrency
+     * @return Hit of every ray, in the same order as `rays`
+     *
+     * @throws Same as `cast(const OptocRoot&, const OptocRay&, float)`
+     */
+    static std::vector<std::optional<OptocRayHit>> cast(const OptocRoot&          batch,
+                                                        std::span<const OptocRay> rays,
+                                                        float       max_distance = infinity,
+                                                        std::size_t thread_count = 0);
+
+    /**
+     * @brief Casts many rays against world in parallel
+     * @param world Batches of world
+     * @param rays Rays in world voxel space
+     * @param max_distance Hits farther than this are ignored. Must be finite
+     * @param thread_count Count of threads. `0` means hardware concurrency
+     * @return Hit of every ray, in the same order as `rays`
+     *
+     * @throws Same as `cast(const OptocWorld&, const OptocRay&, float)`
+     */
+    static std::vector<std::optional<OptocRayHit>> cast(const OptocWorld&         world,
+                                                        std::span<const OptocRay> rays,
+                                                        float                     max_distance,
+                                                        std::size_t thread_count = 0);
+
+    /**
+     * @brief Casts many rays against world in parallel
+     * @param world Batches of world
+     * @param rays Rays in world voxel space
+     * @param max_distance Hits farther than this are ignored. Must be finite
+     * @param thread_count Count of threads. `0` means hardware concurrency
+     * @return Hit of every ray, in the same order as `rays`
+     *
+     * @throws Same as `cast(const OptocWorld&, const OptocRay&, float)`
+     */
+    static std::vector<std::optional<OptocRayHit>> cast(const WorldIndex&         world,
+                                                        std::span<const OptocRay> rays,
+                                                        float                     max_distance,
+                                                        std::size_t thread_count = 0);
+};
+
+} // namespace optoctreeparser
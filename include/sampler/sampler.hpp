@@ -0,0 +1,128 @@
+/**
+ * @brief Sampling of signed distance and material across batch borders
+ *
+ * @copyright maksimshchavelev © 2025 maksimshchavelev@gmail.com
+ * @license MIT
+ */
+
+#pragma once
+
+#include "octree/octree.hpp"
+#include "world_index/world_index.hpp"
+#include <array>
+
+namespace optoctreeparser {
+
+/**
+ * @brief Samples a world as one continuous field, ignoring borders of batches and trees
+ *
+ * Batch `{x, y, z}` covers `[x * Octree::batch_size, (x + 1) * Octree::batch_size)` along X in
+ * world voxel space, and the same along Y and Z. Voxel `{x, y, z}` covers `[x, x + 1)` and its
+ * value is at its center, so `distance` interpolates between the centers of the 8 nearest voxels,
+ * wherever they are. Absent batches, batches outside of int16 range (where `WorldIndex` stores
+ * none) and trees without nodes are empty space.
+ *
+ * The sampler keeps the 27 batches around the last sampled one and a small cache of recently
+ * touched leaves, so neighbouring samples rarely walk a tree. It is not thread-safe: create one
+ * sampler per thread, they are cheap.
+ *
+ * @code{.cpp}
+ * Sampler sampler(world);
+ * float d = sampler.distance({159.7f, 20.2f, 33.0f}); // mixes batches {0, 0, 0} and {1, 0, 0}
+ * @endcode
+ *
+ * @note Call `reset` after `world` is modified, batches may have moved
+ */
+class Sampler {
+  public:
+    /**
+     * @brief Creates sampler
+     * @param world Batches of world. Must outlive the sampler
+     */
+    explicit Sampler(const WorldIndex& world);
+
+    /**
+     * @brief Signed distance at point, trilinearly interpolated between voxel centers
+     * @param point Point in world voxel space
+     * @return Decoded distance (see `SignedDistance::decode`). Positive above the surface
+     */
+    float distance(const OptocPoint& point);
+
+    /**
+     * @brief Signed distance of voxel
+     * @param voxel Voxel in world voxel space
+     * @return Decoded distance of the leaf that contains voxel
+     */
+    float voxel_distance(const OptocVoxel& voxel);
+
+    /**
+     * @brief Material of voxel
+     * @param voxel Voxel in world voxel space
+     * @return Material of the leaf that contains voxel. 0 for empty space
+     */
+    byte material(const OptocVoxel& voxel);
+
+    /**
+     * @brief Forgets cached batches and leaves
+     */
+    void reset();
+
+    /**
+     * @brief Count of voxel lookups answered by the leaf cache
+     * @return Count of cache hits since creation or `reset`
+     */
+    std::size_t cache_hits() const;
+
+    /**
+     * @brief Count of voxel lookups that walked a tree
+     * @return Count of cache misses since creation or `reset`
+     */
+    std::size_t cache_misses() const;
+
+  private:
+    static constexpr std::size_t cache_size = 16; ///< Count of cached leaves
+
+    /**
+     * @brief Leaf in world voxel space
+     */
+    struct CachedLeaf {
+        OptocVoxel origin;          ///< First voxel of leaf
+        int32_t    size;            ///< Edge of leaf in voxels, 0 for an unused entry
+        byte       material_type;   ///< Material of leaf
+        byte       signed_distance; ///< Encoded signed distance of leaf
+    };
+
+    const WorldIndex&                  world_;
+    OptocBatchCoordinate               center_;
+    OptocNeighbourhood                 window_;
+    bool                               has_window_;
+    std::array<CachedLeaf, cache_size> cache_;
+    std::size_t                        last_;
+    std::size_t                        next_;
+    std::size_t                        hits_;
+    std::size_t                        misses_;
+
+    /**
+     * @brief Finds leaf that contains voxel, through the cache
+     * @param voxel Voxel in world voxel space
+     * @return Leaf. Voxels of batches outside of int16 range are empty space and return at once
+     */
+    const CachedLeaf& leaf_at(const OptocVoxel& voxel);
+
+    /**
+     * @brief Finds batch through the window of neighbouring batches, moving it if needed
+     * @param coordinate Coordinate of batch
+     * @return Batch or `nullptr`
+     */
+    const OptocRoot* batch_at(const OptocBatchCoordinate& coordinate);
+
+    /**
+     * @brief Floor division
+     * @param value Dividend
+     * @param divisor Positive divisor
+     * @return Quotient rounded down
+     */
+    static int64_t floor_div(int64_t value, int64_t divisor);
+};
+
+} // namespace optoctreeparser
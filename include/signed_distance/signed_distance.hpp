@@ -0,0 +1,46 @@
+/**
+ * @brief Conversion of `OptocNode::signed_distance` to a number and back
+ *
+ * @copyright maksimshchavelev © 2025 maksimshchavelev@gmail.com
+ * @license MIT
+ */
+
+#pragma once
+
+#include "base_struct/base_struct.hpp"
+
+namespace optoctreeparser {
+
+/**
+ * @brief Conversion of `OptocNode::signed_distance` to a number and back
+ *
+ * Encoded values 1–125 are above the surface, 126 is on the surface, 127–252 are below it.
+ * Decoded distance is `126 - value`, so it is positive above the surface (outside of the terrain)
+ * and negative below it, like in a usual SDF. Encoded 0 means "completely solid" for non-empty
+ * material and "completely empty" for material 0.
+ */
+class SignedDistance {
+  public:
+    static constexpr byte  surface = 126;      ///< Encoded value on the surface
+    static constexpr byte  min_encoded = 1;    ///< Encoded value farthest above the surface
+    static constexpr byte  max_encoded = 252;  ///< Encoded value farthest below the surface
+    static constexpr float max_outside = 125;  ///< Decoded distance of `min_encoded`
+    static constexpr float max_inside = -126;  ///< Decoded distance of `max_encoded`
+
+    /**
+     * @brief Decodes signed distance
+     * @param signed_distance Encoded signed distance
+     * @param material_type Material of node. Used to decode 0
+     * @return Distance to the surface. Positive above the surface
+     */
+    static float decode(byte signed_distance, byte material_type);
+
+    /**
+     * @brief Encodes signed distance
+     * @param distance Distance to the surface. Positive above the surface
+     * @return Encoded signed distance in range 1–252
+     */
+    static byte encode(float distance);
+};
+
+} // namespace optoctreeparser
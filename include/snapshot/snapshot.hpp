@@ -0,0 +1,148 @@
+/**
+ * @brief Persistent copy-on-write batch with structurally shared trees
+ *
+ * @copyright maksimshchavelev © 2025 maksimshchavelev@gmail.com
+ * @license MIT
+ */
+
+#pragma once
+
+#include "base_struct/base_struct.hpp"
+#include <memory>
+#include <span>
+
+namespace optoctreeparser {
+
+/**
+ * @brief Persistent copy-on-write batch
+ *
+ * Trees are immutable and reference counted, so copying a `Snapshot` is O(1) and copies share all
+ * trees. Mutating a tree of a snapshot copies only that tree (and the array of 125 pointers, if it
+ * is shared), other snapshots are not affected.
+ *
+ * @section example_usage Example usage
+ *
+ * @code{.cpp}
+ * Snapshot current(Parser::parse_optoctree_batch(view));
+ * std::vector<Snapshot> undo;
+ *
+ * undo.push_back(current);                             // O(1)
+ * current.mutable_tree(12).nodes[0].material_type = 37; // copies only tree 12
+ *
+ * auto changed = Differ::find_difference(undo.back(), current); // 124 trees skipped by pointer
+ * @endcode
+ *
+ * @note One `Snapshot` object must not be mutated concurrently with any other access to it.
+ * Different copies can be used from different threads: a shared tree is copied unless this
+ * snapshot is its only owner, and the last release by another thread is ordered before the
+ * mutation (see `is_unique`). `std::weak_ptr` to trees must not be locked concurrently with
+ * mutation, as that could make a uniquely owned tree shared again
+ */
+class Snapshot {
+  public:
+    using TreePointer = std::shared_ptr<const OptocTree>; ///< Shared immutable tree
+
+    /**
+     * @brief Creates empty snapshot
+     */
+    Snapshot();
+
+    /**
+     * @brief Creates snapshot from batch
+     * @param root `OptocRoot`. Its trees are moved into the snapshot
+     */
+    explicit Snapshot(OptocRoot root);
+
+    /**
+     * @brief Converts snapshot to plain batch
+     * @return `OptocRoot` with copies of trees
+     */
+    OptocRoot to_root() const;
+
+    /**
+     * @brief Version of batch
+     * @return Version
+     */
+    int32_t version() const;
+
+    /**
+     * @brief Sets version of batch
+     * @param version Version
+     */
+    void set_version(int32_t version);
+
+    /**
+     * @brief Count of trees
+     * @return Count of trees
+     */
+    std::size_t size() const;
+
+    /**
+     * @brief Immutable access to tree
+     * @param index Index of tree
+     * @return `OptocTree`
+     */
+    const OptocTree& tree(std::size_t index) const;
+
+    /**
+     * @brief Shared pointer to tree
+     * @param index Index of tree
+     * @return `TreePointer`. Equal pointers mean equal trees
+     */
+    const TreePointer& tree_pointer(std::size_t index) const;
+
+    /**
+     * @brief Mutable access to tree. Copies the tree if it is shared with another snapshot
+     * @param index Index of tree
+     * @return `OptocTree` owned only by this snapshot. Valid until the snapshot is copied
+     */
+    OptocTree& mutable_tree(std::size_t index);
+
+    /**
+     * @brief Replaces tree
+     * @param index Index of tree
+     * @param tree New tree
+     */
+    void set_tree(std::size_t index, OptocTree tree);
+
+    /**
+     * @brief Makes identical trees of snapshots share memory
+     * @param snapshots Snapshots (for example, all batches of a world or a whole undo history)
+     * @return Count of trees that became shared
+     *
+     * @note Trees are grouped by `Hasher::hash_tree` and compared before sharing
+     */
+    static std::size_t deduplicate(std::span<Snapshot> snapshots);
+
+  private:
+    using Trees = std::vector<TreePointer>;
+
+    int32_t                      version_;
+    std::shared_ptr<const Trees> trees_;
+
+    /**
+     * @brief Checks that `pointer` is the only owner of its object, so it can be mutated in place
+     * @param pointer Pointer owned by this snapshot
+     * @return `true` if use count is 1
+     *
+     * @note `use_count` is a relaxed load. The acquire fence after it synchronizes with the
+     * release decrement of the last other owner, so its reads of the object happen before our
+     * writes. The count can not grow concurrently: only this snapshot holds the pointer
+     */
+    template <typename T> static bool is_unique(const std::shared_ptr<T>& pointer);
+
+    /**
+     * @brief Makes array of tree pointers owned only by this snapshot
+     * @return Mutable array of tree pointers
+     */
+    Trees& own_trees();
+
+    /**
+     * @brief Replaces tree with tree of another snapshot
+     * @param index Index of tree
+     * @param tree New tree
+     */
+    void set_tree(std::size_t index, TreePointer tree);
+};
+
+} // namespace optoctreeparser
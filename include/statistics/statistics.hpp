@@ -0,0 +1,105 @@
+/**
+ * @brief Histograms and counters of materials, distances and tree shapes
+ *
+ * @copyright maksimshchavelev © 2025 maksimshchavelev@gmail.com
+ * @license MIT
+ */
+
+#pragma once
+
+#include "base_struct/base_struct.hpp"
+#include <array>
+#include <span>
+
+namespace optoctreeparser {
+
+/**
+ * @brief Statistics of a tree, batch or world
+ */
+struct OptocStatistics {
+    uint64_t                  tree_count;      ///< Count of trees
+    uint64_t                  leaf_count;      ///< Count of leaves
+    uint64_t                  inner_count;     ///< Count of inner nodes
+    std::array<uint64_t, 256> material_leaves; ///< Count of leaves of every material
+    std::array<double, 256>   material_volume; ///< Volume of every material in voxels
+    std::array<uint64_t, 256> distance_leaves; ///< Count of leaves of every encoded distance
+    std::vector<uint64_t>     tree_depths;     ///< Count of trees of every depth
+    std::vector<uint64_t>     leaf_depths;     ///< Count of leaves at every depth
+
+    bool operator==(const OptocStatistics& other) const = default;
+};
+
+
+/**
+ * @brief Computes `OptocStatistics`
+ *
+ * Trees are walked with `Octree` rules, so only reachable nodes are counted. A leaf at depth `d`
+ * has volume `(Octree::tree_size >> d)³` voxels.
+ *
+ * @section example_usage Example usage
+ *
+ * @code{.cpp}
+ * OptocStatistics world = Statistics::of_world(batches);
+ * double sand_volume = world.material_volume[37];
+ * @endcode
+ */
+class Statistics {
+  public:
+    /**
+     * @brief Computes statistics of tree
+     * @param tree `OptocTree`
+     * @return `OptocStatistics`
+     */
+    static OptocStatistics of_tree(const OptocTree& tree);
+
+    /**
+     * @brief Computes statistics of batch
+     * @param batch `OptocRoot`
+     * @return `OptocStatistics`
+     */
+    static OptocStatistics of_batch(const OptocRoot& batch);
+
+    /**
+     * @brief Computes statistics of every batch in parallel
+     * @param batches Batches
+     * @param thread_count Count of threads. 0 means hardware concurrency
+     * @return Statistics of every batch in the same order
+     */
+    static std::vector<OptocStatistics> of_batches(std::span<const OptocRoot> batches,
+                                                   std::size_t                thread_count = 0);
+
+    /**
+     * @brief Computes statistics of all batches together in parallel
+     * @param batches Batches
+     * @param thread_count Count of threads. 0 means hardware concurrency
+     * @return `OptocStatistics` of the whole world
+     */
+    static OptocStatistics of_world(std::span<const OptocRoot> batches,
+                                    std::size_t                thread_count = 0);
+
+    /**
+     * @brief Adds statistics to another statistics
+     * @param into Statistics to add to
+     * @param from Statistics to add
+     */
+    static void merge(OptocStatistics& into, const OptocStatistics& from);
+
+  private:
+    struct Histograms; // Defined in statistics.cpp
+
+    /**
+     * @brief Walks tree and adds its nodes to histograms
+     * @param tree `OptocTree`
+     * @param histograms Histograms to add to
+     */
+    static void accumulate(const OptocTree& tree, Histograms& histograms);
+
+    /**
+     * @brief Sums sub-histograms into statistics
+     * @param histograms Histograms. Left in moved-from state
+     * @return `OptocStatistics`
+     */
+    static OptocStatistics reduce(Histograms& histograms);
+};
+
+} // namespace optoctreeparser
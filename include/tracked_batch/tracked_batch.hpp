@@ -0,0 +1,149 @@
+/**
+ * @brief Batch that remembers its encoded bytes and which trees changed
+ *
+ * @copyright maksimshchavelev © 2025 maksimshchavelev@gmail.com
+ * @license MIT
+ */
+
+#pragma once
+
+#include "base_struct/base_struct.hpp"
+#include "octree/octree.hpp"
+#include <array>
+#include <bitset>
+
+namespace optoctreeparser {
+
+/**
+ * @brief Parsed batch together with the bytes it was parsed from and a dirty bit per tree
+ *
+ * Trees changed through `mutable_tree` or `set_tree` are dirty. `pack` copies the encoded bytes of
+ * clean trees straight from the source buffer and encodes only the dirty ones, so saving a batch
+ * with one edited tree costs about one `memcpy` of the file. The result is the same as of
+ * `Parser::pack_optoctree_batch`.
+ *
+ * @section example_usage Example usage
+ *
+ * @code{.cpp}
+ * TrackedBatch batch(Reader::optoctreeview_from_file(path));
+ * batch.mutable_tree(42).nodes[0].material_type = 37;
+ * Writer::optoctreeview_to_file(path, batch.repack()); // only tree 42 is encoded
+ * @endcode
+ */
+class TrackedBatch {
+  public:
+    /**
+     * @brief Parses batch and keeps its bytes. All trees are clean
+     * @param source Byte representation of optoctree
+     *
+     * @throws `std::out_of_range` when:
+     * - source ends before all declared trees and nodes are read
+     */
+    explicit TrackedBatch(OptocTreeView source);
+
+    /**
+     * @brief Encodes batch and keeps the bytes. All trees are clean
+     * @param root `OptocRoot`
+     *
+     * @throws `std::invalid_argument` when:
+     * - `root` does not have `Octree::trees_per_batch` trees
+     */
+    explicit TrackedBatch(OptocRoot root);
+
+    /**
+     * @brief Parsed batch with all changes
+     * @return `OptocRoot`
+     */
+    const OptocRoot& root() const;
+
+    /**
+     * @brief Bytes of batch as they were after construction or the last `repack`
+     * @return Byte representation of optoctree
+     */
+    const OptocTreeView& source() const;
+
+    /**
+     * @brief Version of batch
+     * @return Version
+     */
+    int32_t version() const;
+
+    /**
+     * @brief Sets version of batch. Version is always written, so no tree becomes dirty
+     * @param version Version
+     */
+    void set_version(int32_t version);
+
+    /**
+     * @brief Gets tree
+     * @param index Index of tree
+     * @return Tree
+     *
+     * @throws `std::out_of_range` when:
+     * - `index` is not less than `Octree::trees_per_batch`
+     */
+    const OptocTree& tree(std::size_t index) const;
+
+    /**
+     * @brief Gets tree for modification and marks it dirty
+     * @param index Index of tree
+     * @return Tree
+     *
+     * @throws `std::out_of_range` when:
+     * - `index` is not less than `Octree::trees_per_batch`
+     */
+    OptocTree& mutable_tree(std::size_t index);
+
+    /**
+     * @brief Replaces tree and marks it dirty
+     * @param index Index of tree
+     * @param tree New tree
+     *
+     * @throws `std::out_of_range` when:
+     * - `index` is not less than `Octree::trees_per_batch`
+     */
+    void set_tree(std::size_t index, OptocTree tree);
+
+    /**
+     * @brief Checks whether tree was changed since construction or the last `repack`
+     * @param index Index of tree
+     * @return `true` if tree is dirty
+     */
+    bool is_dirty(std::size_t index) const;
+
+    /**
+     * @brief Count of dirty trees
+     * @return Count of trees changed since construction or the last `repack`
+     */
+    std::size_t dirty_count() const;
+
+    /**
+     * @brief Encodes batch, re-encoding only dirty trees
+     * @return Byte representation of optoctree, equal to `Parser::pack_optoctree_batch(root())`
+     */
+    OptocTreeView pack() const;
+
+    /**
+     * @brief Encodes batch like `pack`, keeps the result as the new source and marks all trees
+     * clean
+     * @return New source
+     */
+    const OptocTreeView& repack();
+
+  private:
+    OptocRoot                                            root_;    ///< Parsed batch with changes
+    OptocTreeView                                        source_;  ///< Bytes of clean trees
+    std::array<std::size_t, Octree::trees_per_batch + 1> offsets_; ///< Tree starts in `source_`
+    std::bitset<Octree::trees_per_batch>                 dirty_;   ///< Trees newer than `source_`
+
+    /**
+     * @brief Checks index of tree
+     * @param index Index of tree
+     *
+     * @throws `std::out_of_range` when:
+     * - `index` is not less than `Octree::trees_per_batch`
+     */
+    static void check_index(std::size_t index);
+};
+
+} // namespace optoctreeparser
@@ -0,0 +1,221 @@
+/**
+ * @brief Sparse hash index of the batches of a world
+ *
+ * @copyright maksimshchavelev © 2025 maksimshchavelev@gmail.com
+ * @license MIT
+ */
+
+#pragma once
+
+#include "base_struct/base_struct.hpp"
+#include "octree/octree.hpp"
+#include <array>
+#include <functional>
+#include <optional>
+#include <span>
+
+namespace optoctreeparser {
+
+/**
+ * @brief Which neighbours of batch to visit
+ */
+enum class Connectivity {
+    six,       ///< Batches sharing a face
+    twenty_six ///< Batches sharing a face, an edge or a corner
+};
+
+
+/**
+ * @brief Batch and its 26 neighbours. Batch `{dx, dy, dz}` from the center (every offset is
+ * -1, 0 or 1) is at `(dx + 1) + 3 * (dy + 1) + 9 * (dz + 1)`, the center is at 13. Absent
+ * batches are `nullptr`
+ */
+using OptocNeighbourhood = std::array<const OptocRoot*, 27>;
+
+
+/**
+ * @brief Open-addressing hash map from batch coordinate to `OptocRoot`
+ *
+ * Coordinates are packed into 48 bits (three int16, the same range as in `.optoctreepatch`) and
+ * stored in a linear-probing table kept at most half full, so a lookup is usually one probe.
+ * Batches are stored densely in insertion order (erasing moves the last batch into the hole),
+ * so iterating over all of them is a walk over one array.
+ *
+ * @section example_usage Example usage
+ *
+ * @code{.cpp}
+ * WorldIndex world;
+ * world.insert({12, 18, 10}, Parser::parse_optoctree_batch(view));
+ *
+ * world.for_each_neighbour({12, 18, 10}, Connectivity::six, [](const auto& at, const auto& batch) {
+ *     fix_seam(at, batch);
+ * });
+ *
+ * for (const auto& coordinate : world.region({0, 0, 0}, {15, 15, 15})) {
+ *     mesh(*world.find(coordinate)); // Neighbouring batches come one after another
+ * }
+ * @endcode
+ *
+ * @note Pointers and references to batches are invalidated by `insert` and `erase`
+ */
+class WorldIndex {
+  public:
+    /**
+     * @brief Creates empty index
+     * @param capacity Count of batches to reserve space for
+     */
+    explicit WorldIndex(std::size_t capacity = 0);
+
+    /**
+     * @brief Inserts batch or replaces the batch at the same coordinate
+     * @param coordinate Coordinate of batch
+     * @param batch `OptocRoot`
+     * @return Inserted batch
+     *
+     * @throws `std::out_of_range` when:
+     * - coordinate does not fit into int16
+     */
+    OptocRoot& insert(const OptocBatchCoordinate& coordinate, OptocRoot batch);
+
+    /**
+     * @brief Finds batch
+     * @param coordinate Coordinate of batch
+     * @return Pointer to batch or `nullptr`
+     */
+    OptocRoot* find(const OptocBatchCoordinate& coordinate);
+
+    /**
+     * @brief Finds batch
+     * @param coordinate Coordinate of batch
+     * @return Pointer to batch or `nullptr`
+     */
+    const OptocRoot* find(const OptocBatchCoordinate& coordinate) const;
+
+    /**
+     * @brief Removes batch
+     * @param coordinate Coordinate of batch
+     * @return `true` if there was a batch
+     */
+    bool erase(const OptocBatchCoordinate& coordinate);
+
+    /**
+     * @brief Count of batches
+     * @return Count of batches
+     */
+    std::size_t size() const;
+
+    /**
+     * @brief Reserves space for batches
+     * @param capacity Count of batches
+     */
+    void reserve(std::size_t capacity);
+
+    /**
+     * @brief Coordinates of all batches, in the same order as `batches`
+     * @return Coordinates
+     */
+    std::span<const OptocBatchCoordinate> coordinates() const;
+
+    /**
+     * @brief All batches, in the same order as `coordinates`
+     * @return Batches
+     */
+    std::span<const OptocRoot> batches() const;
+
+    /**
+     * @brief Batch and all its neighbours in 27 lookups
+     * @param coordinate Coordinate of the center batch. Any coordinate is accepted
+     * @return `OptocNeighbourhood`. Neighbours outside of int16 range are `nullptr`
+     */
+    OptocNeighbourhood neighbourhood(const OptocBatchCoordinate& coordinate) const;
+
+    /**
+     * @brief Calls function for every present neighbour of batch
+     * @param coordinate Coordinate of batch. The batch itself does not have to be present and any
+     * coordinate is accepted, neighbours outside of int16 range are skipped
+     * @param connectivity Which neighbours to visit
+     * @param function Function called with coordinate and batch of every neighbour
+     */
+    void for_each_neighbour(
+        const OptocBatchCoordinate&                                                coordinate,
+        Connectivity                                                               connectivity,
+        const std::function<void(const OptocBatchCoordinate&, const OptocRoot&)>& function) const;
+
+    /**
+     * @brief Coordinates of present batches inside box, in Morton order
+     * @param min Minimal corner of box (inclusive)
+     * @param max Maximal corner of box (inclusive)
+     * @return Coordinates sorted by Morton code of their offset from `min`. The box is clamped to
+     * the int16 range of coordinates first, so any `min` and `max` are accepted
+     */
+    std::vector<OptocBatchCoordinate> region(const OptocBatchCoordinate& min,
+                                             const OptocBatchCoordinate& max) const;
+
+  private:
+    static constexpr uint64_t empty_key = UINT64_MAX; ///< Key of free slot
+
+    /**
+     * @brief Slot of hash table
+     */
+    struct Slot {
+        uint64_t    key;   ///< Packed coordinate or `empty_key`
+        std::size_t index; ///< Index in `batches_`
+    };
+
+    std::vector<Slot>                 slots_;
+    std::vector<OptocBatchCoordinate> coordinates_;
+    std::vector<OptocRoot>            batches_;
+
+    /**
+     * @brief Packs coordinate into 48 bits
+     * @param coordinate Coordinate
+     * @return Key. Coordinates outside of int16 give `empty_key`
+     */
+    static uint64_t pack(const OptocBatchCoordinate& coordinate);
+
+    /**
+     * @brief Coordinate of neighbour
+     * @param coordinate Coordinate of batch
+     * @param dx X offset
+     * @param dy Y offset
+     * @param dz Z offset
+     * @return Coordinate of neighbour or `std::nullopt` when it is outside of int16, where no
+     * batch can be
+     */
+    static std::optional<OptocBatchCoordinate> neighbour_of(const OptocBatchCoordinate& coordinate,
+                                                            int32_t                     dx,
+                                                            int32_t                     dy,
+                                                            int32_t                     dz);
+
+    /**
+     * @brief Home slot of key
+     * @param key Packed coordinate
+     * @param mask Capacity of table - 1
+     * @return Index of slot
+     */
+    static std::size_t home(uint64_t key, std::size_t mask);
+
+    /**
+     * @brief Interleaves bits of offsets
+     * @param x X offset
+     * @param y Y offset
+     * @param z Z offset
+     * @return Morton code
+     */
+    static uint64_t morton_code(uint64_t x, uint64_t y, uint64_t z);
+
+    /**
+     * @brief Finds slot of key
+     * @param key Packed coordinate
+     * @return Index of slot with the key or of the free slot where it would be
+     */
+    std::size_t find_slot(uint64_t key) const;
+
+    /**
+     * @brief Rebuilds table with new capacity
+     * @param capacity Count of slots, power of two
+     */
+    void rehash(std::size_t capacity);
+};
+
+} // namespace optoctreeparser
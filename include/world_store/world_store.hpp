@@ -0,0 +1,186 @@
+/**
+ * @brief Thread-safe store of the batches of a world
+ *
+ * @copyright maksimshchavelev © 2025 maksimshchavelev@gmail.com
+ * @license MIT
+ */
+
+#pragma once
+
+#include "octree/octree.hpp"
+#include "snapshot/snapshot.hpp"
+#include <atomic>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+namespace optoctreeparser {
+
+/**
+ * @brief Concurrent map from batch coordinate to the current version of batch
+ *
+ * Every batch is an immutable `Snapshot` published through an atomic pointer (RCU style):
+ * - `find` never waits for writers, readers keep the version they loaded alive for as long as
+ *   they need
+ * - `publish` swaps the pointer, readers of the previous version are not blocked or affected
+ * - `update` copies the current version (O(1), trees are shared), edits the copy and publishes it
+ *   only if no one else published in between, otherwise it retries with the newer version
+ *
+ * Coordinates are spread over shards. A shard keeps an immutable map of its coordinates, which
+ * is copied only when a new coordinate is added, so adding batches of one shard is the only
+ * operation that serializes writers, and it never blocks readers. Coordinates whose batch was
+ * erased are dropped from the map at its next copy, so the maps do not grow under churn.
+ *
+ * @note Pointers are loaded through `std::atomic<std::shared_ptr>`, which is not lock-free in
+ * common standard libraries (libstdc++ guards every access with a short internal spin lock).
+ * Reads therefore never wait on a mutex or for a copy of a map, but they are not lock-free in
+ * the strict sense
+ *
+ * @section example_usage Example usage
+ *
+ * @code{.cpp}
+ * WorldStore world;
+ * world.publish({0, 0, 0}, Snapshot(Parser::parse_optoctree_batch(view)));
+ *
+ * // Player thread
+ * world.update({0, 0, 0}, [](Snapshot& batch) {
+ *     batch.mutable_tree(7).nodes[0].material_type = 37;
+ * });
+ *
+ * // Save thread, sees a consistent version of every batch without stopping the players
+ * for (const auto& [coordinate, batch] : world.entries()) {
+ *     save(coordinate, batch->to_root());
+ * }
+ * @endcode
+ */
+class WorldStore {
+  public:
+    using BatchPointer = std::shared_ptr<const Snapshot>; ///< Published version of batch
+
+    /**
+     * @brief Creates empty store
+     * @param shard_count Count of shards. `0` is treated as 1
+     */
+    explicit WorldStore(std::size_t shard_count = 64);
+
+    WorldStore(const WorldStore&) = delete;
+    WorldStore& operator=(const WorldStore&) = delete;
+
+    /**
+     * @brief Current version of batch. Never waits for writers
+     * @param coordinate Coordinate of batch
+     * @return `BatchPointer` or `nullptr` if there is no batch
+     */
+    BatchPointer find(const OptocBatchCoordinate& coordinate) const;
+
+    /**
+     * @brief Publishes new version of batch. Replaces the current one unconditionally
+     * @param coordinate Coordinate of batch
+     * @param batch New version
+     * @return Published `BatchPointer`
+     */
+    BatchPointer publish(const OptocBatchCoordinate& coordinate, Snapshot batch);
+
+    /**
+     * @brief Publishes new version of batch only if the current one is still `expected`
+     * @param coordinate Coordinate of batch
+     * @param expected Version the new one is based on (`nullptr` if there was no batch)
+     * @param batch New version
+     * @return `true` if published
+     */
+    bool compare_and_publish(const OptocBatchCoordinate& coordinate,
+                             const BatchPointer&         expected,
+                             Snapshot                    batch);
+
+    /**
+     * @brief Edits batch and publishes the result. Retries if another thread published first
+     * @param coordinate Coordinate of batch
+     * @param edit Function that edits a private copy of the batch. May be called several times,
+     * so it must not have side effects other than on its argument. Gets an empty snapshot if
+     * there is no batch
+     * @return Published `BatchPointer`
+     */
+    BatchPointer update(const OptocBatchCoordinate&         coordinate,
+                        const std::function<void(Snapshot&)>& edit);
+
+    /**
+     * @brief Removes batch
+     * @param coordinate Coordinate of batch
+     * @return `true` if there was a batch
+     */
+    bool erase(const OptocBatchCoordinate& coordinate);
+
+    /**
+     * @brief Current versions of all batches. Every batch is consistent on its own
+     * @return Coordinates and versions of batches in unspecified order
+     */
+    std::vector<std::pair<OptocBatchCoordinate, BatchPointer>> entries() const;
+
+    /**
+     * @brief Count of batches
+     * @return Count of batches
+     */
+    std::size_t size() const;
+
+    /**
+     * @brief Count of coordinates in shard maps, including erased ones not dropped yet
+     * @return Count of slots
+     */
+    std::size_t slot_count() const;
+
+  private:
+    /**
+     * @brief Place of one coordinate. Dropped from the map at its next copy once it is empty.
+     * A dropped slot holds `retired()` forever, so writers that still use it find the new one
+     */
+    struct Slot {
+        std::atomic<BatchPointer> batch; ///< Current version, `nullptr` or `retired()`
+    };
+
+    using Map = std::unordered_map<OptocBatchCoordinate,
+                                   std::shared_ptr<Slot>,
+                                   OptocBatchCoordinateHash>;
+
+    /**
+     * @brief Group of coordinates with its own immutable map
+     */
+    struct Shard {
+        std::mutex                              write_mutex; ///< Serializes copies of `map`
+        std::atomic<std::shared_ptr<const Map>> map;         ///< Current map, replaced on insert
+    };
+
+    std::vector<std::unique_ptr<Shard>> shards_;
+
+    /**
+     * @brief Marker of slot dropped from the map
+     * @return Pointer that is never published
+     */
+    static const BatchPointer& retired();
+
+    /**
+     * @brief Shard of coordinate
+     * @param coordinate Coordinate of batch
+     * @return Shard
+     */
+    Shard& shard_of(const OptocBatchCoordinate& coordinate) const;
+
+    /**
+     * @brief Finds slot of coordinate without creating it
+     * @param coordinate Coordinate of batch
+     * @return Slot or `nullptr`
+     */
+    std::shared_ptr<Slot> find_slot(const OptocBatchCoordinate& coordinate) const;
+
+    /**
+     * @brief Finds slot of coordinate or creates it. Creating copies the map of shard and drops
+     * empty slots from the copy
+     * @param coordinate Coordinate of batch
+     * @return Slot
+     */
+    std::shared_ptr<Slot> make_slot(const OptocBatchCoordinate& coordinate);
+};
+
+} // namespace optoctreeparser
@@ -0,0 +1,218 @@
+/**
+ * @brief Coroutine versions of reading, parsing, packing and writing and helpers to compose them
+ *
+ * @copyright maksimshchavelev © 2025 maksimshchavelev@gmail.com
+ * @license MIT
+ */
+
+#include "async/async.hpp"
+#include "parser/parser.hpp"
+#include "reader/reader.hpp"
+#include "writer/writer.hpp"
+#include <algorithm>
+#include <atomic>
+#include <semaphore>
+
+namespace optoctreeparser {
+
+namespace {
+
+/**
+ * @brief State of one `Async::when_all`, lives in its coroutine frame
+ */
+struct WhenAllState {
+    std::atomic<std::size_t> remaining{0}; ///< Unfinished tasks + 1 for the awaiting coroutine
+    std::coroutine_handle<>  parent;       ///< Coroutine to resume when all tasks are finished
+    std::mutex               error_mutex;
+    std::exception_ptr       error; ///< The first exception of tasks
+};
+
+
+/**
+ * @brief Runs one task of `Async::when_all` and resumes the parent after the last one
+ */
+detail::DetachedTask run_one(Task<void> task, WhenAllState& state) {
+    try {
+        co_await std::move(task);
+    } catch (...) {
+        std::scoped_lock lock(state.error_mutex);
+        if (!state.error)
+            state.error = std::current_exception();
+    }
+
+    if (state.remaining.fetch_sub(1) == 1)
+        state.parent.resume();
+}
+
+
+/**
+ * @brief Starts all tasks and suspends until the last of them is finished
+ */
+struct WhenAllAwaiter {
+    std::vector<Task<void>>& tasks;
+    WhenAllState&            state;
+
+    bool await_ready() const noexcept {
+        return tasks.empty();
+    }
+
+    bool await_suspend(std::coroutine_handle<> parent) {
+        state.parent = parent;
+        state.remaining.store(tasks.size() + 1);
+
+        for (auto& task : tasks) {
+            run_one(std::move(task), state);
+        }
+
+        // If all tasks have finished synchronously, continue without suspending
+        return state.remaining.fetch_sub(1) != 1;
+    }
+
+    void await_resume() const noexcept {}
+};
+
+
+/**
+ * @brief State of one `Async::for_each`, lives in its coroutine frame
+ */
+struct ForEachState {
+    std::size_t                                  count;
+    std::function<Task<void>(std::size_t index)> function;
+    std::atomic<std::size_t>                     next{0};
+    std::atomic<bool>                            failed{false};
+};
+
+
+/**
+ * @brief One worker of `Async::for_each`. Takes indices until there are none left
+ */
+Task<void> run_items(ForEachState& state) {
+    for (std::size_t index = state.next.fetch_add(1); index < state.count && !state.failed.load();
+         index = state.next.fetch_add(1)) {
+        try {
+            co_await state.function(index);
+        } catch (...) {
+            state.failed.store(true);
+            throw;
+        }
+    }
+}
+
+
+/**
+ * @brief Runs task and signals semaphore when it is finished
+ */
+detail::DetachedTask signal_when_done(Task<void>             task,
+                                      std::binary_semaphore& done,
+                                      std::exception_ptr&    error) {
+    try {
+        co_await std::move(task);
+    } catch (...) {
+        error = std::current_exception();
+    }
+
+    done.release();
+}
+
+} // namespace
+
+
+// Static public method
+Task<OptocTreeView> Async::read(Scheduler& scheduler, std::string path) {
+    co_await scheduler.schedule();
+    co_return Reader::optoctreeview_from_file(path);
+}
+
+
+
+
+// Static public method
+Task<void> Async::write(Scheduler& scheduler, std::string path, OptocTreeView view) {
+    co_await scheduler.schedule();
+    Writer::optoctreeview_to_file(path, view);
+}
+
+
+
+
+// Static public method
+Task<OptocRoot> Async::parse_batch(Scheduler& scheduler, OptocTreeView view) {
+    co_await scheduler.schedule();
+    co_return Parser::parse_optoctree_batch(view);
+}
+
+
+
+
+// Static public method
+Task<OptocTreeView> Async::pack_batch(Scheduler& scheduler, OptocRoot batch) {
+    co_await scheduler.schedule();
+    co_return Parser::pack_optoctree_batch(batch);
+}
+
+
+
+
+// Static public method
+Task<OptocPatchRoot> Async::parse_patch(Scheduler& scheduler, OptocTreeView view) {
+    co_await scheduler.schedule();
+    co_return Parser::parse_optoctreepatch(view);
+}
+
+
+
+
+// Static public method
+Task<OptocTreeView> Async::pack_patch(Scheduler& scheduler, OptocPatchRoot patch) {
+    co_await scheduler.schedule();
+    co_return Parser::pack_optoctreepatch(patch);
+}
+
+
+
+
+// Static public method
+Task<void> Async::when_all(std::vector<Task<void>> tasks) {
+    WhenAllState state;
+    co_await WhenAllAwaiter{tasks, state};
+
+    if (state.error)
+        std::rethrow_exception(state.error);
+}
+
+
+
+
+// Static public method
+Task<void> Async::for_each(std::size_t                                  count,
+                           std::size_t                                  max_in_flight,
+                           std::function<Task<void>(std::size_t index)> function) {
+    ForEachState state{.count = count, .function = std::move(function)};
+
+    std::size_t             worker_count = std::min(std::max<std::size_t>(1, max_in_flight), count);
+    std::vector<Task<void>> workers;
+    workers.reserve(worker_count);
+
+    for (std::size_t worker = 0; worker < worker_count; ++worker) {
+        workers.push_back(run_items(state));
+    }
+
+    co_await when_all(std::move(workers));
+}
+
+
+
+
+// Static public method
+void Async::sync_wait(Task<void> task) {
+    std::binary_semaphore done{0};
+    std::exception_ptr    error;
+
+    signal_when_done(std::move(task), done, error);
+    done.acquire();
+
+    if (error)
+        std::rethrow_exception(error);
+}
+
+} // namespace optoctreeparser
@@ -0,0 +1,74 @@
+/**
+ * @brief Thread pool that resumes coroutines
+ *
+ * @copyright maksimshchavelev © 2025 maksimshchavelev@gmail.com
+ * @license MIT
+ */
+
+#include "async/scheduler.hpp"
+#include "detail/parallel.hpp"
+
+namespace optoctreeparser {
+
+// Public constructor
+Scheduler::Scheduler(std::size_t thread_count) {
+    thread_count = detail::resolve_thread_count(thread_count, SIZE_MAX);
+    threads_.reserve(thread_count);
+
+    for (std::size_t thread = 0; thread < thread_count; ++thread) {
+        threads_.emplace_back([this](std::stop_token stop) { run(stop); });
+    }
+}
+
+
+
+
+// Public method
+Scheduler::ScheduleAwaiter Scheduler::schedule() noexcept {
+    return ScheduleAwaiter{*this};
+}
+
+
+
+
+// Public method
+void Scheduler::post(std::coroutine_handle<> handle) {
+    {
+        std::scoped_lock lock(mutex_);
+        queue_.push_back(handle);
+    }
+    ready_.notify_one();
+}
+
+
+
+
+// Public method
+std::size_t Scheduler::thread_count() const {
+    return threads_.size();
+}
+
+
+
+
+// Private method
+void Scheduler::run(std::stop_token stop) {
+    while (true) {
+        std::coroutine_handle<> handle;
+
+        {
+            std::unique_lock lock(mutex_);
+            ready_.wait(lock, stop, [this]() { return !queue_.empty(); });
+
+            if (queue_.empty())
+                return; // Stop requested and nothing left to resume
+
+            handle = queue_.front();
+            queue_.pop_front();
+        }
+
+        handle.resume();
+    }
+}
+
+} // namespace optoctreeparser
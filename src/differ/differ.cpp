@@ -6,7 +6,10 @@
  */
 
 #include "differ/differ.hpp"
+#include "parser/parser.hpp"
 #include <algorithm>
+#include <format>
+#include <stdexcept>
 
 namespace optoctreeparser {
 
@@ -49,6 +52,158 @@ std::vector<OptocPatchTree> Differ::find_difference(const OptocRoot& old_root,
 
 
 
+// Static public method
+std::vector<OptocPatchTree> Differ::find_difference(const OptocRootHashes& old_hashes,
+                                                    const OptocRoot&       new_root,
+                                                    const OptocRootHashes& new_hashes) {
+    if (new_hashes.tree_hashes.size() != new_root.trees.size()) {
+        throw std::invalid_argument(
+            std::format("Hashes of {} trees are passed for batch of {} trees",
+                        new_hashes.tree_hashes.size(), new_root.trees.size()));
+    }
+
+    std::vector<OptocPatchTree> patches;
+
+    // Whole batch is unchanged
+    if (old_hashes.root_hash == new_hashes.root_hash &&
+        old_hashes.tree_hashes.size() == new_hashes.tree_hashes.size()) {
+        return patches;
+    }
+
+    // Iterate over trees of new batch. Removed trees are skipped like in the full comparison
+    for (std::size_t tree = 0; tree < new_root.trees.size(); ++tree) {
+        bool exists_in_old = tree < old_hashes.tree_hashes.size();
+
+        // Added or changed tree
+        if (!exists_in_old || old_hashes.tree_hashes[tree] != new_hashes.tree_hashes[tree]) {
+            patches.push_back({static_cast<byte>(tree),
+                               new_root.trees[tree].node_count,
+                               new_root.trees[tree].nodes});
+        }
+    }
+
+    return patches;
+}
+
+
+
+// Static public method
+std::vector<OptocPatchTree> Differ::find_difference(const OptocRootHashes& old_hashes,
+                                                    const OptocRoot&       new_root) {
+    return find_difference(old_hashes, new_root, Hasher::hash_root(new_root));
+}
+
+
+
+// Static public method
+std::vector<OptocPatchTree> Differ::find_difference(const OptocManifestBatch& old_batch,
+                                                    const OptocTreeView&      new_batch) {
+    // Byte-identical file
+    if (Hasher::hash_bytes(new_batch) == old_batch.file_hash) {
+        return {};
+    }
+
+    OptocRootHashes new_hashes{};
+    OptocRoot       new_root = Parser::parse_optoctree_batch(new_batch, new_hashes);
+
+    return find_difference(old_batch.hashes, new_root, new_hashes);
+}
+
+
+
+// Static public method
+std::vector<OptocPatchTree> Differ::find_difference(const OptocRoot&             old_root,
+                                                    const OptocRoot&             new_root,
+                                                    std::span<const std::size_t> candidate_trees) {
+    std::vector<OptocPatchTree> patches;
+
+    // Iterate over candidates only
+    for (std::size_t tree : candidate_trees) {
+        if (tree >= new_root.trees.size())
+            continue;
+
+        if (tree >= old_root.trees.size() ||
+            !trees_equal(new_root.trees[tree], old_root.trees[tree])) {
+            patches.push_back({static_cast<byte>(tree),
+                               new_root.trees[tree].node_count,
+                               new_root.trees[tree].nodes});
+        }
+    }
+
+    return patches;
+}
+
+
+
+// Static public method
+std::vector<OptocPatchTree> Differ::find_difference(const Snapshot& old_snapshot,
+                                                    const Snapshot& new_snapshot) {
+    std::vector<OptocPatchTree> patches;
+
+    // Iterate over trees of new snapshot. Removed trees are skipped like in the full comparison
+    for (std::size_t tree = 0; tree < new_snapshot.size(); ++tree) {
+        const OptocTree& new_tree = new_snapshot.tree(tree);
+
+        if (tree < old_snapshot.size() &&
+            (old_snapshot.tree_pointer(tree) == new_snapshot.tree_pointer(tree) ||
+             trees_equal(old_snapshot.tree(tree), new_tree))) {
+            continue;
+        }
+
+        patches.push_back({static_cast<byte>(tree), new_tree.node_count, new_tree.nodes});
+    }
+
+    return patches;
+}
+
+
+
+// Static public method
+std::size_t Differ::append_difference(const OptocTreeView& old_batch,
+                                      const OptocTreeView& new_batch,
+                                      int16_t              x_position,
+                                      int16_t              y_position,
+                                      int16_t              z_position,
+                                      OptocTreeView&       patch) {
+    auto old_offsets = Parser::find_tree_offsets(old_batch);
+    auto new_offsets = Parser::find_tree_offsets(new_batch);
+
+    // Header of batch: position and octree count, the count is written at the end
+    std::size_t header = patch.size();
+    for (int16_t position : {x_position, y_position, z_position}) {
+        patch.push_back(static_cast<byte>(position & 0xFF));
+        patch.push_back(static_cast<byte>((position >> 8) & 0xFF));
+    }
+    patch.push_back(0x00);
+
+    std::size_t changed{0};
+
+    // Iterate over trees. Encoded tree (node count and nodes) is the same in both formats
+    for (std::size_t tree = 0; tree + 1 < new_offsets.size(); ++tree) {
+        std::span<const byte> old_tree(old_batch.data() + old_offsets[tree],
+                                       old_offsets[tree + 1] - old_offsets[tree]);
+        std::span<const byte> new_tree(new_batch.data() + new_offsets[tree],
+                                       new_offsets[tree + 1] - new_offsets[tree]);
+
+        if (std::ranges::equal(old_tree, new_tree))
+            continue;
+
+        patch.push_back(static_cast<byte>(tree));
+        patch.insert(patch.end(), new_tree.begin(), new_tree.end());
+        ++changed;
+    }
+
+    if (changed == 0) {
+        patch.resize(header);
+        return 0;
+    }
+
+    patch[header + 6] = static_cast<byte>(changed);
+    return changed;
+}
+
+
+
 // Static private method
 bool Differ::trees_equal(const OptocTree& a, const OptocTree& b) {
     if (a.node_count != b.node_count)
@@ -0,0 +1,357 @@
+/**
+ * @brief Recomputation of signed distances from materials
+ *
+ * @copyright maksimshchavelev © 2025 maksimshchavelev@gmail.com
+ * @license MIT
+ */
+
+#include "distance_field/distance_field.hpp"
+#include "detail/parallel.hpp"
+#include "signed_distance/signed_distance.hpp"
+#include <algorithm>
+#include <cmath>
+#include <format>
+#include <limits>
+#include <stdexcept>
+#include <vector>
+
+namespace optoctreeparser {
+
+// Static public method
+void DistanceField::recompute(OptocGrid& grid, std::size_t thread_count) {
+    const std::size_t size = grid.size;
+    const std::size_t voxel_count = size * size * size;
+
+    if (grid.material_type.size() != voxel_count || grid.signed_distance.size() != voxel_count) {
+        throw std::invalid_argument(
+            std::format("Grid of size {} must have {} voxels, got {} and {}",
+                        size,
+                        voxel_count,
+                        grid.material_type.size(),
+                        grid.signed_distance.size()));
+    }
+
+    std::vector<float> distances = signed_distances(grid, thread_count);
+
+    detail::parallel_for(size, thread_count, [&](std::size_t z) {
+        for (std::size_t i = z * size * size; i < (z + 1) * size * size; ++i) {
+            grid.signed_distance[i] = SignedDistance::encode(distances[i]);
+        }
+    });
+}
+
+
+
+
+// Static public method
+void DistanceField::recompute(OptocRoot& batch, std::size_t thread_count) {
+    OptocGrid          grid = Grid::from_batch(batch, Octree::tree_size, thread_count);
+    std::vector<float> distances = signed_distances(grid, thread_count);
+    std::size_t        tree_count = std::min(batch.trees.size(), Octree::trees_per_batch);
+
+    // Shape of trees is kept, every tree writes only its own nodes
+    detail::parallel_for(tree_count, thread_count, [&](std::size_t tree) {
+        if (batch.trees[tree].nodes.empty())
+            return;
+
+        assign(batch.trees[tree], 0, Octree::tree_origin(tree), Octree::tree_size, grid, distances);
+    });
+}
+
+
+
+
+// Static public method
+void DistanceField::recompute(OptocRoot&                  batch,
+                              const WorldIndex&           world,
+                              const OptocBatchCoordinate& coordinate,
+                              std::size_t                 thread_count) {
+    const std::size_t size = Octree::batch_size + 2 * border;
+
+    // Only materials are needed by the transform
+    OptocGrid grid{.size = size,
+                   .material_type = std::vector<byte>(size * size * size, 0),
+                   .signed_distance = {}};
+
+    OptocNeighbourhood neighbourhood = world.neighbourhood(coordinate);
+    neighbourhood[13] = &batch;
+
+    // Batch `{dx, dy, dz}` of neighbourhood starts at `{dx, dy, dz} * batch_size + border`
+    auto start = [](std::size_t step) {
+        return (static_cast<int32_t>(step) - 1) * static_cast<int32_t>(Octree::batch_size) +
+               static_cast<int32_t>(border);
+    };
+
+    for (std::size_t index = 0; index < neighbourhood.size(); ++index) {
+        if (neighbourhood[index] == nullptr)
+            continue;
+
+        const OptocRoot& neighbour = *neighbourhood[index];
+        OptocVoxel       origin{start(index % 3), start(index / 3 % 3), start(index / 9)};
+        std::size_t      tree_count = std::min(neighbour.trees.size(), Octree::trees_per_batch);
+
+        // Trees do not overlap, so every tree writes only its own voxels
+        detail::parallel_for(tree_count, thread_count, [&](std::size_t tree) {
+            if (neighbour.trees[tree].nodes.empty())
+                return;
+
+            OptocVoxel tree_origin = Octree::tree_origin(tree);
+            OptocVoxel first{
+                origin.x + tree_origin.x, origin.y + tree_origin.y, origin.z + tree_origin.z};
+
+            rasterize(neighbour.trees[tree], 0, first, Octree::tree_size, grid);
+        });
+    }
+
+    std::vector<float> distances = signed_distances(grid, thread_count);
+    std::size_t        tree_count = std::min(batch.trees.size(), Octree::trees_per_batch);
+    auto               offset = static_cast<int32_t>(border);
+
+    detail::parallel_for(tree_count, thread_count, [&](std::size_t tree) {
+        if (batch.trees[tree].nodes.empty())
+            return;
+
+        OptocVoxel tree_origin = Octree::tree_origin(tree);
+        assign(batch.trees[tree],
+               0,
+               {tree_origin.x + offset, tree_origin.y + offset, tree_origin.z + offset},
+               Octree::tree_size,
+               grid,
+               distances);
+    });
+}
+
+
+
+
+// Static private method
+std::vector<float> DistanceField::signed_distances(const OptocGrid& grid,
+                                                   std::size_t      thread_count) {
+    const std::size_t size = grid.size;
+    const std::size_t voxel_count = size * size * size;
+
+    // Squared distance to the nearest solid voxel and to the nearest empty voxel
+    std::vector<float> outside(voxel_count);
+    std::vector<float> inside(voxel_count);
+
+    for (std::size_t i = 0; i < voxel_count; ++i) {
+        bool solid = grid.material_type[i] != 0;
+        outside[i] = solid ? 0.0f : far;
+        inside[i] = solid ? far : 0.0f;
+    }
+
+    for (std::size_t axis = 0; axis < 3; ++axis) {
+        transform_axis(size, outside, axis, thread_count);
+        transform_axis(size, inside, axis, thread_count);
+    }
+
+    // Surface is half a voxel away from the centers of voxels next to it. `outside` gets result
+    detail::parallel_for(size, thread_count, [&](std::size_t z) {
+        for (std::size_t i = z * size * size; i < (z + 1) * size * size; ++i) {
+            outside[i] = grid.material_type[i] != 0 ? 0.5f - std::sqrt(inside[i])
+                                                    : std::sqrt(outside[i]) - 0.5f;
+        }
+    });
+
+    return outside;
+}
+
+
+
+
+// Static private method
+void DistanceField::rasterize(const OptocTree&  tree,
+                              std::size_t       node,
+                              const OptocVoxel& origin,
+                              std::size_t       size,
+                              OptocGrid&        grid) {
+    auto edge = static_cast<int32_t>(size);
+    auto limit = static_cast<int32_t>(grid.size);
+
+    // Part of node inside grid
+    OptocVoxel low{std::max(origin.x, 0), std::max(origin.y, 0), std::max(origin.z, 0)};
+    OptocVoxel high{std::min(origin.x + edge, limit),
+                    std::min(origin.y + edge, limit),
+                    std::min(origin.z + edge, limit)};
+
+    if (low.x >= high.x || low.y >= high.y || low.z >= high.z)
+        return;
+
+    if (size > 1 && Octree::has_children(tree, node)) {
+        std::size_t first_child = tree.nodes[node].first_child_node;
+        int32_t     half = edge / 2;
+
+        for (std::size_t child = 0; child < Octree::children_count; ++child) {
+            OptocVoxel offset = Octree::child_offset(child);
+            OptocVoxel child_origin{
+                origin.x + offset.x * half, origin.y + offset.y * half, origin.z + offset.z * half};
+
+            rasterize(tree, first_child + child, child_origin, size / 2, grid);
+        }
+
+        return;
+    }
+
+    // Grid is empty, so only solid leaves are written
+    byte material = tree.nodes[node].material_type;
+    if (material == 0)
+        return;
+
+    for (int32_t z = low.z; z < high.z; ++z) {
+        for (int32_t y = low.y; y < high.y; ++y) {
+            std::size_t first = Grid::index(grid,
+                                            static_cast<std::size_t>(low.x),
+                                            static_cast<std::size_t>(y),
+                                            static_cast<std::size_t>(z));
+
+            std::fill_n(grid.material_type.begin() + static_cast<std::ptrdiff_t>(first),
+                        high.x - low.x,
+                        material);
+        }
+    }
+}
+
+
+
+
+// Static private method
+float DistanceField::assign(OptocTree&             tree,
+                            std::size_t            node,
+                            const OptocVoxel&      origin,
+                            std::size_t            size,
+                            const OptocGrid&       grid,
+                            std::span<const float> distances) {
+    float distance{0};
+
+    auto at = [&](std::size_t x, std::size_t y, std::size_t z) {
+        return distances[Grid::index(grid, x, y, z)];
+    };
+
+    auto x0 = static_cast<std::size_t>(origin.x);
+    auto y0 = static_cast<std::size_t>(origin.y);
+    auto z0 = static_cast<std::size_t>(origin.z);
+
+    if (size > 1 && Octree::has_children(tree, node)) {
+        // Inner node gets the average of its children, like in `Octree::parent_of`
+        std::size_t first_child = tree.nodes[node].first_child_node;
+        auto        half = static_cast<int32_t>(size / 2);
+
+        for (std::size_t child = 0; child < Octree::children_count; ++child) {
+            OptocVoxel offset = Octree::child_offset(child);
+            OptocVoxel child_origin{
+                origin.x + offset.x * half, origin.y + offset.y * half, origin.z + offset.z * half};
+
+            distance += assign(tree, first_child + child, child_origin, size / 2, grid, distances);
+        }
+
+        distance /= Octree::children_count;
+    } else if (size == 1) {
+        distance = at(x0, y0, z0);
+    } else {
+        // Center of larger leaf is the common corner of its 8 central voxels
+        std::size_t half = size / 2;
+
+        for (std::size_t corner = 0; corner < Octree::children_count; ++corner) {
+            OptocVoxel offset = Octree::child_offset(corner);
+            distance += at(x0 + half - 1 + static_cast<std::size_t>(offset.x),
+                           y0 + half - 1 + static_cast<std::size_t>(offset.y),
+                           z0 + half - 1 + static_cast<std::size_t>(offset.z));
+        }
+
+        distance /= Octree::children_count;
+    }
+
+    tree.nodes[node].signed_distance = SignedDistance::encode(distance);
+    return distance;
+}
+
+
+
+
+// Static private method
+void DistanceField::transform_axis(std::size_t      size,
+                                   std::span<float> values,
+                                   std::size_t      axis,
+                                   std::size_t      thread_count) {
+    // Distance between neighbours along axis and between neighbouring lines of one slab
+    const std::size_t stride = axis == 0 ? 1 : axis == 1 ? size : size * size;
+    const std::size_t line_stride = axis == 0 ? size : 1;
+    const std::size_t slab_stride = axis == 2 ? size : size * size;
+
+    // Every slab is a set of lines that no other slab touches
+    detail::parallel_for(size, thread_count, [&](std::size_t slab) {
+        std::vector<float>       line(size);
+        std::vector<std::size_t> vertices(size);
+        std::vector<float>       bounds(size + 1);
+        std::vector<float>       result(size);
+
+        for (std::size_t line_index = 0; line_index < size; ++line_index) {
+            std::size_t first = slab * slab_stride + line_index * line_stride;
+
+            for (std::size_t i = 0; i < size; ++i) {
+                line[i] = values[first + i * stride];
+            }
+
+            transform_line(line, vertices, bounds, result);
+
+            for (std::size_t i = 0; i < size; ++i) {
+                values[first + i * stride] = line[i];
+            }
+        }
+    });
+}
+
+
+
+
+// Static private method
+void DistanceField::transform_line(std::span<float>       line,
+                                   std::span<std::size_t> vertices,
+                                   std::span<float>       bounds,
+                                   std::span<float>       result) {
+    constexpr float infinity = std::numeric_limits<float>::infinity();
+
+    auto square = [](std::size_t value) {
+        auto as_float = static_cast<float>(value);
+        return as_float * as_float;
+    };
+
+    // Intersection of parabolas rooted at `q` and `v`
+    auto intersection = [&](std::size_t q, std::size_t v) {
+        return ((line[q] + square(q)) - (line[v] + square(v))) /
+               (2.0f * static_cast<float>(q) - 2.0f * static_cast<float>(v));
+    };
+
+    std::size_t k = 0;
+    vertices[0] = 0;
+    bounds[0] = -infinity;
+    bounds[1] = infinity;
+
+    for (std::size_t q = 1; q < line.size(); ++q) {
+        float s = intersection(q, vertices[k]);
+
+        while (s <= bounds[k]) {
+            --k;
+            s = intersection(q, vertices[k]);
+        }
+
+        ++k;
+        vertices[k] = q;
+        bounds[k] = s;
+        bounds[k + 1] = infinity;
+    }
+
+    k = 0;
+    for (std::size_t q = 0; q < line.size(); ++q) {
+        while (bounds[k + 1] < static_cast<float>(q)) {
+            ++k;
+        }
+
+        float offset = static_cast<float>(q) - static_cast<float>(vertices[k]);
+        result[q] = offset * offset + line[vertices[k]];
+    }
+
+    std::ranges::copy(result, line.begin());
+}
+
+} // namespace optoctreeparser
@@ -0,0 +1,213 @@
+/**
+ * @brief Bulk editing of batches with shapes and brushes
+ *
+ * @copyright maksimshchavelev © 2025 maksimshchavelev@gmail.com
+ * @license MIT
+ */
+
+#include "editor/editor.hpp"
+#include "detail/parallel.hpp"
+#include "grid/grid.hpp"
+#include "signed_distance/signed_distance.hpp"
+#include <algorithm>
+#include <cmath>
+
+namespace optoctreeparser {
+
+// Static public method
+EditOperation Editor::sphere(EditMode          mode,
+                             byte              material_type,
+                             const OptocPoint& center,
+                             float             radius) {
+    return brush(mode,
+                 material_type,
+                 {center.x - radius, center.y - radius, center.z - radius},
+                 {center.x + radius, center.y + radius, center.z + radius},
+                 [center, radius](const OptocPoint& point) {
+                     float dx = point.x - center.x;
+                     float dy = point.y - center.y;
+                     float dz = point.z - center.z;
+                     return std::sqrt(dx * dx + dy * dy + dz * dz) - radius;
+                 });
+}
+
+
+
+
+// Static public method
+EditOperation Editor::box(EditMode          mode,
+                          byte              material_type,
+                          const OptocPoint& min,
+                          const OptocPoint& max) {
+    OptocPoint center{(min.x + max.x) / 2, (min.y + max.y) / 2, (min.z + max.z) / 2};
+    OptocPoint half{(max.x - min.x) / 2, (max.y - min.y) / 2, (max.z - min.z) / 2};
+
+    return brush(mode, material_type, min, max, [center, half](const OptocPoint& point) {
+        float qx = std::abs(point.x - center.x) - half.x;
+        float qy = std::abs(point.y - center.y) - half.y;
+        float qz = std::abs(point.z - center.z) - half.z;
+
+        float ox = std::max(qx, 0.0f);
+        float oy = std::max(qy, 0.0f);
+        float oz = std::max(qz, 0.0f);
+
+        return std::sqrt(ox * ox + oy * oy + oz * oz) + std::min(std::max({qx, qy, qz}), 0.0f);
+    });
+}
+
+
+
+
+// Static public method
+EditOperation Editor::brush(EditMode                                mode,
+                            byte                                    material_type,
+                            const OptocPoint&                       min,
+                            const OptocPoint&                       max,
+                            std::function<float(const OptocPoint&)> distance) {
+    return {.mode = mode,
+            .material_type = material_type,
+            .min = {min.x - distance_margin, min.y - distance_margin, min.z - distance_margin},
+            .max = {max.x + distance_margin, max.y + distance_margin, max.z + distance_margin},
+            .distance = std::move(distance)};
+}
+
+
+
+
+// Static public method
+std::vector<std::size_t> Editor::apply(OptocRoot&                     batch,
+                                       std::span<const EditOperation> operations,
+                                       std::size_t                    thread_count) {
+    // Group operations by tree, so every tree is rebuilt only once
+    std::vector<std::vector<std::size_t>> affecting(batch.trees.size());
+    std::vector<std::size_t>              touched;
+
+    for (std::size_t tree = 0; tree < batch.trees.size(); ++tree) {
+        for (std::size_t operation = 0; operation < operations.size(); ++operation) {
+            if (overlaps(operations[operation], tree))
+                affecting[tree].push_back(operation);
+        }
+
+        if (!affecting[tree].empty())
+            touched.push_back(tree);
+    }
+
+    std::vector<char> changed(touched.size(), 0);
+
+    detail::parallel_for(touched.size(), thread_count, [&](std::size_t index) {
+        std::size_t tree = touched[index];
+        changed[index] = apply_to_tree(batch.trees[tree], tree, operations, affecting[tree]);
+    });
+
+    std::vector<std::size_t> changed_trees;
+    for (std::size_t index = 0; index < touched.size(); ++index) {
+        if (changed[index])
+            changed_trees.push_back(touched[index]);
+    }
+
+    return changed_trees;
+}
+
+
+
+
+// Static private method
+bool Editor::overlaps(const EditOperation& operation, std::size_t tree) {
+    OptocVoxel origin = Octree::tree_origin(tree);
+    auto       size = static_cast<float>(Octree::tree_size);
+
+    auto overlaps_axis = [size](float min, float max, int32_t tree_min) {
+        auto begin = static_cast<float>(tree_min);
+        return min < begin + size && max > begin;
+    };
+
+    return overlaps_axis(operation.min.x, operation.max.x, origin.x) &&
+           overlaps_axis(operation.min.y, operation.max.y, origin.y) &&
+           overlaps_axis(operation.min.z, operation.max.z, origin.z);
+}
+
+
+
+
+// Static private method
+bool Editor::apply_to_tree(OptocTree&                     tree,
+                           std::size_t                    tree_index,
+                           std::span<const EditOperation> operations,
+                           std::span<const std::size_t>   affecting) {
+    OptocGrid  grid = Grid::from_tree(tree);
+    OptocVoxel origin = Octree::tree_origin(tree_index);
+    bool       changed = false;
+
+    // Range of grid voxels whose centers are inside [min, max] along one axis
+    auto voxel_range = [&grid](float min, float max, int32_t tree_min) {
+        float       local_min = std::floor(min - static_cast<float>(tree_min));
+        float       local_max = std::ceil(max - static_cast<float>(tree_min));
+        auto        size = static_cast<float>(grid.size);
+        std::size_t begin = static_cast<std::size_t>(std::clamp(local_min, 0.0f, size));
+        std::size_t end = static_cast<std::size_t>(std::clamp(local_max, 0.0f, size));
+        return std::pair{begin, end};
+    };
+
+    for (std::size_t operation_index : affecting) {
+        const EditOperation& operation = operations[operation_index];
+
+        auto [x_begin, x_end] = voxel_range(operation.min.x, operation.max.x, origin.x);
+        auto [y_begin, y_end] = voxel_range(operation.min.y, operation.max.y, origin.y);
+        auto [z_begin, z_end] = voxel_range(operation.min.z, operation.max.z, origin.z);
+
+        for (std::size_t z = z_begin; z < z_end; ++z) {
+            for (std::size_t y = y_begin; y < y_end; ++y) {
+                for (std::size_t x = x_begin; x < x_end; ++x) {
+                    std::size_t voxel = Grid::index(grid, x, y, z);
+                    OptocPoint  center{static_cast<float>(origin.x) + static_cast<float>(x) + 0.5f,
+                                      static_cast<float>(origin.y) + static_cast<float>(y) + 0.5f,
+                                      static_cast<float>(origin.z) + static_cast<float>(z) + 0.5f};
+
+                    float shape = operation.distance(center);
+                    byte  old_material = grid.material_type[voxel];
+                    byte  encoded = grid.signed_distance[voxel];
+                    float old_distance = SignedDistance::decode(encoded, old_material);
+                    byte  material = old_material;
+                    float distance = old_distance;
+
+                    switch (operation.mode) {
+                    case EditMode::add:
+                        distance = std::min(distance, shape);
+                        if (shape <= 0)
+                            material = operation.material_type;
+                        break;
+                    case EditMode::remove:
+                        distance = std::max(distance, -shape);
+                        if (shape <= 0)
+                            material = 0;
+                        break;
+                    case EditMode::paint:
+                        if (shape <= 0 && material != 0)
+                            material = operation.material_type;
+                        break;
+                    }
+
+                    // Re-encode only if distance has really changed, so untouched "completely
+                    // solid" zeros are kept. Meaning of 0 depends on whether material is empty
+                    bool emptiness_changed = (material == 0) != (old_material == 0);
+                    if (distance != old_distance || (encoded == 0 && emptiness_changed)) {
+                        encoded = SignedDistance::encode(distance);
+                    }
+
+                    if (material != old_material || encoded != grid.signed_distance[voxel]) {
+                        grid.material_type[voxel] = material;
+                        grid.signed_distance[voxel] = encoded;
+                        changed = true;
+                    }
+                }
+            }
+        }
+    }
+
+    if (changed)
+        tree = Grid::to_tree(grid);
+
+    return changed;
+}
+
+} // namespace optoctreeparser
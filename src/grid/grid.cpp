@@ -0,0 +1,238 @@
+/**
+ * @brief Dense voxel grid and conversion of octrees to it and back
+ *
+ * @copyright maksimshchavelev © 2025 maksimshchavelev@gmail.com
+ * @license MIT
+ */
+
+#include "grid/grid.hpp"
+#include "detail/parallel.hpp"
+#include <algorithm>
+#include <bit>
+#include <format>
+#include <span>
+#include <stdexcept>
+
+namespace optoctreeparser {
+
+// Static public method
+OptocGrid Grid::from_tree(const OptocTree& tree) {
+    return from_tree(tree, Octree::tree_size);
+}
+
+
+
+
+// Static public method
+OptocGrid Grid::from_tree(const OptocTree& tree, std::size_t resolution) {
+    validate_resolution(resolution);
+
+    OptocGrid grid = make_grid(resolution);
+
+    if (!tree.nodes.empty()) {
+        fill(tree, 0, {0, 0, 0}, grid.size, grid);
+    }
+
+    return grid;
+}
+
+
+
+
+// Static public method
+OptocGrid Grid::from_batch(const OptocRoot& batch,
+                           std::size_t      resolution,
+                           std::size_t      thread_count) {
+    validate_resolution(resolution);
+
+    OptocGrid   grid = make_grid(Octree::trees_per_side * resolution);
+    std::size_t tree_count = std::min(batch.trees.size(), Octree::trees_per_batch);
+    auto        scale = static_cast<int32_t>(Octree::tree_size / resolution);
+
+    // Trees cover disjoint cubes of grid, so they are filled concurrently
+    detail::parallel_for(tree_count, thread_count, [&](std::size_t tree) {
+        if (batch.trees[tree].nodes.empty())
+            return;
+
+        OptocVoxel origin = Octree::tree_origin(tree);
+        fill(batch.trees[tree],
+             0,
+             {origin.x / scale, origin.y / scale, origin.z / scale},
+             resolution,
+             grid);
+    });
+
+    return grid;
+}
+
+
+
+
+// Static public method
+OptocTree Grid::to_tree(const OptocGrid& grid) {
+    return build_tree(grid, {0, 0, 0}, grid.size);
+}
+
+
+
+
+// Static public method
+OptocRoot Grid::to_batch(const OptocGrid& grid, int32_t version, std::size_t thread_count) {
+    std::size_t resolution = grid.size / Octree::trees_per_side;
+
+    if (grid.size % Octree::trees_per_side != 0 || !std::has_single_bit(resolution) ||
+        resolution > Octree::tree_size) {
+        throw std::invalid_argument(std::format(
+            "Grid size {} is not {} times a power of two", grid.size, Octree::trees_per_side));
+    }
+
+    OptocRoot batch{.version = version, .trees = std::vector<OptocTree>(Octree::trees_per_batch)};
+    auto      scale = static_cast<int32_t>(Octree::tree_size / resolution);
+
+    detail::parallel_for(Octree::trees_per_batch, thread_count, [&](std::size_t tree) {
+        OptocVoxel origin = Octree::tree_origin(tree);
+        batch.trees[tree] =
+            build_tree(grid, {origin.x / scale, origin.y / scale, origin.z / scale}, resolution);
+    });
+
+    return batch;
+}
+
+
+
+
+// Static public method
+std::size_t Grid::index(const OptocGrid& grid, std::size_t x, std::size_t y, std::size_t z) {
+    return x + grid.size * (y + grid.size * z);
+}
+
+
+
+
+// Static private method
+void Grid::fill(const OptocTree&  tree,
+                std::size_t       node,
+                const OptocVoxel& origin,
+                std::size_t       size,
+                OptocGrid&        grid) {
+    if (size > 1 && Octree::has_children(tree, node)) {
+        std::size_t first_child = tree.nodes[node].first_child_node;
+        auto        half = static_cast<int32_t>(size / 2);
+
+        for (std::size_t child = 0; child < Octree::children_count; ++child) {
+            OptocVoxel offset = Octree::child_offset(child);
+            OptocVoxel child_origin{
+                origin.x + offset.x * half, origin.y + offset.y * half, origin.z + offset.z * half};
+
+            fill(tree, first_child + child, child_origin, size / 2, grid);
+        }
+        return;
+    }
+
+    const OptocNode& leaf = tree.nodes[node];
+    auto             x0 = static_cast<std::size_t>(origin.x);
+    auto             y0 = static_cast<std::size_t>(origin.y);
+    auto             z0 = static_cast<std::size_t>(origin.z);
+
+    for (std::size_t z = z0; z < z0 + size; ++z) {
+        for (std::size_t y = y0; y < y0 + size; ++y) {
+            std::size_t row = index(grid, x0, y, z);
+            std::fill_n(grid.material_type.begin() + static_cast<std::ptrdiff_t>(row),
+                        size,
+                        leaf.material_type);
+            std::fill_n(grid.signed_distance.begin() + static_cast<std::ptrdiff_t>(row),
+                        size,
+                        leaf.signed_distance);
+        }
+    }
+}
+
+
+
+
+// Static private method
+OptocGrid Grid::make_grid(std::size_t size) {
+    OptocGrid grid{};
+    grid.size = size;
+    grid.material_type.resize(size * size * size, 0x00);
+    grid.signed_distance.resize(size * size * size, 0x00);
+    return grid;
+}
+
+
+
+
+// Static private method
+void Grid::validate_resolution(std::size_t resolution) {
+    if (!std::has_single_bit(resolution) || resolution > Octree::tree_size) {
+        throw std::invalid_argument(std::format(
+            "Resolution must be a power of two up to {}, got {}", Octree::tree_size, resolution));
+    }
+}
+
+
+
+
+// Static private method
+OptocTree Grid::build_tree(const OptocGrid& grid, const OptocVoxel& origin, std::size_t size) {
+    OptocTree tree{};
+    tree.nodes.push_back({}); // Root, children go after it
+
+    OptocNode root = build(grid, origin, size, tree);
+    tree.nodes[0] = root;
+
+    tree.node_count = static_cast<uint16_t>(tree.nodes.size());
+    return tree;
+}
+
+
+
+
+// Static private method
+OptocNode Grid::build(const OptocGrid&  grid,
+                      const OptocVoxel& origin,
+                      std::size_t       size,
+                      OptocTree&        tree) {
+    if (size == 1) {
+        std::size_t voxel = index(grid,
+                                  static_cast<std::size_t>(origin.x),
+                                  static_cast<std::size_t>(origin.y),
+                                  static_cast<std::size_t>(origin.z));
+
+        return {.material_type = grid.material_type[voxel],
+                .signed_distance = grid.signed_distance[voxel],
+                .first_child_node = 0};
+    }
+
+    // Children are contiguous, grandchildren are appended after them
+    std::size_t first_child = tree.nodes.size();
+    tree.nodes.resize(first_child + Octree::children_count);
+
+    auto half = static_cast<int32_t>(size / 2);
+
+    for (std::size_t child = 0; child < Octree::children_count; ++child) {
+        OptocVoxel offset = Octree::child_offset(child);
+        OptocNode  node = build(grid,
+                               {origin.x + offset.x * half,
+                                origin.y + offset.y * half,
+                                origin.z + offset.z * half},
+                               size / 2,
+                               tree);
+
+        tree.nodes[first_child + child] = node;
+    }
+
+    // Equal leaves mean the whole cube is uniform, they are collapsed into one leaf
+    auto      children = std::span(tree.nodes).subspan(first_child, Octree::children_count);
+    OptocNode first = children.front();
+
+    if (first.first_child_node == 0 &&
+        std::ranges::all_of(children, [&](const OptocNode& node) { return node == first; })) {
+        tree.nodes.resize(first_child);
+        return first;
+    }
+
+    return Octree::parent_of(children, first_child);
+}
+
+} // namespace optoctreeparser
@@ -0,0 +1,193 @@
+/**
+ * @brief Hasher to compute content hashes of optoctree data
+ *
+ * @copyright maksimshchavelev © 2025 maksimshchavelev@gmail.com
+ * @license MIT
+ */
+
+#include "hasher/hasher.hpp"
+#include <bit>
+
+namespace optoctreeparser {
+
+namespace {
+
+// XXH64 primes
+constexpr uint64_t prime_1 = 0x9E3779B185EBCA87ULL;
+constexpr uint64_t prime_2 = 0xC2B2AE3D27D4EB4FULL;
+constexpr uint64_t prime_3 = 0x165667B19E3779F9ULL;
+constexpr uint64_t prime_4 = 0x85EBCA77C2B2AE63ULL;
+constexpr uint64_t prime_5 = 0x27D4EB2F165667C5ULL;
+
+static_assert(sizeof(OptocNode) == 4, "OptocNode must have the same size as encoded node");
+
+} // namespace
+
+
+// Static public method
+OptocHash Hasher::hash_bytes(std::span<const byte> bytes, uint64_t seed) {
+    const std::size_t size = bytes.size();
+    std::size_t       offset = 0;
+    uint64_t          hash{};
+
+    if (size >= 32) {
+        // Four independent lanes, so the compiler can keep them all in flight
+        uint64_t lane_1 = seed + prime_1 + prime_2;
+        uint64_t lane_2 = seed + prime_2;
+        uint64_t lane_3 = seed;
+        uint64_t lane_4 = seed - prime_1;
+
+        for (; offset + 32 <= size; offset += 32) {
+            lane_1 = round(lane_1, read_u64_le(bytes, offset));
+            lane_2 = round(lane_2, read_u64_le(bytes, offset + 8));
+            lane_3 = round(lane_3, read_u64_le(bytes, offset + 16));
+            lane_4 = round(lane_4, read_u64_le(bytes, offset + 24));
+        }
+
+        hash = std::rotl(lane_1, 1) + std::rotl(lane_2, 7) + std::rotl(lane_3, 12) +
+               std::rotl(lane_4, 18);
+        hash = merge_round(hash, lane_1);
+        hash = merge_round(hash, lane_2);
+        hash = merge_round(hash, lane_3);
+        hash = merge_round(hash, lane_4);
+    } else {
+        hash = seed + prime_5;
+    }
+
+    hash += static_cast<uint64_t>(size);
+
+    // Tail
+    for (; offset + 8 <= size; offset += 8) {
+        hash ^= round(0, read_u64_le(bytes, offset));
+        hash = std::rotl(hash, 27) * prime_1 + prime_4;
+    }
+
+    if (offset + 4 <= size) {
+        hash ^= static_cast<uint64_t>(read_u32_le(bytes, offset)) * prime_1;
+        hash = std::rotl(hash, 23) * prime_2 + prime_3;
+        offset += 4;
+    }
+
+    for (; offset < size; ++offset) {
+        hash ^= static_cast<uint64_t>(bytes[offset]) * prime_5;
+        hash = std::rotl(hash, 11) * prime_1;
+    }
+
+    // Avalanche
+    hash ^= hash >> 33;
+    hash *= prime_2;
+    hash ^= hash >> 29;
+    hash *= prime_3;
+    hash ^= hash >> 32;
+
+    return hash;
+}
+
+
+
+
+// Static public method
+OptocHash Hasher::hash_tree(const OptocTree& tree) {
+    if constexpr (std::endian::native == std::endian::little) {
+        // In-memory layout of nodes is the same as the encoded one
+        std::span<const byte> bytes(reinterpret_cast<const byte*>(tree.nodes.data()),
+                                    tree.nodes.size() * sizeof(OptocNode));
+        return hash_encoded_tree(tree.node_count, bytes);
+    } else {
+        std::vector<byte> bytes;
+        bytes.reserve(tree.nodes.size() * 4);
+
+        for (const auto& node : tree.nodes) {
+            bytes.push_back(node.material_type);
+            bytes.push_back(node.signed_distance);
+            bytes.push_back(static_cast<byte>(node.first_child_node & 0xFF));
+            bytes.push_back(static_cast<byte>((node.first_child_node >> 8) & 0xFF));
+        }
+
+        return hash_encoded_tree(tree.node_count, bytes);
+    }
+}
+
+
+
+
+// Static public method
+OptocHash Hasher::hash_encoded_tree(uint16_t node_count, std::span<const byte> encoded_nodes) {
+    return hash_bytes(encoded_nodes, node_count);
+}
+
+
+
+
+// Static public method
+OptocRootHashes Hasher::hash_root(const OptocRoot& root) {
+    OptocRootHashes hashes{};
+    hashes.tree_hashes.reserve(root.trees.size());
+
+    for (const auto& tree : root.trees) {
+        hashes.tree_hashes.push_back(hash_tree(tree));
+    }
+
+    hashes.root_hash = hash_root(root.version, hashes.tree_hashes);
+    return hashes;
+}
+
+
+
+
+// Static public method
+OptocHash Hasher::hash_root(int32_t version, std::span<const OptocHash> tree_hashes) {
+    std::vector<byte> bytes;
+    bytes.reserve(tree_hashes.size() * 8);
+
+    for (OptocHash tree_hash : tree_hashes) {
+        for (std::size_t i = 0; i < 8; ++i) {
+            bytes.push_back(static_cast<byte>((tree_hash >> (i * 8)) & 0xFF));
+        }
+    }
+
+    return hash_bytes(bytes, static_cast<uint32_t>(version));
+}
+
+
+
+
+// Static private method
+uint64_t Hasher::read_u64_le(std::span<const byte> buffer, size_t offset) {
+    return static_cast<uint64_t>(read_u32_le(buffer, offset)) |
+           (static_cast<uint64_t>(read_u32_le(buffer, offset + 4)) << 32);
+}
+
+
+
+
+// Static private method
+uint32_t Hasher::read_u32_le(std::span<const byte> buffer, size_t offset) {
+    return static_cast<uint32_t>(buffer[offset]) |
+           (static_cast<uint32_t>(buffer[offset + 1]) << 8) |
+           (static_cast<uint32_t>(buffer[offset + 2]) << 16) |
+           (static_cast<uint32_t>(buffer[offset + 3]) << 24);
+}
+
+
+
+
+// Static private method
+uint64_t Hasher::round(uint64_t accumulator, uint64_t input) {
+    accumulator += input * prime_2;
+    accumulator = std::rotl(accumulator, 31);
+    accumulator *= prime_1;
+    return accumulator;
+}
+
+
+
+
+// Static private method
+uint64_t Hasher::merge_round(uint64_t hash, uint64_t accumulator) {
+    hash ^= round(0, accumulator);
+    hash = hash * prime_1 + prime_4;
+    return hash;
+}
+
+} // namespace optoctreeparser
@@ -0,0 +1,194 @@
+/**
+ * @brief Level-of-detail downsampling of octrees
+ *
+ * @copyright maksimshchavelev © 2025 maksimshchavelev@gmail.com
+ * @license MIT
+ */
+
+#include "lod/lod.hpp"
+#include "detail/parallel.hpp"
+#include "octree/octree.hpp"
+#include "parser/parser.hpp"
+#include "signed_distance/signed_distance.hpp"
+#include <array>
+#include <queue>
+
+namespace optoctreeparser {
+
+struct Lod::Aggregate {
+    std::array<double, 256> material_volume{}; ///< Volume of every material
+    double                  distance_sum{0};   ///< Sum of volume-weighted distances
+    float                   distance_min{SignedDistance::max_outside};
+    double                  volume{0};         ///< Total volume of leaves
+    bool                    all_zero{true};    ///< Every leaf has encoded distance 0
+};
+
+
+
+
+// Static public method
+OptocTree Lod::truncate_tree(const OptocTree&    tree,
+                             std::size_t         depth,
+                             DistanceAggregation aggregation) {
+    OptocTree truncated{};
+
+    if (tree.nodes.empty()) {
+        truncated.node_count = tree.node_count;
+        return truncated;
+    }
+
+    truncated.nodes.reserve(tree.nodes.size());
+    truncated.nodes.push_back(tree.nodes[0]);
+
+    struct Pending {
+        std::size_t source; ///< Index of node in source tree
+        std::size_t target; ///< Index of node in truncated tree
+        std::size_t depth;  ///< Depth of node
+    };
+
+    std::queue<Pending> pending;
+    pending.push({0, 0, 0});
+
+    // Breadth-first, so children of every node stay contiguous
+    while (!pending.empty()) {
+        Pending current = pending.front();
+        pending.pop();
+
+        if (!Octree::has_children(tree, current.source)) {
+            truncated.nodes[current.target] = tree.nodes[current.source];
+            truncated.nodes[current.target].first_child_node = 0;
+            continue;
+        }
+
+        if (current.depth >= depth) {
+            truncated.nodes[current.target] = collapse(tree, current.source, aggregation);
+            continue;
+        }
+
+        std::size_t source_child = tree.nodes[current.source].first_child_node;
+        std::size_t target_child = truncated.nodes.size();
+
+        truncated.nodes[current.target].first_child_node = static_cast<uint16_t>(target_child);
+
+        for (std::size_t child = 0; child < Octree::children_count; ++child) {
+            truncated.nodes.push_back(tree.nodes[source_child + child]);
+            pending.push({source_child + child, target_child + child, current.depth + 1});
+        }
+    }
+
+    truncated.node_count = static_cast<uint16_t>(truncated.nodes.size());
+    return truncated;
+}
+
+
+
+
+// Static public method
+OptocRoot Lod::truncate_batch(const OptocRoot&    batch,
+                              std::size_t         depth,
+                              DistanceAggregation aggregation) {
+    OptocRoot truncated{};
+    truncated.version = batch.version;
+    truncated.trees.reserve(batch.trees.size());
+
+    for (const auto& tree : batch.trees) {
+        truncated.trees.push_back(truncate_tree(tree, depth, aggregation));
+    }
+
+    return truncated;
+}
+
+
+
+
+// Static public method
+std::vector<OptocRoot> Lod::truncate_batches(std::span<const OptocRoot> batches,
+                                             std::size_t                depth,
+                                             DistanceAggregation        aggregation,
+                                             std::size_t                thread_count) {
+    std::vector<OptocRoot> truncated(batches.size());
+
+    detail::parallel_for(batches.size(), thread_count, [&](std::size_t index) {
+        truncated[index] = truncate_batch(batches[index], depth, aggregation);
+    });
+
+    return truncated;
+}
+
+
+
+
+// Static public method
+std::vector<OptocTreeView> Lod::pack_truncated_batches(std::span<const OptocRoot> batches,
+                                                       std::size_t                depth,
+                                                       DistanceAggregation        aggregation,
+                                                       std::size_t                thread_count) {
+    std::vector<OptocTreeView> views(batches.size());
+
+    detail::parallel_for(batches.size(), thread_count, [&](std::size_t index) {
+        views[index] =
+            Parser::pack_optoctree_batch(truncate_batch(batches[index], depth, aggregation));
+    });
+
+    return views;
+}
+
+
+
+
+// Static private method
+void Lod::accumulate(const OptocTree& tree,
+                     std::size_t      node,
+                     double           volume,
+                     Aggregate&       aggregate) {
+    if (Octree::has_children(tree, node)) {
+        std::size_t first_child = tree.nodes[node].first_child_node;
+
+        for (std::size_t child = 0; child < Octree::children_count; ++child) {
+            accumulate(tree, first_child + child, volume / Octree::children_count, aggregate);
+        }
+        return;
+    }
+
+    const OptocNode& leaf = tree.nodes[node];
+    float            distance = SignedDistance::decode(leaf.signed_distance, leaf.material_type);
+
+    aggregate.material_volume[leaf.material_type] += volume;
+    aggregate.distance_sum += static_cast<double>(distance) * volume;
+    aggregate.distance_min = std::min(aggregate.distance_min, distance);
+    aggregate.volume += volume;
+    aggregate.all_zero = aggregate.all_zero && leaf.signed_distance == 0;
+}
+
+
+
+
+// Static private method
+OptocNode Lod::collapse(const OptocTree& tree, std::size_t node, DistanceAggregation aggregation) {
+    Aggregate aggregate{};
+    accumulate(tree, node, 1.0, aggregate);
+
+    OptocNode leaf{};
+
+    // Majority by volume. Ties go to the smaller material number
+    std::size_t material = 0;
+    for (std::size_t candidate = 1; candidate < aggregate.material_volume.size(); ++candidate) {
+        if (aggregate.material_volume[candidate] > aggregate.material_volume[material])
+            material = candidate;
+    }
+    leaf.material_type = static_cast<byte>(material);
+
+    if (aggregate.all_zero) {
+        leaf.signed_distance = 0;
+    } else if (aggregation == DistanceAggregation::min) {
+        leaf.signed_distance = SignedDistance::encode(aggregate.distance_min);
+    } else {
+        leaf.signed_distance =
+            SignedDistance::encode(static_cast<float>(aggregate.distance_sum / aggregate.volume));
+    }
+
+    leaf.first_child_node = 0;
+    return leaf;
+}
+
+} // namespace optoctreeparser
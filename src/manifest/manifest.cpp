@@ -0,0 +1,266 @@
+/**
+ * @brief Manifest with content hashes of a world of optoctree files
+ *
+ * @copyright maksimshchavelev © 2025 maksimshchavelev@gmail.com
+ * @license MIT
+ */
+
+#include "manifest/manifest.hpp"
+#include "parser/codec.hpp"
+#include "parser/parser.hpp"
+#include "reader/reader.hpp"
+#include <algorithm>
+#include <filesystem>
+#include <format>
+#include <limits>
+#include <stdexcept>
+#include <unordered_map>
+
+namespace optoctreeparser {
+
+// Static public method
+OptocManifestBatch Manifest::make_batch(const std::string_view path) {
+    std::filesystem::path file_path(path);
+
+    // Size and mtime are taken before reading, so a concurrent write is caught by the next update
+    uint64_t file_size = std::filesystem::file_size(file_path);
+    int64_t  file_mtime = std::filesystem::last_write_time(file_path).time_since_epoch().count();
+
+    OptocManifestBatch batch = hash_batch(path, Reader::optoctreeview_from_file(path));
+    batch.file_size = file_size;
+    batch.file_mtime = file_mtime;
+
+    return batch;
+}
+
+
+
+
+// Static public method
+OptocManifest Manifest::make(std::span<const std::string> paths) {
+    OptocManifest manifest{.version = current_version, .batches = {}};
+    manifest.batches.reserve(paths.size());
+
+    for (const auto& path : paths) {
+        manifest.batches.push_back(make_batch(path));
+    }
+
+    return manifest;
+}
+
+
+
+
+// Static public method
+std::size_t Manifest::update(OptocManifest& manifest, std::span<const std::string> paths) {
+    // Index of old batches by path, so every path is looked up in O(1)
+    std::unordered_map<std::string_view, const OptocManifestBatch*> old_batches;
+    old_batches.reserve(manifest.batches.size());
+
+    for (const auto& batch : manifest.batches) {
+        old_batches.emplace(batch.path, &batch);
+    }
+
+    std::vector<OptocManifestBatch> batches;
+    batches.reserve(paths.size());
+
+    std::size_t reread{0};
+
+    for (const auto& path : paths) {
+        auto old_batch = old_batches.find(path);
+
+        if (old_batch != old_batches.end() && is_up_to_date(*old_batch->second)) {
+            batches.push_back(*old_batch->second);
+            continue;
+        }
+
+        batches.push_back(make_batch(path));
+        ++reread;
+    }
+
+    manifest.version = current_version;
+    manifest.batches = std::move(batches);
+
+    return reread;
+}
+
+
+
+
+// Static public method
+bool Manifest::is_up_to_date(const OptocManifestBatch& batch) {
+    std::error_code       error;
+    std::filesystem::path file_path(batch.path);
+
+    auto file_size = std::filesystem::file_size(file_path, error);
+    if (error)
+        return false;
+
+    auto file_mtime = std::filesystem::last_write_time(file_path, error);
+    if (error)
+        return false;
+
+    return file_size == batch.file_size &&
+           file_mtime.time_since_epoch().count() == batch.file_mtime;
+}
+
+
+
+
+// Static public method
+const OptocManifestBatch* Manifest::find_batch(const OptocManifest&   manifest,
+                                               const std::string_view path) {
+    auto found = std::ranges::find(manifest.batches, path, &OptocManifestBatch::path);
+    return found == manifest.batches.end() ? nullptr : &*found;
+}
+
+
+
+
+// Static public method
+OptocTreeView Manifest::pack_manifest(const OptocManifest& manifest) {
+    OptocTreeView view;
+
+    // Counting size of manifest
+    std::size_t size_of_manifest{0};
+    size_of_manifest += 4 + 4; // version and batch count
+
+    for (const auto& batch : manifest.batches) {
+        if (batch.path.size() > std::numeric_limits<uint16_t>::max()) {
+            throw std::invalid_argument(std::format(
+                "Path of {} bytes is too long for manifest, maximum is {}",
+                batch.path.size(),
+                std::numeric_limits<uint16_t>::max()));
+        }
+
+        if (batch.hashes.tree_hashes.size() > std::numeric_limits<uint16_t>::max()) {
+            throw std::invalid_argument(std::format(
+                "Batch {} has {} tree hashes, maximum is {}",
+                batch.path,
+                batch.hashes.tree_hashes.size(),
+                std::numeric_limits<uint16_t>::max()));
+        }
+
+        size_of_manifest += 2 + batch.path.size(); // path
+        size_of_manifest += 8 * 4;                 // size, mtime, file hash, root hash
+        size_of_manifest += 2 + batch.hashes.tree_hashes.size() * 8;
+    }
+
+    view.reserve(size_of_manifest);
+
+    append_le(view, static_cast<uint32_t>(manifest.version), 4);
+    append_le(view, manifest.batches.size(), 4);
+
+    // Iterate over batches
+    for (const auto& batch : manifest.batches) {
+        append_le(view, batch.path.size(), 2);
+        view.insert(view.end(), batch.path.begin(), batch.path.end());
+
+        append_le(view, batch.file_size, 8);
+        append_le(view, static_cast<uint64_t>(batch.file_mtime), 8);
+        append_le(view, batch.file_hash, 8);
+        append_le(view, batch.hashes.root_hash, 8);
+
+        append_le(view, batch.hashes.tree_hashes.size(), 2);
+        for (OptocHash tree_hash : batch.hashes.tree_hashes) {
+            append_le(view, tree_hash, 8);
+        }
+    }
+
+    return view;
+}
+
+
+
+
+// Static public method
+OptocManifest Manifest::parse_manifest(const OptocTreeView& view) {
+    std::span<const byte> span(view);
+
+    OptocManifest manifest{};
+
+    Codec::require(span, 0, 8);
+    manifest.version = static_cast<int32_t>(read_le(span, 0, 4));
+    std::size_t batch_count = read_le(span, 4, 4);
+    std::size_t offset = 8; // version and batch count are 8 bytes
+
+    // Every batch takes at least path size, 4 values and tree count, so a corrupted count can
+    // not make the reservation larger than the data allows
+    Codec::require(span, offset, batch_count * min_batch_size);
+    manifest.batches.reserve(batch_count);
+
+    // Iterate over batches
+    for (std::size_t i = 0; i < batch_count; ++i) {
+        OptocManifestBatch batch{};
+
+        Codec::require(span, offset, 2);
+        std::size_t path_size = read_le(span, offset, 2);
+        offset += 2; // Path size is 2 bytes
+
+        Codec::require(span, offset, path_size + 32 + 2); // path, 4 values and tree count
+        auto path = span.subspan(offset, path_size);
+        batch.path.assign(path.begin(), path.end());
+        offset += path_size;
+
+        batch.file_size = read_le(span, offset, 8);
+        batch.file_mtime = static_cast<int64_t>(read_le(span, offset + 8, 8));
+        batch.file_hash = read_le(span, offset + 16, 8);
+        batch.hashes.root_hash = read_le(span, offset + 24, 8);
+        offset += 32; // 4 values of 8 bytes
+
+        std::size_t tree_count = read_le(span, offset, 2);
+        offset += 2; // Tree count is 2 bytes
+
+        Codec::require(span, offset, tree_count * 8);
+        batch.hashes.tree_hashes.reserve(tree_count);
+        for (std::size_t tree = 0; tree < tree_count; ++tree) {
+            batch.hashes.tree_hashes.push_back(read_le(span, offset, 8));
+            offset += 8; // Hash is 8 bytes
+        }
+
+        manifest.batches.push_back(std::move(batch));
+    }
+
+    return manifest;
+}
+
+
+
+
+// Static private method
+OptocManifestBatch Manifest::hash_batch(const std::string_view path,
+                                        const OptocTreeView&   optoctreeview) {
+    OptocManifestBatch batch{};
+    batch.path = path;
+    batch.file_hash = Hasher::hash_bytes(optoctreeview);
+
+    Parser::parse_optoctree_batch(optoctreeview, batch.hashes);
+
+    return batch;
+}
+
+
+
+
+// Static private method
+void Manifest::append_le(OptocTreeView& buffer, uint64_t value, std::size_t size) {
+    for (std::size_t i = 0; i < size; ++i) {
+        buffer.push_back(static_cast<byte>((value >> (i * 8)) & 0xFF));
+    }
+}
+
+
+
+
+// Static private method
+uint64_t Manifest::read_le(std::span<const byte> buffer, size_t offset, std::size_t size) {
+    uint64_t result{0};
+
+    for (std::size_t i = 0; i < size; ++i) {
+        result |= static_cast<uint64_t>(buffer[offset + i]) << (i * 8);
+    }
+
+    return result;
+}
+
+} // namespace optoctreeparser
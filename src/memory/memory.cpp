@@ -0,0 +1,245 @@
+/**
+ * @brief Memory footprint of parsed optoctree data and its trimming
+ *
+ * @copyright maksimshchavelev © 2025 maksimshchavelev@gmail.com
+ * @license MIT
+ */
+
+#include "memory/memory.hpp"
+#include "octree/octree.hpp"
+
+namespace optoctreeparser {
+
+// Static public method
+OptocMemoryUsage Memory::of_tree(const OptocTree& tree) {
+    return {.used = sizeof(OptocTree) + tree.nodes.size() * sizeof(OptocNode),
+            .reserved = sizeof(OptocTree) + tree.nodes.capacity() * sizeof(OptocNode)};
+}
+
+
+
+
+// Static public method
+OptocMemoryUsage Memory::of_batch(const OptocRoot& batch) {
+    // Trees count their own `sizeof`, only the free slots of the vector are added here
+    std::size_t      free_slots = batch.trees.capacity() - batch.trees.size();
+    OptocMemoryUsage usage{.used = sizeof(OptocRoot),
+                           .reserved = sizeof(OptocRoot) + free_slots * sizeof(OptocTree)};
+
+    for (const auto& tree : batch.trees) {
+        add(usage, of_tree(tree));
+    }
+
+    return usage;
+}
+
+
+
+
+// Static public method
+OptocMemoryUsage Memory::of_batches(std::span<const OptocRoot> batches) {
+    OptocMemoryUsage usage{};
+
+    for (const auto& batch : batches) {
+        add(usage, of_batch(batch));
+    }
+
+    return usage;
+}
+
+
+
+
+// Static public method
+OptocMemoryUsage Memory::of_patch_tree(const OptocPatchTree& tree) {
+    return {.used = sizeof(OptocPatchTree) + tree.nodes.size() * sizeof(OptocNode),
+            .reserved = sizeof(OptocPatchTree) + tree.nodes.capacity() * sizeof(OptocNode)};
+}
+
+
+
+
+// Static public method
+OptocMemoryUsage Memory::of_patch_batch(const OptocPatchBatch& batch) {
+    std::size_t      free_slots = batch.octrees.capacity() - batch.octrees.size();
+    OptocMemoryUsage usage{.used = sizeof(OptocPatchBatch),
+                           .reserved =
+                               sizeof(OptocPatchBatch) + free_slots * sizeof(OptocPatchTree)};
+
+    for (const auto& tree : batch.octrees) {
+        add(usage, of_patch_tree(tree));
+    }
+
+    return usage;
+}
+
+
+
+
+// Static public method
+OptocMemoryUsage Memory::of_patch(const OptocPatchRoot& patch) {
+    std::size_t      free_slots = patch.batches.capacity() - patch.batches.size();
+    OptocMemoryUsage usage{.used = sizeof(OptocPatchRoot),
+                           .reserved =
+                               sizeof(OptocPatchRoot) + free_slots * sizeof(OptocPatchBatch)};
+
+    for (const auto& batch : patch.batches) {
+        add(usage, of_patch_batch(batch));
+    }
+
+    return usage;
+}
+
+
+
+
+// Static public method
+OptocMemoryUsage Memory::of_flat_patch(const OptocFlatPatchRoot& patch) {
+    return {.used = sizeof(OptocFlatPatchRoot) +
+                    patch.batches.size() * sizeof(OptocFlatPatchBatch) +
+                    patch.trees.size() * sizeof(OptocFlatPatchTree) +
+                    patch.nodes.size() * sizeof(OptocNode),
+            .reserved = sizeof(OptocFlatPatchRoot) +
+                        patch.batches.capacity() * sizeof(OptocFlatPatchBatch) +
+                        patch.trees.capacity() * sizeof(OptocFlatPatchTree) +
+                        patch.nodes.capacity() * sizeof(OptocNode)};
+}
+
+
+
+
+// Static public method
+std::size_t Memory::shrink(OptocTree& tree) {
+    OptocMemoryUsage before = of_tree(tree);
+    tree.nodes.shrink_to_fit();
+    return released(before, of_tree(tree));
+}
+
+
+
+
+// Static public method
+std::size_t Memory::shrink(OptocRoot& batch) {
+    OptocMemoryUsage before = of_batch(batch);
+
+    batch.trees.shrink_to_fit();
+    for (auto& tree : batch.trees) {
+        tree.nodes.shrink_to_fit();
+    }
+
+    return released(before, of_batch(batch));
+}
+
+
+
+
+// Static public method
+std::size_t Memory::shrink(OptocPatchRoot& patch) {
+    OptocMemoryUsage before = of_patch(patch);
+
+    patch.batches.shrink_to_fit();
+    for (auto& batch : patch.batches) {
+        batch.octrees.shrink_to_fit();
+        for (auto& tree : batch.octrees) {
+            tree.nodes.shrink_to_fit();
+        }
+    }
+
+    return released(before, of_patch(patch));
+}
+
+
+
+
+// Static public method
+std::size_t Memory::compact(OptocTree& tree) {
+    OptocMemoryUsage before = of_tree(tree);
+
+    if (tree.nodes.empty()) {
+        tree.nodes.shrink_to_fit();
+        tree.node_count = 0;
+        return released(before, of_tree(tree));
+    }
+
+    OptocTree compacted{};
+    compacted.nodes.push_back({}); // Root, children go after it
+
+    // Children shared by several parents would be duplicated, such trees are only shrunk
+    if (!copy_reachable(tree, 0, compacted, 0)) {
+        tree.nodes.shrink_to_fit();
+        return released(before, of_tree(tree));
+    }
+
+    compacted.nodes.shrink_to_fit();
+    compacted.node_count = static_cast<uint16_t>(compacted.nodes.size());
+    tree = std::move(compacted);
+
+    return released(before, of_tree(tree));
+}
+
+
+
+
+// Static public method
+std::size_t Memory::compact(OptocRoot& batch) {
+    OptocMemoryUsage before = of_batch(batch);
+
+    batch.trees.shrink_to_fit();
+    for (auto& tree : batch.trees) {
+        compact(tree);
+    }
+
+    return released(before, of_batch(batch));
+}
+
+
+
+
+// Static private method
+void Memory::add(OptocMemoryUsage& total, const OptocMemoryUsage& part) {
+    total.used += part.used;
+    total.reserved += part.reserved;
+}
+
+
+
+
+// Static private method
+bool Memory::copy_reachable(const OptocTree& source,
+                            std::size_t      node,
+                            OptocTree&       target,
+                            std::size_t      slot) {
+    target.nodes[slot] = source.nodes[node];
+
+    // Invalid links are leaves for every reader, so they are cleared
+    if (!Octree::has_children(source, node)) {
+        target.nodes[slot].first_child_node = 0;
+        return true;
+    }
+
+    // Children are contiguous, grandchildren are appended after them
+    std::size_t first_child = target.nodes.size();
+    if (first_child + Octree::children_count > source.nodes.size())
+        return false;
+
+    target.nodes.resize(first_child + Octree::children_count);
+    target.nodes[slot].first_child_node = static_cast<uint16_t>(first_child);
+
+    for (std::size_t child = 0; child < Octree::children_count; ++child) {
+        if (!copy_reachable(
+                source, source.nodes[node].first_child_node + child, target, first_child + child))
+            return false;
+    }
+
+    return true;
+}
+
+
+
+
+// Static private method
+std::size_t Memory::released(const OptocMemoryUsage& before, const OptocMemoryUsage& after) {
+    return before.reserved - after.reserved;
+}
+
+} // namespace optoctreeparser
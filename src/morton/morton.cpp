@@ -0,0 +1,197 @@
+/**
+ * @brief Morton-ordered (Z-curve) linear form of `OptocTree`
+ *
+ * @copyright maksimshchavelev © 2025 maksimshchavelev@gmail.com
+ * @license MIT
+ */
+
+#include "morton/morton.hpp"
+#include <algorithm>
+#include <format>
+#include <stdexcept>
+#include <tuple>
+
+namespace optoctreeparser {
+
+// Static public method
+uint16_t Morton::encode(const OptocVoxel& voxel) {
+    auto x = static_cast<std::size_t>(voxel.x);
+    auto y = static_cast<std::size_t>(voxel.y);
+    auto z = static_cast<std::size_t>(voxel.z);
+
+    std::size_t code{0};
+    for (std::size_t bit = 0; bit < Octree::max_depth; ++bit) {
+        code |= ((x >> bit) & 1) << (3 * bit);
+        code |= ((y >> bit) & 1) << (3 * bit + 1);
+        code |= ((z >> bit) & 1) << (3 * bit + 2);
+    }
+
+    return static_cast<uint16_t>(code);
+}
+
+
+
+
+// Static public method
+OptocVoxel Morton::decode(uint16_t code) {
+    OptocVoxel voxel{0, 0, 0};
+
+    for (std::size_t bit = 0; bit < Octree::max_depth; ++bit) {
+        OptocVoxel digit = Octree::child_offset(static_cast<std::size_t>(code >> (3 * bit)) & 7);
+        voxel.x |= digit.x << bit;
+        voxel.y |= digit.y << bit;
+        voxel.z |= digit.z << bit;
+    }
+
+    return voxel;
+}
+
+
+
+
+// Static public method
+std::vector<OptocMortonLeaf> Morton::linearize(const OptocTree& tree) {
+    std::vector<OptocMortonLeaf> leaves;
+    if (tree.nodes.empty())
+        return leaves;
+
+    leaves.reserve(tree.nodes.size());
+
+    // Node, Morton code of its first voxel and depth
+    std::vector<std::tuple<std::size_t, std::size_t, std::size_t>> stack{{0, 0, 0}};
+
+    while (!stack.empty()) {
+        auto [node, code, depth] = stack.back();
+        stack.pop_back();
+
+        if (depth < Octree::max_depth && Octree::has_children(tree, node)) {
+            std::size_t first_child = tree.nodes[node].first_child_node;
+
+            // Reverse order, so child 0 is popped first and leaves come out sorted
+            for (std::size_t child = Octree::children_count; child-- > 0;) {
+                std::size_t child_code = code + child * span_of(depth + 1);
+                stack.emplace_back(first_child + child, child_code, depth + 1);
+            }
+            continue;
+        }
+
+        const OptocNode& leaf = tree.nodes[node];
+        leaves.push_back({.code = static_cast<uint16_t>(code),
+                          .depth = static_cast<byte>(depth),
+                          .material_type = leaf.material_type,
+                          .signed_distance = leaf.signed_distance});
+    }
+
+    return leaves;
+}
+
+
+
+
+// Static public method
+OptocTree Morton::to_tree(std::span<const OptocMortonLeaf> leaves) {
+    OptocTree tree{};
+    if (leaves.empty())
+        return tree;
+
+    for (std::size_t i = 0; i < leaves.size(); ++i) {
+        if (leaves[i].depth > Octree::max_depth) {
+            throw std::invalid_argument(std::format(
+                "Leaf {} has depth {} greater than {}", i, leaves[i].depth, Octree::max_depth));
+        }
+
+        if (i > 0 && leaves[i].code <= leaves[i - 1].code) {
+            throw std::invalid_argument(std::format("Leaf {} is not sorted by Morton code", i));
+        }
+    }
+
+    tree.nodes.push_back({}); // Root, children go after it
+
+    OptocNode root = build(leaves, 0, 0, tree);
+    tree.nodes[0] = root;
+
+    tree.node_count = static_cast<uint16_t>(tree.nodes.size());
+    return tree;
+}
+
+
+
+
+// Static public method
+const OptocMortonLeaf* Morton::find(std::span<const OptocMortonLeaf> leaves,
+                                    const OptocVoxel&                voxel) {
+    // The leaf that contains voxel is the last one that starts at or before it
+    auto next = std::ranges::upper_bound(leaves, encode(voxel), {}, &OptocMortonLeaf::code);
+    return next == leaves.begin() ? nullptr : &*(next - 1);
+}
+
+
+
+
+// Static public method
+std::span<const OptocMortonLeaf> Morton::subtree(std::span<const OptocMortonLeaf> leaves,
+                                                 const OptocVoxel&                origin,
+                                                 std::size_t                      depth) {
+    std::size_t begin_code = encode(origin);
+    std::size_t end_code = begin_code + span_of(depth);
+
+    auto begin = std::ranges::lower_bound(leaves, begin_code, {}, &OptocMortonLeaf::code);
+    auto end = std::ranges::lower_bound(begin, leaves.end(), end_code, {}, &OptocMortonLeaf::code);
+
+    return {begin, end};
+}
+
+
+
+
+// Static private method
+std::size_t Morton::span_of(std::size_t depth) {
+    return std::size_t{1} << (3 * (Octree::max_depth - depth));
+}
+
+
+
+
+// Static private method
+OptocNode Morton::build(std::span<const OptocMortonLeaf> leaves,
+                        std::size_t                      code,
+                        std::size_t                      depth,
+                        OptocTree&                       tree) {
+    if (leaves.empty() || leaves.front().depth <= depth) {
+        bool exact = leaves.size() == 1 && leaves.front().code == code &&
+                     leaves.front().depth == depth;
+
+        if (!exact) {
+            throw std::invalid_argument(std::format(
+                "Leaves do not cover cube with Morton code {} at depth {} exactly", code, depth));
+        }
+
+        return {.material_type = leaves.front().material_type,
+                .signed_distance = leaves.front().signed_distance,
+                .first_child_node = 0};
+    }
+
+    // Children are contiguous, grandchildren are appended after them
+    std::size_t first_child = tree.nodes.size();
+    tree.nodes.resize(first_child + Octree::children_count);
+
+    std::size_t step = span_of(depth + 1);
+
+    for (std::size_t child = 0; child < Octree::children_count; ++child) {
+        std::size_t child_code = code + child * step;
+
+        // Leaves of child are the run of codes in [child_code, child_code + step)
+        auto begin = std::ranges::lower_bound(leaves, child_code, {}, &OptocMortonLeaf::code);
+        auto end = std::ranges::lower_bound(
+            begin, leaves.end(), child_code + step, {}, &OptocMortonLeaf::code);
+
+        OptocNode node = build({begin, end}, child_code, depth + 1, tree);
+
+        tree.nodes[first_child + child] = node;
+    }
+
+    return Octree::parent_of(std::span(tree.nodes).subspan(first_child, Octree::children_count),
+                             first_child);
+}
+
+} // namespace optoctreeparser
@@ -0,0 +1,128 @@
+/**
+ * @brief Helpers to walk the node structure of `OptocTree`
+ *
+ * @copyright maksimshchavelev © 2025 maksimshchavelev@gmail.com
+ * @license MIT
+ */
+
+#include "octree/octree.hpp"
+#include "signed_distance/signed_distance.hpp"
+#include <algorithm>
+#include <array>
+#include <utility>
+
+namespace optoctreeparser {
+
+// Public method
+std::size_t OptocBatchCoordinateHash::operator()(const OptocBatchCoordinate& coordinate) const {
+    auto x = static_cast<uint64_t>(static_cast<uint32_t>(coordinate.x));
+    auto y = static_cast<uint64_t>(static_cast<uint32_t>(coordinate.y));
+    auto z = static_cast<uint64_t>(static_cast<uint32_t>(coordinate.z));
+
+    // Multiply by large odd constants and mix high bits down, so that neighbours get far apart
+    uint64_t hash = (x * 0x9E3779B185EBCA87ULL) ^ (y * 0xC2B2AE3D27D4EB4FULL) ^
+                    (z * 0x165667B19E3779F9ULL);
+    hash ^= hash >> 29;
+
+    return hash;
+}
+
+
+
+
+// Static public method
+bool Octree::has_children(const OptocTree& tree, std::size_t node) {
+    std::size_t first_child = tree.nodes[node].first_child_node;
+    return first_child > node && first_child + children_count <= tree.nodes.size();
+}
+
+
+
+
+// Static public method
+std::size_t Octree::depth(const OptocTree& tree) {
+    if (tree.nodes.empty())
+        return 0;
+
+    std::size_t                                   max_depth{0};
+    std::vector<std::pair<std::size_t, std::size_t>> stack{{0, 0}}; // node and its depth
+
+    while (!stack.empty()) {
+        auto [node, node_depth] = stack.back();
+        stack.pop_back();
+
+        max_depth = std::max(max_depth, node_depth);
+
+        if (!has_children(tree, node))
+            continue;
+
+        for (std::size_t child = 0; child < children_count; ++child) {
+            stack.emplace_back(tree.nodes[node].first_child_node + child, node_depth + 1);
+        }
+    }
+
+    return max_depth;
+}
+
+
+
+
+// Static public method
+OptocVoxel Octree::child_offset(std::size_t child) {
+    return {static_cast<int32_t>(child & 1),
+            static_cast<int32_t>((child >> 1) & 1),
+            static_cast<int32_t>((child >> 2) & 1)};
+}
+
+
+
+
+// Static public method
+OptocVoxel Octree::tree_origin(std::size_t tree) {
+    return {static_cast<int32_t>((tree % trees_per_side) * tree_size),
+            static_cast<int32_t>((tree / trees_per_side % trees_per_side) * tree_size),
+            static_cast<int32_t>((tree / (trees_per_side * trees_per_side)) * tree_size)};
+}
+
+
+
+
+// Static public method
+std::size_t Octree::tree_index(const OptocVoxel& voxel) {
+    std::size_t x = static_cast<std::size_t>(voxel.x) / tree_size;
+    std::size_t y = static_cast<std::size_t>(voxel.y) / tree_size;
+    std::size_t z = static_cast<std::size_t>(voxel.z) / tree_size;
+    return x + trees_per_side * (y + trees_per_side * z);
+}
+
+
+
+
+// Static public method
+OptocNode Octree::parent_of(std::span<const OptocNode> children, std::size_t first_child) {
+    std::array<byte, children_count> materials{};
+    float                            distance_sum{0};
+
+    for (std::size_t child = 0; child < children_count; ++child) {
+        materials[child] = children[child].material_type;
+        distance_sum +=
+            SignedDistance::decode(children[child].signed_distance, children[child].material_type);
+    }
+
+    // Majority material of children. Ties go to the first child with that count
+    byte        majority = materials[0];
+    std::size_t majority_count = 0;
+    for (byte candidate : materials) {
+        auto count = static_cast<std::size_t>(std::ranges::count(materials, candidate));
+        if (count > majority_count) {
+            majority = candidate;
+            majority_count = count;
+        }
+    }
+
+    return {.material_type = majority,
+            .signed_distance = SignedDistance::encode(distance_sum / children_count),
+            .first_child_node = static_cast<uint16_t>(first_child)};
+}
+
+} // namespace optoctreeparser
@@ -5,125 +5,97 @@
  * @license MIT
  */
 
+#include "parser/codec.hpp"
 #include "parser/parser.hpp"
 #include <cstddef>
+#include <format>
+#include <stdexcept>
 
 namespace optoctreeparser {
 
 // Static public method
 OptocRoot Parser::parse_optoctree_batch(const OptocTreeView& optoctree) {
-    std::span<const byte> span(optoctree);
+    return parse_batch(optoctree, nullptr);
+}
 
-    OptocRoot batch{};
 
-    // Read version
-    batch.version = read_i32_le(span, 0);
 
-    // Iterates over optoctrees
-    size_t offset = 4;
-    batch.trees.reserve(125);
-    for (std::size_t i = 0; i < 125; ++i) {
-        OptocTree tree{};
 
-        tree.node_count = read_u16_le(span, offset);
-        tree.nodes.reserve(tree.node_count);
-        offset += 2; // count is 2 bytes
+// Static public method
+OptocRoot Parser::parse_optoctree_batch(const OptocTreeView& optoctree, OptocRootHashes& hashes) {
+    return parse_batch(optoctree, &hashes);
+}
+
 
-        for (std::size_t node_index = 0; node_index < tree.node_count; ++node_index) {
-            tree.nodes.push_back(read_node(span, offset));
-            offset += 4; // node size is 4
-        }
 
-        batch.trees.push_back(std::move(tree));
-    }
 
-    return batch;
+// Static public method
+OptocTreeView Parser::pack_optoctree_batch(const OptocRoot& batch) {
+    return Codec::write_batch(batch);
 }
 
 
 
 
 // Static public method
-OptocTreeView Parser::pack_optoctree_batch(const OptocRoot& batch) {
-    OptocTreeView optoctreeview;
+OptocPatchRoot Parser::parse_optoctreepatch(const OptocTreeView& optoctree) {
+    return Codec::read_patch(optoctree);
+}
 
-    // Counting size of batch
-    std::size_t size_of_batch{0};
-    size_of_batch += 4; // for version
 
-    for (const auto& tree : batch.trees) {
-        size_of_batch += sizeof(tree.node_count) + tree.nodes.size() * 4;
-    }
 
-    // Reserving
-    optoctreeview.resize(size_of_batch, 0x0);
-
-    // Packing
-    size_t          offset = 0;
-    std::span<byte> buffer(optoctreeview);
-    write_i32_le(buffer, offset, batch.version);
-    offset += 4; // version is 4 bytes
-
-    // Iterating over trees
-    for (const auto& tree : batch.trees) {
-        write_u16_le(buffer, offset, tree.node_count); // write node count
-        offset += 2;
-
-        // Write nodes
-        for (const auto& node : tree.nodes) {
-            write_node(buffer, offset, node);
-            offset += 4; // node is 4 bytes
-        }
-    }
 
-    return optoctreeview;
+// Static public method
+OptocTreeView Parser::pack_optoctreepatch(const OptocPatchRoot& patch) {
+    return Codec::write_patch(patch);
 }
 
 
 
 
 // Static public method
-OptocPatchRoot Parser::parse_optoctreepatch(const OptocTreeView& optoctree) {
+OptocFlatPatchRoot Parser::parse_optoctreepatch_flat(const OptocTreeView& optoctree) {
     std::span<const byte> span(optoctree);
 
-    OptocPatchRoot root{};
+    OptocFlatPatchRoot root{};
 
     // Read version
-    root.version = read_i32_le(span, 0);
-
-    // Iterates over batches
-    for (std::size_t offset = 4; offset < span.size();) {
-        OptocPatchBatch batch{};
-
-        batch.x_position = read_i16_le(span, offset);
-        offset += 2; // Position is 2 bytes
+    Codec::require(span, 0, Codec::version_size);
+    root.version = Codec::read_i32_le(span, 0);
 
-        batch.y_position = read_i16_le(span, offset);
-        offset += 2; // Position is 2 bytes
+    // One walk over headers gives exact sizes of all three buffers
+    Codec::PatchCounts counts = Codec::count_patch(span);
+    root.batches.reserve(counts.batches);
+    root.trees.reserve(counts.trees);
+    root.nodes.reserve(counts.nodes);
 
-        batch.z_position = read_i16_le(span, offset);
-        offset += 2; // Position is 2 bytes
+    // Iterates over batches
+    for (std::size_t offset = Codec::version_size; offset < span.size();) {
+        OptocPatchBatch header = Codec::read_patch_batch_header(span, offset);
+        offset += Codec::patch_batch_size;
 
-        batch.octree_count = span[offset];
-        ++offset; // Octree count is 1 byte
+        root.batches.push_back({.x_position = header.x_position,
+                                .y_position = header.y_position,
+                                .z_position = header.z_position,
+                                .octree_count = header.octree_count,
+                                .first_tree = static_cast<uint32_t>(root.trees.size())});
 
         // Iterate over octrees
-        for (std::size_t i = 0; i < batch.octree_count; ++i) {
-            OptocPatchTree tree{};
-
-            tree.octree_number = span[offset];
-            ++offset; // Octree number is 1 byte
+        for (std::size_t i = 0; i < header.octree_count; ++i) {
+            OptocPatchTree tree = Codec::read_patch_tree_header(span, offset);
+            offset += Codec::patch_tree_size;
 
-            tree.node_count = read_u16_le(span, offset);
-            offset += 2; // Node count is 2 bytes
+            root.trees.push_back({.octree_number = tree.octree_number,
+                                  .node_count = tree.node_count,
+                                  .first_node = static_cast<uint32_t>(root.nodes.size())});
 
-            tree.nodes.push_back(read_node(span, offset));
-            offset += 4; // Node is 4 bytes
+            Codec::require(span, offset, std::size_t{tree.node_count} * Codec::node_size);
 
-            batch.octrees.push_back(std::move(tree));
+            for (std::size_t node_index = 0; node_index < tree.node_count; ++node_index) {
+                root.nodes.push_back(Codec::read_node(span, offset));
+                offset += Codec::node_size;
+            }
         }
-
-        root.batches.push_back(std::move(batch));
     }
 
     return root;
@@ -133,67 +105,49 @@ OptocPatchRoot Parser::parse_optoctreepatch(const OptocTreeView& optoctree) {
 
 
 // Static public method
-OptocTreeView Parser::pack_optoctreepatch(const OptocPatchRoot& patch) {
-    OptocTreeView optoctreeview;
+OptocTreeView Parser::pack_optoctreepatch_flat(const OptocFlatPatchRoot& patch) {
+    validate_flat_patch(patch);
 
-    // Counting size of batch
-    std::size_t size_of_patch{0};
-    size_of_patch += 4; // for version
+    // Counting size of patch. Only trees and nodes referenced by batches are written
+    std::size_t size_of_patch{Codec::version_size};
 
-    // Iterate over batches
     for (const auto& batch : patch.batches) {
-        size_of_patch += sizeof(batch.x_position);
-        size_of_patch += sizeof(batch.y_position);
-        size_of_patch += sizeof(batch.z_position);
-        size_of_patch += sizeof(batch.octree_count);
+        size_of_patch += Codec::patch_batch_size;
 
-        // Iterate over octrees
-        for (const auto& octree : batch.octrees) {
-            size_of_patch += sizeof(octree.octree_number);
-            size_of_patch += sizeof(octree.node_count);
-            size_of_patch += octree.nodes.size() * 4; // Node is 4 bytes
+        for (std::size_t i = 0; i < batch.octree_count; ++i) {
+            std::size_t node_count = patch.trees[batch.first_tree + i].node_count;
+            size_of_patch += Codec::patch_tree_size + node_count * Codec::node_size;
         }
     }
 
-    // Resize and fill 0x00
-    optoctreeview.resize(size_of_patch, 0x00);
-
-    // Create span
+    OptocTreeView   optoctreeview(size_of_patch, 0x00);
     std::span<byte> buffer(optoctreeview);
+    std::size_t     offset{0};
 
-    // Offset is 0 for beginning
-    std::size_t offset{0};
+    Codec::write_i32_le(buffer, offset, patch.version);
+    offset += Codec::version_size;
 
-    // Write version
-    write_i32_le(buffer, offset, patch.version);
-    offset += 4; // Version is 4 bytes
-
-    // Iterate over batches
+    // Gather trees and nodes of every batch
     for (const auto& batch : patch.batches) {
-        write_i16_le(buffer, offset, batch.x_position);
-        offset += 2; // Position is 2 bytes
-
-        write_i16_le(buffer, offset, batch.y_position);
-        offset += 2; // Position is 2 bytes
+        Codec::write_patch_batch_header(buffer,
+                                        offset,
+                                        {.x_position = batch.x_position,
+                                         .y_position = batch.y_position,
+                                         .z_position = batch.z_position,
+                                         .octree_count = batch.octree_count,
+                                         .octrees = {}});
+        offset += Codec::patch_batch_size;
 
-        write_i16_le(buffer, offset, batch.z_position);
-        offset += 2; // Position is 2 bytes
-
-        buffer[offset] = batch.octree_count;
-        offset += 1; // Octree count is 1 byte
-
-        // Iterate over octrees
-        for (const auto& octree : batch.octrees) {
-            buffer[offset] = octree.octree_number;
-            offset += 1; // Octree number is 1 byte
+        for (std::size_t i = 0; i < batch.octree_count; ++i) {
+            const OptocFlatPatchTree& tree = patch.trees[batch.first_tree + i];
 
-            write_u16_le(buffer, offset, octree.node_count);
-            offset += 2; // Node is 2 bytes
+            Codec::write_patch_tree_header(buffer, offset, tree.octree_number, tree.node_count);
+            offset += Codec::patch_tree_size;
 
-            // Iterate over nodes
-            for (const auto& node : octree.nodes) {
-                write_node(buffer, offset, node);
-                offset += 4; // Node is 4 bytes
+            auto nodes = std::span(patch.nodes).subspan(tree.first_node, tree.node_count);
+            for (const auto& node : nodes) {
+                Codec::write_node(buffer, offset, node);
+                offset += Codec::node_size;
             }
         }
     }
@@ -204,82 +158,127 @@ OptocTreeView Parser::pack_optoctreepatch(const OptocPatchRoot& patch) {
 
 
 
-// Static private method
-uint16_t Parser::read_u16_le(std::span<const byte> buffer, size_t offset) {
-    uint16_t result = static_cast<uint16_t>(buffer[offset] | (buffer[offset + 1] << 8));
-    return result;
-}
+// Static public method
+OptocFlatPatchRoot Parser::flatten_patch(const OptocPatchRoot& patch) {
+    OptocFlatPatchRoot flat{.version = patch.version, .batches = {}, .trees = {}, .nodes = {}};
 
+    std::size_t tree_count{0};
+    std::size_t node_count{0};
+    for (const auto& batch : patch.batches) {
+        tree_count += batch.octrees.size();
+        for (const auto& tree : batch.octrees) {
+            node_count += tree.nodes.size();
+        }
+    }
 
+    flat.batches.reserve(patch.batches.size());
+    flat.trees.reserve(tree_count);
+    flat.nodes.reserve(node_count);
 
+    for (const auto& batch : patch.batches) {
+        flat.batches.push_back({.x_position = batch.x_position,
+                                .y_position = batch.y_position,
+                                .z_position = batch.z_position,
+                                .octree_count = static_cast<byte>(batch.octrees.size()),
+                                .first_tree = static_cast<uint32_t>(flat.trees.size())});
+
+        for (const auto& tree : batch.octrees) {
+            flat.trees.push_back({.octree_number = tree.octree_number,
+                                  .node_count = static_cast<uint16_t>(tree.nodes.size()),
+                                  .first_node = static_cast<uint32_t>(flat.nodes.size())});
+            flat.nodes.insert(flat.nodes.end(), tree.nodes.begin(), tree.nodes.end());
+        }
+    }
 
-// Static private method
-int16_t Parser::read_i16_le(std::span<const byte> buffer, size_t offset) {
-    int16_t result = static_cast<int16_t>(buffer[offset] | (buffer[offset + 1] << 8));
-    return result;
+    return flat;
 }
 
 
 
 
-// Static private method
-int32_t Parser::read_i32_le(std::span<const byte> buffer, size_t offset) {
-    int32_t result = static_cast<int32_t>(buffer[offset]) | (buffer[offset + 1] << 8) |
-                     (buffer[offset + 2] << 16) | (buffer[offset + 3] << 24);
-    return result;
-}
-
-
+// Static public method
+OptocPatchRoot Parser::expand_patch(const OptocFlatPatchRoot& patch) {
+    validate_flat_patch(patch);
+
+    OptocPatchRoot root{.version = patch.version, .batches = {}};
+    root.batches.reserve(patch.batches.size());
+
+    for (const auto& flat_batch : patch.batches) {
+        OptocPatchBatch batch{.x_position = flat_batch.x_position,
+                              .y_position = flat_batch.y_position,
+                              .z_position = flat_batch.z_position,
+                              .octree_count = flat_batch.octree_count,
+                              .octrees = {}};
+        batch.octrees.reserve(flat_batch.octree_count);
+
+        for (std::size_t i = 0; i < flat_batch.octree_count; ++i) {
+            const OptocFlatPatchTree& flat_tree = patch.trees[flat_batch.first_tree + i];
+            auto nodes = std::span(patch.nodes).subspan(flat_tree.first_node, flat_tree.node_count);
+
+            batch.octrees.push_back({.octree_number = flat_tree.octree_number,
+                                     .node_count = flat_tree.node_count,
+                                     .nodes = {nodes.begin(), nodes.end()}});
+        }
 
+        root.batches.push_back(std::move(batch));
+    }
 
-// Static private method
-void Parser::write_i32_le(std::span<byte> buffer, size_t offset, int32_t value) {
-    buffer[offset] = static_cast<byte>(value & 0xFF);
-    buffer[offset + 1] = static_cast<byte>((value >> 8) & 0xFF);
-    buffer[offset + 2] = static_cast<byte>((value >> 16) & 0xFF);
-    buffer[offset + 3] = static_cast<byte>((value >> 24) & 0xFF);
+    return root;
 }
 
 
 
 
-// Static private method
-void Parser::write_i16_le(std::span<byte> buffer, size_t offset, int16_t value) {
-    buffer[offset] = static_cast<byte>(value & 0xFF);
-    buffer[offset + 1] = static_cast<byte>((value >> 8) & 0xFF);
+// Static public method
+std::array<std::size_t, 126> Parser::find_tree_offsets(std::span<const byte> optoctree) {
+    return Codec::find_tree_offsets(optoctree);
 }
 
 
 
 
 // Static private method
-void Parser::write_u16_le(std::span<byte> buffer, size_t offset, uint16_t value) {
-    buffer[offset] = static_cast<byte>(value & 0xFF);
-    buffer[offset + 1] = static_cast<byte>((value >> 8) & 0xFF);
-}
+OptocRoot Parser::parse_batch(std::span<const byte> span, OptocRootHashes* hashes) {
+    if (hashes == nullptr)
+        return Codec::read_batch(span);
 
+    hashes->tree_hashes.clear();
+    hashes->tree_hashes.reserve(Codec::trees_per_batch);
 
+    // Trees are hashed from their encoded nodes while they are still in cache
+    OptocRoot batch =
+        Codec::read_batch(span, [hashes](const OptocTree& tree, std::span<const byte> nodes) {
+            hashes->tree_hashes.push_back(Hasher::hash_encoded_tree(tree.node_count, nodes));
+        });
 
-
-// Static private method
-OptocNode Parser::read_node(std::span<const byte> buffer, size_t offset) {
-    OptocNode node{};
-    node.material_type = buffer[offset];
-    node.signed_distance = buffer[offset + 1];
-    node.first_child_node = read_u16_le(buffer, offset + 2);
-    return node;
+    hashes->root_hash = Hasher::hash_root(batch.version, hashes->tree_hashes);
+    return batch;
 }
 
 
 
 
 // Static private method
-void Parser::write_node(std::span<byte> buffer, size_t offset, const OptocNode& node) {
-    buffer[offset] = node.material_type;
-    buffer[offset + 1] = node.signed_distance;
-    write_u16_le(buffer, offset + 2, node.first_child_node);
-}
-
+void Parser::validate_flat_patch(const OptocFlatPatchRoot& patch) {
+    for (const auto& batch : patch.batches) {
+        if (std::size_t{batch.first_tree} + batch.octree_count > patch.trees.size()) {
+            throw std::out_of_range(
+                std::format("Trees [{}, {}) of batch are outside of {} trees",
+                            batch.first_tree,
+                            std::size_t{batch.first_tree} + batch.octree_count,
+                            patch.trees.size()));
+        }
+    }
 
+    for (const auto& tree : patch.trees) {
+        if (std::size_t{tree.first_node} + tree.node_count > patch.nodes.size()) {
+            throw std::out_of_range(
+                std::format("Nodes [{}, {}) of tree are outside of {} nodes",
+                            tree.first_node,
+                            std::size_t{tree.first_node} + tree.node_count,
+                            patch.nodes.size()));
+        }
+    }
+}
 
 } // namespace optoctreeparser
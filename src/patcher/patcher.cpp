@@ -0,0 +1,248 @@
+/**
+ * @brief Applies `.optoctreepatch` to batches and builds patches that undo it
+ *
+ * @copyright maksimshchavelev © 2025 maksimshchavelev@gmail.com
+ * @license MIT
+ */
+
+#include "patcher/patcher.hpp"
+#include <format>
+#include <stdexcept>
+#include <type_traits>
+#include <unordered_map>
+
+namespace optoctreeparser {
+
+// Static public method
+void Patcher::apply(OptocRoot& batch, const OptocPatchBatch& patch_batch) {
+    validate(batch, patch_batch);
+
+    for (const auto& tree : patch_batch.octrees) {
+        batch.trees[tree.octree_number] = {.node_count = tree.node_count, .nodes = tree.nodes};
+    }
+}
+
+
+
+
+// Static public method
+void Patcher::apply(OptocWorld& world, const OptocPatchRoot& patch) {
+    apply_world(world, patch);
+}
+
+
+
+
+// Static public method
+void Patcher::apply(WorldIndex& world, const OptocPatchRoot& patch) {
+    apply_world(world, patch);
+}
+
+
+
+
+// Static public method
+OptocPatchBatch Patcher::apply_with_inverse(OptocRoot& batch, const OptocPatchBatch& patch_batch) {
+    validate(batch, patch_batch);
+
+    std::bitset<256> touched;
+    return apply_batch(batch, patch_batch, touched);
+}
+
+
+
+
+// Static public method
+OptocPatchRoot Patcher::apply_with_inverse(OptocWorld& world, const OptocPatchRoot& patch) {
+    return apply_world_with_inverse(world, patch);
+}
+
+
+
+
+// Static public method
+OptocPatchRoot Patcher::apply_with_inverse(WorldIndex& world, const OptocPatchRoot& patch) {
+    return apply_world_with_inverse(world, patch);
+}
+
+
+
+
+// Static public method
+OptocPatchRoot Patcher::make_inverse(const OptocWorld& world, const OptocPatchRoot& patch) {
+    return make_world_inverse(world, patch);
+}
+
+
+
+
+// Static public method
+OptocPatchRoot Patcher::make_inverse(const WorldIndex& world, const OptocPatchRoot& patch) {
+    return make_world_inverse(world, patch);
+}
+
+
+
+
+// Static private method
+OptocBatchCoordinate Patcher::coordinate_of(const OptocPatchBatch& patch_batch) {
+    return {patch_batch.x_position, patch_batch.y_position, patch_batch.z_position};
+}
+
+
+
+
+// Static private method
+void Patcher::validate(const OptocRoot& batch, const OptocPatchBatch& patch_batch) {
+    for (const auto& tree : patch_batch.octrees) {
+        if (tree.octree_number >= batch.trees.size()) {
+            throw std::out_of_range(std::format("Octree {} is absent from batch ({}, {}, {})",
+                                                tree.octree_number,
+                                                patch_batch.x_position,
+                                                patch_batch.y_position,
+                                                patch_batch.z_position));
+        }
+    }
+}
+
+
+
+
+// Static private method
+template <class World>
+auto& Patcher::find_batch(World& world, const OptocPatchBatch& patch_batch) {
+    OptocBatchCoordinate coordinate = coordinate_of(patch_batch);
+
+    if constexpr (std::is_same_v<std::remove_const_t<World>, OptocWorld>) {
+        if (auto found = world.find(coordinate); found != world.end())
+            return found->second;
+    } else {
+        if (auto* batch = world.find(coordinate))
+            return *batch;
+    }
+
+    throw std::out_of_range(std::format("Batch ({}, {}, {}) is absent from world",
+                                        patch_batch.x_position,
+                                        patch_batch.y_position,
+                                        patch_batch.z_position));
+}
+
+
+
+
+// Static private method
+template <class World> void Patcher::apply_world(World& world, const OptocPatchRoot& patch) {
+    // Check everything first, so a bad patch leaves the world as it was
+    for (const auto& patch_batch : patch.batches) {
+        validate(find_batch(world, patch_batch), patch_batch);
+    }
+
+    for (const auto& patch_batch : patch.batches) {
+        OptocRoot& batch = find_batch(world, patch_batch);
+
+        for (const auto& tree : patch_batch.octrees) {
+            batch.trees[tree.octree_number] = {.node_count = tree.node_count, .nodes = tree.nodes};
+        }
+    }
+}
+
+
+
+
+// Static private method
+template <class World>
+OptocPatchRoot Patcher::apply_world_with_inverse(World& world, const OptocPatchRoot& patch) {
+    for (const auto& patch_batch : patch.batches) {
+        validate(find_batch(world, patch_batch), patch_batch);
+    }
+
+    OptocPatchRoot inverse{.version = patch.version, .batches = {}};
+
+    // A batch may be patched several times, only the first original of every tree is kept
+    std::unordered_map<OptocBatchCoordinate, std::bitset<256>, OptocBatchCoordinateHash> touched;
+
+    for (const auto& patch_batch : patch.batches) {
+        OptocPatchBatch inverse_batch = apply_batch(
+            find_batch(world, patch_batch), patch_batch, touched[coordinate_of(patch_batch)]);
+
+        if (!inverse_batch.octrees.empty())
+            inverse.batches.push_back(std::move(inverse_batch));
+    }
+
+    return inverse;
+}
+
+
+
+
+// Static private method
+template <class World>
+OptocPatchRoot Patcher::make_world_inverse(const World& world, const OptocPatchRoot& patch) {
+    for (const auto& patch_batch : patch.batches) {
+        validate(find_batch(world, patch_batch), patch_batch);
+    }
+
+    OptocPatchRoot inverse{.version = patch.version, .batches = {}};
+    std::unordered_map<OptocBatchCoordinate, std::bitset<256>, OptocBatchCoordinateHash> touched;
+
+    for (const auto& patch_batch : patch.batches) {
+        const OptocRoot&  batch = find_batch(world, patch_batch);
+        std::bitset<256>& batch_touched = touched[coordinate_of(patch_batch)];
+
+        OptocPatchBatch inverse_batch{.x_position = patch_batch.x_position,
+                                      .y_position = patch_batch.y_position,
+                                      .z_position = patch_batch.z_position,
+                                      .octree_count = 0,
+                                      .octrees = {}};
+
+        for (const auto& tree : patch_batch.octrees) {
+            if (batch_touched.test(tree.octree_number))
+                continue;
+
+            batch_touched.set(tree.octree_number);
+
+            const OptocTree& original = batch.trees[tree.octree_number];
+            inverse_batch.octrees.push_back(
+                {tree.octree_number, original.node_count, original.nodes});
+        }
+
+        if (inverse_batch.octrees.empty())
+            continue;
+
+        inverse_batch.octree_count = static_cast<byte>(inverse_batch.octrees.size());
+        inverse.batches.push_back(std::move(inverse_batch));
+    }
+
+    return inverse;
+}
+
+
+
+
+// Static private method
+OptocPatchBatch Patcher::apply_batch(OptocRoot&             batch,
+                                     const OptocPatchBatch& patch_batch,
+                                     std::bitset<256>&      touched) {
+    OptocPatchBatch inverse{.x_position = patch_batch.x_position,
+                            .y_position = patch_batch.y_position,
+                            .z_position = patch_batch.z_position,
+                            .octree_count = 0,
+                            .octrees = {}};
+
+    for (const auto& tree : patch_batch.octrees) {
+        OptocTree& target = batch.trees[tree.octree_number];
+
+        if (!touched.test(tree.octree_number)) {
+            touched.set(tree.octree_number);
+            inverse.octrees.push_back(
+                {tree.octree_number, target.node_count, std::move(target.nodes)});
+        }
+
+        target = {.node_count = tree.node_count, .nodes = tree.nodes};
+    }
+
+    inverse.octree_count = static_cast<byte>(inverse.octrees.size());
+    return inverse;
+}
+
+} // namespace optoctreeparser
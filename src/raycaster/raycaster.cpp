@@ -0,0 +1,387 @@
+/**
+ * @brief Ray casting against batches and worlds
+ *
+ * @copyright maksimshchavelev © 2025 maksimshchavelev@gmail.com
+ * @license MIT
+ */
+
+#include "raycaster/raycaster.hpp"
+#include "detail/parallel.hpp"
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <stdexcept>
+#include <utility>
+
+namespace optoctreeparser {
+
+namespace {
+
+using Vector = std::array<float, 3>;
+using Cell = std::array<int64_t, 3>;
+
+constexpr auto tree_size = static_cast<float>(Octree::tree_size);
+constexpr auto trees_per_side = static_cast<int64_t>(Octree::trees_per_side);
+
+
+/**
+ * @brief Ray with normalized direction and its inverse, prepared for traversal
+ */
+struct PreparedRay {
+    Vector origin;
+    Vector direction;
+    Vector inverse; ///< `1 / direction`, infinite for zero components
+};
+
+
+PreparedRay prepare(const OptocRay& ray) {
+    const OptocPoint& d = ray.direction;
+    float             length = std::sqrt(d.x * d.x + d.y * d.y + d.z * d.z);
+
+    if (!(length > 0.0f) || !std::isfinite(length)) {
+        throw std::invalid_argument("Direction of ray must be finite and not zero");
+    }
+
+    PreparedRay prepared{.origin = {ray.origin.x, ray.origin.y, ray.origin.z},
+                         .direction = {d.x / length, d.y / length, d.z / length},
+                         .inverse = {}};
+
+    for (std::size_t axis = 0; axis < 3; ++axis) {
+        prepared.inverse[axis] = 1.0f / prepared.direction[axis];
+    }
+
+    return prepared;
+}
+
+
+/**
+ * @brief Narrows `[t0, t1]` to the part of ray inside cube `[low, low + size]`
+ * @return `false` if ray misses the cube within `[t0, t1]`
+ */
+bool clip(const PreparedRay& ray, const Vector& low, float size, float& t0, float& t1) {
+    for (std::size_t axis = 0; axis < 3; ++axis) {
+        float origin = ray.origin[axis];
+
+        // Parallel to the slab: either always inside or never
+        if (ray.direction[axis] == 0.0f) {
+            if (origin < low[axis] || origin > low[axis] + size)
+                return false;
+            continue;
+        }
+
+        float near = (low[axis] - origin) * ray.inverse[axis];
+        float far = (low[axis] + size - origin) * ray.inverse[axis];
+        if (near > far)
+            std::swap(near, far);
+
+        t0 = std::max(t0, near);
+        t1 = std::min(t1, far);
+    }
+
+    return t0 <= t1;
+}
+
+
+/**
+ * @brief Non-empty leaf hit inside tree
+ */
+struct LeafHit {
+    float            t;
+    const OptocNode* leaf;
+};
+
+
+/**
+ * @brief Finds the first non-empty leaf of node along ray within `[t0, t1]` (already clipped
+ * to the cube of node). Children are visited front to back
+ */
+std::optional<LeafHit> cast_node(const OptocTree&   tree,
+                                 std::size_t        node,
+                                 const Vector&      low,
+                                 float              size,
+                                 const PreparedRay& ray,
+                                 float              t0,
+                                 float              t1) {
+    if (size <= 1.0f || !Octree::has_children(tree, node)) {
+        const OptocNode& leaf = tree.nodes[node];
+        if (leaf.material_type == 0)
+            return std::nullopt;
+        return LeafHit{.t = t0, .leaf = &leaf};
+    }
+
+    struct Child {
+        float       t0;
+        float       t1;
+        std::size_t index;
+        Vector      low;
+    };
+
+    std::array<Child, Octree::children_count> children{};
+    std::size_t                               count{0};
+    float                                     half = size / 2;
+
+    for (std::size_t child = 0; child < Octree::children_count; ++child) {
+        OptocVoxel offset = Octree::child_offset(child);
+        Vector     child_low = {low[0] + static_cast<float>(offset.x) * half,
+                                low[1] + static_cast<float>(offset.y) * half,
+                                low[2] + static_cast<float>(offset.z) * half};
+
+        float child_t0 = t0;
+        float child_t1 = t1;
+        if (clip(ray, child_low, half, child_t0, child_t1))
+            children[count++] = {child_t0, child_t1, child, child_low};
+    }
+
+    // A ray crosses at most 4 children, sorting them by entry gives front to back order.
+    // Insertion sort: the run is tiny, and `std::sort` over a prefix of the array trips
+    // -Warray-bounds in GCC 12 at -O2
+    for (std::size_t i = 1; i < count; ++i) {
+        Child       child = children[i];
+        std::size_t j = i;
+        for (; j > 0 && child.t0 < children[j - 1].t0; --j) {
+            children[j] = children[j - 1];
+        }
+        children[j] = child;
+    }
+
+    std::size_t first_child = tree.nodes[node].first_child_node;
+    for (std::size_t i = 0; i < count; ++i) {
+        const Child& child = children[i];
+        if (auto hit = cast_node(
+                tree, first_child + child.index, child.low, half, ray, child.t0, child.t1)) {
+            return hit;
+        }
+    }
+
+    return std::nullopt;
+}
+
+
+/**
+ * @brief Walks cubes of trees along ray within `[t_start, t_end]` (3D DDA) and casts ray into
+ * every tree returned by `lookup(cell, batch, tree)`
+ */
+template <typename Lookup>
+std::optional<OptocRayHit>
+traverse(const PreparedRay& ray, float t_start, float t_end, Lookup&& lookup) {
+    Cell   cell{};
+    Cell   step{};
+    Vector t_max{};
+    Vector t_delta{};
+
+    for (std::size_t axis = 0; axis < 3; ++axis) {
+        float position = ray.origin[axis] + ray.direction[axis] * t_start;
+        cell[axis] = static_cast<int64_t>(std::floor(position / tree_size));
+
+        float low = static_cast<float>(cell[axis]) * tree_size;
+
+        if (ray.direction[axis] > 0.0f) {
+            step[axis] = 1;
+            t_max[axis] = (low + tree_size - ray.origin[axis]) * ray.inverse[axis];
+            t_delta[axis] = tree_size * ray.inverse[axis];
+        } else if (ray.direction[axis] < 0.0f) {
+            step[axis] = -1;
+            t_max[axis] = (low - ray.origin[axis]) * ray.inverse[axis];
+            t_delta[axis] = -tree_size * ray.inverse[axis];
+        } else {
+            t_max[axis] = Raycaster::infinity;
+            t_delta[axis] = Raycaster::infinity;
+        }
+    }
+
+    for (float t_cell = t_start; t_cell <= t_end;) {
+        std::size_t axis = static_cast<std::size_t>(
+            std::distance(t_max.begin(), std::ranges::min_element(t_max)));
+        float t_exit = t_max[axis];
+
+        OptocBatchCoordinate batch{};
+        std::size_t          tree_index{0};
+        const OptocTree*     tree = lookup(cell, batch, tree_index);
+
+        if (tree != nullptr && !tree->nodes.empty()) {
+            Vector low = {static_cast<float>(cell[0]) * tree_size,
+                          static_cast<float>(cell[1]) * tree_size,
+                          static_cast<float>(cell[2]) * tree_size};
+
+            float t0 = t_cell;
+            float t1 = std::min(t_exit, t_end);
+
+            if (clip(ray, low, tree_size, t0, t1)) {
+                if (auto hit = cast_node(*tree, 0, low, tree_size, ray, t0, t1)) {
+                    return OptocRayHit{
+                        .distance = hit->t,
+                        .position = {ray.origin[0] + ray.direction[0] * hit->t,
+                                     ray.origin[1] + ray.direction[1] * hit->t,
+                                     ray.origin[2] + ray.direction[2] * hit->t},
+                        .batch = batch,
+                        .tree = tree_index,
+                        .material_type = hit->leaf->material_type,
+                        .signed_distance = hit->leaf->signed_distance};
+                }
+            }
+        }
+
+        cell[axis] += step[axis];
+        t_max[axis] += t_delta[axis];
+        t_cell = t_exit;
+    }
+
+    return std::nullopt;
+}
+
+
+/**
+ * @brief Floor division for batch coordinates
+ */
+int64_t floor_div(int64_t value, int64_t divisor) {
+    int64_t quotient = value / divisor;
+    return (value % divisor != 0 && value < 0) ? quotient - 1 : quotient;
+}
+
+
+/**
+ * @brief Casts ray against world whose batches are returned by `find(coordinate)` (a pointer to
+ * batch or `nullptr`)
+ */
+template <typename Find>
+std::optional<OptocRayHit> cast_world(const OptocRay& ray, float max_distance, Find&& find) {
+    if (!std::isfinite(max_distance)) {
+        throw std::invalid_argument("Maximum distance of ray against world must be finite");
+    }
+
+    PreparedRay prepared = prepare(ray);
+
+    // Consecutive trees are usually in the same batch, so the last one found is kept
+    const OptocRoot*     last_batch = nullptr;
+    OptocBatchCoordinate last_coordinate{};
+    bool                 has_last = false;
+
+    auto lookup = [&](const Cell& cell, OptocBatchCoordinate& batch, std::size_t& tree) {
+        batch = {static_cast<int32_t>(floor_div(cell[0], trees_per_side)),
+                 static_cast<int32_t>(floor_div(cell[1], trees_per_side)),
+                 static_cast<int32_t>(floor_div(cell[2], trees_per_side))};
+
+        if (!has_last || batch != last_coordinate) {
+            last_batch = find(batch);
+            last_coordinate = batch;
+            has_last = true;
+        }
+
+        if (last_batch == nullptr)
+            return static_cast<const OptocTree*>(nullptr);
+
+        int64_t x = cell[0] - int64_t{batch.x} * trees_per_side;
+        int64_t y = cell[1] - int64_t{batch.y} * trees_per_side;
+        int64_t z = cell[2] - int64_t{batch.z} * trees_per_side;
+
+        tree = static_cast<std::size_t>(x + trees_per_side * (y + trees_per_side * z));
+        return tree < last_batch->trees.size() ? &last_batch->trees[tree] : nullptr;
+    };
+
+    return traverse(prepared, 0.0f, max_distance, lookup);
+}
+
+} // namespace
+
+
+// Static public method
+std::optional<OptocRayHit>
+Raycaster::cast(const OptocRoot& batch, const OptocRay& ray, float max_distance) {
+    PreparedRay prepared = prepare(ray);
+
+    float t_start = 0.0f;
+    float t_end = max_distance;
+    auto  batch_size = static_cast<float>(Octree::batch_size);
+
+    if (!clip(prepared, {0.0f, 0.0f, 0.0f}, batch_size, t_start, t_end))
+        return std::nullopt;
+
+    auto lookup = [&batch](const Cell& cell, OptocBatchCoordinate&, std::size_t& tree) {
+        for (int64_t coordinate : cell) {
+            if (coordinate < 0 || coordinate >= trees_per_side)
+                return static_cast<const OptocTree*>(nullptr);
+        }
+
+        tree = static_cast<std::size_t>(cell[0] +
+                                        trees_per_side * (cell[1] + trees_per_side * cell[2]));
+        return tree < batch.trees.size() ? &batch.trees[tree] : nullptr;
+    };
+
+    return traverse(prepared, t_start, t_end, lookup);
+}
+
+
+
+
+// Static public method
+std::optional<OptocRayHit>
+Raycaster::cast(const OptocWorld& world, const OptocRay& ray, float max_distance) {
+    return cast_world(ray, max_distance, [&world](const OptocBatchCoordinate& coordinate) {
+        auto found = world.find(coordinate);
+        return found == world.end() ? nullptr : &found->second;
+    });
+}
+
+
+
+
+// Static public method
+std::optional<OptocRayHit>
+Raycaster::cast(const WorldIndex& world, const OptocRay& ray, float max_distance) {
+    return cast_world(ray, max_distance, [&world](const OptocBatchCoordinate& coordinate) {
+        return world.find(coordinate);
+    });
+}
+
+
+
+
+// Static public method
+std::vector<std::optional<OptocRayHit>> Raycaster::cast(const OptocRoot&          batch,
+                                                        std::span<const OptocRay> rays,
+                                                        float                     max_distance,
+                                                        std::size_t               thread_count) {
+    std::vector<std::optional<OptocRayHit>> hits(rays.size());
+
+    detail::parallel_for(rays.size(), thread_count, [&](std::size_t ray) {
+        hits[ray] = cast(batch, rays[ray], max_distance);
+    });
+
+    return hits;
+}
+
+
+
+
+// Static public method
+std::vector<std::optional<OptocRayHit>> Raycaster::cast(const OptocWorld&         world,
+                                                        std::span<const OptocRay> rays,
+                                                        float                     max_distance,
+                                                        std::size_t               thread_count) {
+    std::vector<std::optional<OptocRayHit>> hits(rays.size());
+
+    detail::parallel_for(rays.size(), thread_count, [&](std::size_t ray) {
+        hits[ray] = cast(world, rays[ray], max_distance);
+    });
+
+    return hits;
+}
+
+
+
+
+// Static public method
+std::vector<std::optional<OptocRayHit>> Raycaster::cast(const WorldIndex&         world,
+                                                        std::span<const OptocRay> rays,
+                                                        float                     max_distance,
+                                                        std::size_t               thread_count) {
+    std::vector<std::optional<OptocRayHit>> hits(rays.size());
+
+    detail::parallel_for(rays.size(), thread_count, [&](std::size_t ray) {
+        hits[ray] = cast(world, rays[ray], max_distance);
+    });
+
+    return hits;
+}
+
+} // namespace optoctreeparser
@@ -0,0 +1,244 @@
+/**
+ * @brief Sampling of signed distance and material across batch borders
+ *
+ * @copyright maksimshchavelev © 2025 maksimshchavelev@gmail.com
+ * @license MIT
+ */
+
+#include "sampler/sampler.hpp"
+#include "signed_distance/signed_distance.hpp"
+#include <cmath>
+#include <cstdlib>
+#include <limits>
+
+namespace optoctreeparser {
+
+// Public constructor
+Sampler::Sampler(const WorldIndex& world) : world_(world) {
+    reset();
+}
+
+
+
+
+// Public method
+float Sampler::distance(const OptocPoint& point) {
+    // Voxel values are at centers, so the 8 nearest centers start at floor(point - 0.5)
+    float x = point.x - 0.5f;
+    float y = point.y - 0.5f;
+    float z = point.z - 0.5f;
+
+    float fx = std::floor(x);
+    float fy = std::floor(y);
+    float fz = std::floor(z);
+
+    // Batches exist only inside int16 range, so everything a batch past it is empty space. Clamp
+    // there before converting, a far (or NaN) point must not overflow int32
+    constexpr float low = (std::numeric_limits<int16_t>::min() - 1) * float{Octree::batch_size};
+    constexpr float high = (std::numeric_limits<int16_t>::max() + 1) * float{Octree::batch_size};
+
+    auto to_voxel = [&](float value) {
+        return static_cast<int32_t>(std::fmin(std::fmax(value, low), high));
+    };
+
+    OptocVoxel base{to_voxel(fx), to_voxel(fy), to_voxel(fz)};
+    float      tx = x - fx;
+    float      ty = y - fy;
+    float      tz = z - fz;
+
+    std::array<float, 8> corners{};
+    for (std::size_t corner = 0; corner < corners.size(); ++corner) {
+        OptocVoxel offset = Octree::child_offset(corner);
+        corners[corner] =
+            voxel_distance({base.x + offset.x, base.y + offset.y, base.z + offset.z});
+    }
+
+    // Interpolate along X, then Y, then Z. Corner `i` has offset bits in the same order
+    auto lerp = [](float a, float b, float t) { return a + (b - a) * t; };
+
+    float x00 = lerp(corners[0], corners[1], tx);
+    float x10 = lerp(corners[2], corners[3], tx);
+    float x01 = lerp(corners[4], corners[5], tx);
+    float x11 = lerp(corners[6], corners[7], tx);
+
+    return lerp(lerp(x00, x10, ty), lerp(x01, x11, ty), tz);
+}
+
+
+
+
+// Public method
+float Sampler::voxel_distance(const OptocVoxel& voxel) {
+    const CachedLeaf& leaf = leaf_at(voxel);
+    return SignedDistance::decode(leaf.signed_distance, leaf.material_type);
+}
+
+
+
+
+// Public method
+byte Sampler::material(const OptocVoxel& voxel) {
+    return leaf_at(voxel).material_type;
+}
+
+
+
+
+// Public method
+void Sampler::reset() {
+    center_ = {0, 0, 0};
+    window_ = {};
+    has_window_ = false;
+    cache_ = {};
+    last_ = 0;
+    next_ = 0;
+    hits_ = 0;
+    misses_ = 0;
+}
+
+
+
+
+// Public method
+std::size_t Sampler::cache_hits() const {
+    return hits_;
+}
+
+
+
+
+// Public method
+std::size_t Sampler::cache_misses() const {
+    return misses_;
+}
+
+
+
+
+// Private method
+const Sampler::CachedLeaf& Sampler::leaf_at(const OptocVoxel& voxel) {
+    auto contains = [&voxel](const CachedLeaf& leaf) {
+        return leaf.size > 0 && voxel.x >= leaf.origin.x && voxel.x < leaf.origin.x + leaf.size &&
+               voxel.y >= leaf.origin.y && voxel.y < leaf.origin.y + leaf.size &&
+               voxel.z >= leaf.origin.z && voxel.z < leaf.origin.z + leaf.size;
+    };
+
+    // The last leaf is the most likely one, then the rest of the cache
+    if (contains(cache_[last_])) {
+        ++hits_;
+        return cache_[last_];
+    }
+
+    for (std::size_t entry = 0; entry < cache_size; ++entry) {
+        if (contains(cache_[entry])) {
+            ++hits_;
+            last_ = entry;
+            return cache_[entry];
+        }
+    }
+
+    ++misses_;
+
+    // Empty space outside of every batch, it is not cached as it has no bounds
+    static constexpr CachedLeaf outside{
+        .origin = {0, 0, 0}, .size = 0, .material_type = 0, .signed_distance = 0};
+
+    auto batch_size = static_cast<int64_t>(Octree::batch_size);
+    auto tree_size = static_cast<int32_t>(Octree::tree_size);
+
+    // Batch and local arithmetic is in int64, products of far coordinates do not fit into int32
+    std::array<int64_t, 3> position{floor_div(voxel.x, batch_size),
+                                    floor_div(voxel.y, batch_size),
+                                    floor_div(voxel.z, batch_size)};
+
+    for (int64_t value : position) {
+        if (value < std::numeric_limits<int16_t>::min() ||
+            value > std::numeric_limits<int16_t>::max()) {
+            return outside;
+        }
+    }
+
+    // Inside int16 range of batches every voxel, origin and local offset fits into int32
+    OptocBatchCoordinate coordinate{static_cast<int32_t>(position[0]),
+                                    static_cast<int32_t>(position[1]),
+                                    static_cast<int32_t>(position[2])};
+    OptocVoxel           batch_origin{static_cast<int32_t>(position[0] * batch_size),
+                                      static_cast<int32_t>(position[1] * batch_size),
+                                      static_cast<int32_t>(position[2] * batch_size)};
+    OptocVoxel           local{static_cast<int32_t>(int64_t{voxel.x} - batch_origin.x),
+                               static_cast<int32_t>(int64_t{voxel.y} - batch_origin.y),
+                               static_cast<int32_t>(int64_t{voxel.z} - batch_origin.z)};
+
+    std::size_t tree_index = Octree::tree_index(local);
+    OptocVoxel  tree_origin = Octree::tree_origin(tree_index);
+
+    CachedLeaf leaf{.origin = {batch_origin.x + tree_origin.x,
+                               batch_origin.y + tree_origin.y,
+                               batch_origin.z + tree_origin.z},
+                    .size = tree_size,
+                    .material_type = 0,
+                    .signed_distance = 0};
+
+    const OptocRoot* batch = batch_at(coordinate);
+
+    // Absent batch or tree is empty space of the size of one tree
+    if (batch != nullptr && tree_index < batch->trees.size() &&
+        !batch->trees[tree_index].nodes.empty()) {
+        const OptocTree& tree = batch->trees[tree_index];
+        std::size_t      node = 0;
+
+        while (leaf.size > 1 && Octree::has_children(tree, node)) {
+            int32_t half = leaf.size / 2;
+            int32_t x = voxel.x - leaf.origin.x >= half ? 1 : 0;
+            int32_t y = voxel.y - leaf.origin.y >= half ? 1 : 0;
+            int32_t z = voxel.z - leaf.origin.z >= half ? 1 : 0;
+
+            node = tree.nodes[node].first_child_node +
+                   static_cast<std::size_t>(x | (y << 1) | (z << 2));
+            leaf.origin = {.x = leaf.origin.x + x * half,
+                           .y = leaf.origin.y + y * half,
+                           .z = leaf.origin.z + z * half};
+            leaf.size = half;
+        }
+
+        leaf.material_type = tree.nodes[node].material_type;
+        leaf.signed_distance = tree.nodes[node].signed_distance;
+    }
+
+    last_ = next_;
+    next_ = (next_ + 1) % cache_size;
+    cache_[last_] = leaf;
+
+    return cache_[last_];
+}
+
+
+
+
+// Private method
+const OptocRoot* Sampler::batch_at(const OptocBatchCoordinate& coordinate) {
+    int64_t dx = int64_t{coordinate.x} - center_.x;
+    int64_t dy = int64_t{coordinate.y} - center_.y;
+    int64_t dz = int64_t{coordinate.z} - center_.z;
+
+    // Slide the window so that the batch becomes its center
+    if (!has_window_ || std::abs(dx) > 1 || std::abs(dy) > 1 || std::abs(dz) > 1) {
+        center_ = coordinate;
+        window_ = world_.neighbourhood(coordinate);
+        has_window_ = true;
+        dx = dy = dz = 0;
+    }
+
+    return window_[static_cast<std::size_t>((dx + 1) + 3 * (dy + 1) + 9 * (dz + 1))];
+}
+
+
+
+
+// Static private method
+int64_t Sampler::floor_div(int64_t value, int64_t divisor) {
+    int64_t quotient = value / divisor;
+    return (value % divisor != 0 && value < 0) ? quotient - 1 : quotient;
+}
+
+} // namespace optoctreeparser
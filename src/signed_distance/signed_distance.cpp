@@ -0,0 +1,33 @@
+/**
+ * @brief Conversion of `OptocNode::signed_distance` to a number and back
+ *
+ * @copyright maksimshchavelev © 2025 maksimshchavelev@gmail.com
+ * @license MIT
+ */
+
+#include "signed_distance/signed_distance.hpp"
+#include <algorithm>
+#include <cmath>
+
+namespace optoctreeparser {
+
+// Static public method
+float SignedDistance::decode(byte signed_distance, byte material_type) {
+    if (signed_distance == 0)
+        return material_type != 0 ? max_inside : max_outside;
+
+    return std::clamp(static_cast<float>(surface) - static_cast<float>(signed_distance),
+                      max_inside,
+                      max_outside);
+}
+
+
+
+
+// Static public method
+byte SignedDistance::encode(float distance) {
+    float clamped = std::clamp(std::round(distance), max_inside, max_outside);
+    return static_cast<byte>(static_cast<float>(surface) - clamped);
+}
+
+} // namespace optoctreeparser
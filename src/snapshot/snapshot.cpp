@@ -0,0 +1,178 @@
+/**
+ * @brief Persistent copy-on-write batch with structurally shared trees
+ *
+ * @copyright maksimshchavelev © 2025 maksimshchavelev@gmail.com
+ * @license MIT
+ */
+
+#include "snapshot/snapshot.hpp"
+#include "hasher/hasher.hpp"
+#include <atomic>
+#include <unordered_map>
+
+namespace optoctreeparser {
+
+// Public constructor
+Snapshot::Snapshot() : version_(0), trees_(std::make_shared<Trees>()) {}
+
+
+
+
+// Public constructor
+Snapshot::Snapshot(OptocRoot root) : version_(root.version) {
+    auto trees = std::make_shared<Trees>();
+    trees->reserve(root.trees.size());
+
+    for (auto& tree : root.trees) {
+        trees->push_back(std::make_shared<OptocTree>(std::move(tree)));
+    }
+
+    trees_ = std::move(trees);
+}
+
+
+
+
+// Public method
+OptocRoot Snapshot::to_root() const {
+    OptocRoot root{};
+    root.version = version_;
+    root.trees.reserve(trees_->size());
+
+    for (const auto& tree : *trees_) {
+        root.trees.push_back(*tree);
+    }
+
+    return root;
+}
+
+
+
+
+// Public method
+int32_t Snapshot::version() const {
+    return version_;
+}
+
+
+
+
+// Public method
+void Snapshot::set_version(int32_t version) {
+    version_ = version;
+}
+
+
+
+
+// Public method
+std::size_t Snapshot::size() const {
+    return trees_->size();
+}
+
+
+
+
+// Public method
+const OptocTree& Snapshot::tree(std::size_t index) const {
+    return *(*trees_)[index];
+}
+
+
+
+
+// Public method
+const Snapshot::TreePointer& Snapshot::tree_pointer(std::size_t index) const {
+    return (*trees_)[index];
+}
+
+
+
+
+// Public method
+OptocTree& Snapshot::mutable_tree(std::size_t index) {
+    Trees& trees = own_trees();
+
+    // Shared tree is copied. Objects are created non-const, so const_cast of an owned one is safe
+    if (!is_unique(trees[index])) {
+        trees[index] = std::make_shared<OptocTree>(*trees[index]);
+    }
+
+    return const_cast<OptocTree&>(*trees[index]);
+}
+
+
+
+
+// Public method
+void Snapshot::set_tree(std::size_t index, OptocTree tree) {
+    set_tree(index, std::make_shared<OptocTree>(std::move(tree)));
+}
+
+
+
+
+// Static public method
+std::size_t Snapshot::deduplicate(std::span<Snapshot> snapshots) {
+    std::unordered_multimap<OptocHash, TreePointer> known;
+    std::size_t                                     shared{0};
+
+    for (auto& snapshot : snapshots) {
+        for (std::size_t index = 0; index < snapshot.size(); ++index) {
+            const TreePointer& tree = snapshot.tree_pointer(index);
+            OptocHash          hash = Hasher::hash_tree(*tree);
+
+            TreePointer replacement;
+            auto [begin, end] = known.equal_range(hash);
+            for (auto candidate = begin; candidate != end; ++candidate) {
+                if (candidate->second == tree || *candidate->second == *tree) {
+                    replacement = candidate->second;
+                    break;
+                }
+            }
+
+            if (!replacement) {
+                known.emplace(hash, tree);
+            } else if (replacement != tree) {
+                snapshot.set_tree(index, replacement);
+                ++shared;
+            }
+        }
+    }
+
+    return shared;
+}
+
+
+
+
+// Static private method
+template <typename T> bool Snapshot::is_unique(const std::shared_ptr<T>& pointer) {
+    if (pointer.use_count() != 1)
+        return false;
+
+    std::atomic_thread_fence(std::memory_order_acquire);
+    return true;
+}
+
+
+
+
+// Private method
+Snapshot::Trees& Snapshot::own_trees() {
+    if (!is_unique(trees_)) {
+        trees_ = std::make_shared<Trees>(*trees_);
+    }
+
+    return const_cast<Trees&>(*trees_);
+}
+
+
+
+
+// Private method
+void Snapshot::set_tree(std::size_t index, TreePointer tree) {
+    own_trees()[index] = std::move(tree);
+}
+
+} // namespace optoctreeparser
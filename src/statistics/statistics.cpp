@@ -0,0 +1,198 @@
+/**
+ * @brief Histograms and counters of materials, distances and tree shapes
+ *
+ * @copyright maksimshchavelev © 2025 maksimshchavelev@gmail.com
+ * @license MIT
+ */
+
+#include "statistics/statistics.hpp"
+#include "detail/parallel.hpp"
+#include "octree/octree.hpp"
+#include <algorithm>
+#include <cmath>
+#include <utility>
+
+namespace optoctreeparser {
+
+namespace {
+
+constexpr std::size_t lanes = 4; ///< Count of interleaved sub-histograms
+
+} // namespace
+
+
+/**
+ * Leaves of one material usually come in long runs, so a single histogram would make every
+ * increment wait for the previous store to the same counter. Consecutive leaves go to different
+ * sub-histograms instead, which are summed once at the end.
+ */
+struct Statistics::Histograms {
+    std::array<std::array<uint64_t, 256>, lanes> material_leaves{};
+    std::array<std::array<double, 256>, lanes>   material_volume{};
+    std::array<std::array<uint64_t, 256>, lanes> distance_leaves{};
+    std::size_t                                  lane{0};
+    OptocStatistics                              statistics{};
+};
+
+
+
+
+// Static public method
+OptocStatistics Statistics::of_tree(const OptocTree& tree) {
+    Histograms histograms{};
+    accumulate(tree, histograms);
+    return reduce(histograms);
+}
+
+
+
+
+// Static public method
+OptocStatistics Statistics::of_batch(const OptocRoot& batch) {
+    Histograms histograms{};
+
+    for (const auto& tree : batch.trees) {
+        accumulate(tree, histograms);
+    }
+
+    return reduce(histograms);
+}
+
+
+
+
+// Static public method
+std::vector<OptocStatistics> Statistics::of_batches(std::span<const OptocRoot> batches,
+                                                    std::size_t                thread_count) {
+    std::vector<OptocStatistics> statistics(batches.size());
+
+    detail::parallel_for(batches.size(), thread_count, [&](std::size_t index) {
+        statistics[index] = of_batch(batches[index]);
+    });
+
+    return statistics;
+}
+
+
+
+
+// Static public method
+OptocStatistics Statistics::of_world(std::span<const OptocRoot> batches, std::size_t thread_count) {
+    thread_count = detail::resolve_thread_count(thread_count, batches.size());
+
+    // One partial result per thread, merged at the end
+    std::vector<OptocStatistics> partial(thread_count);
+    std::size_t                  chunk = (batches.size() + thread_count - 1) / thread_count;
+
+    detail::parallel_for(thread_count, thread_count, [&](std::size_t part) {
+        std::size_t begin = std::min(batches.size(), part * chunk);
+        std::size_t end = std::min(batches.size(), begin + chunk);
+
+        for (std::size_t index = begin; index < end; ++index) {
+            merge(partial[part], of_batch(batches[index]));
+        }
+    });
+
+    OptocStatistics world{};
+    for (const auto& statistics : partial) {
+        merge(world, statistics);
+    }
+
+    return world;
+}
+
+
+
+
+// Static public method
+void Statistics::merge(OptocStatistics& into, const OptocStatistics& from) {
+    into.tree_count += from.tree_count;
+    into.leaf_count += from.leaf_count;
+    into.inner_count += from.inner_count;
+
+    for (std::size_t value = 0; value < 256; ++value) {
+        into.material_leaves[value] += from.material_leaves[value];
+        into.material_volume[value] += from.material_volume[value];
+        into.distance_leaves[value] += from.distance_leaves[value];
+    }
+
+    auto merge_vector = [](std::vector<uint64_t>& to, const std::vector<uint64_t>& add) {
+        if (to.size() < add.size())
+            to.resize(add.size(), 0);
+
+        for (std::size_t index = 0; index < add.size(); ++index) {
+            to[index] += add[index];
+        }
+    };
+
+    merge_vector(into.tree_depths, from.tree_depths);
+    merge_vector(into.leaf_depths, from.leaf_depths);
+}
+
+
+
+
+// Static private method
+void Statistics::accumulate(const OptocTree& tree, Histograms& histograms) {
+    OptocStatistics& statistics = histograms.statistics;
+    ++statistics.tree_count;
+
+    if (tree.nodes.empty())
+        return;
+
+    std::size_t                                      tree_depth{0};
+    std::vector<std::pair<std::size_t, std::size_t>> stack{{0, 0}}; // node and its depth
+
+    while (!stack.empty()) {
+        auto [node, depth] = stack.back();
+        stack.pop_back();
+
+        tree_depth = std::max(tree_depth, depth);
+
+        if (Octree::has_children(tree, node)) {
+            ++statistics.inner_count;
+
+            for (std::size_t child = 0; child < Octree::children_count; ++child) {
+                stack.emplace_back(tree.nodes[node].first_child_node + child, depth + 1);
+            }
+            continue;
+        }
+
+        const OptocNode& leaf = tree.nodes[node];
+        double           edge = std::ldexp(double{Octree::tree_size}, -static_cast<int>(depth));
+        std::size_t      lane = histograms.lane++ % lanes;
+
+        histograms.material_leaves[lane][leaf.material_type] += 1;
+        histograms.material_volume[lane][leaf.material_type] += edge * edge * edge;
+        histograms.distance_leaves[lane][leaf.signed_distance] += 1;
+        ++statistics.leaf_count;
+
+        if (statistics.leaf_depths.size() <= depth)
+            statistics.leaf_depths.resize(depth + 1, 0);
+        ++statistics.leaf_depths[depth];
+    }
+
+    if (statistics.tree_depths.size() <= tree_depth)
+        statistics.tree_depths.resize(tree_depth + 1, 0);
+    ++statistics.tree_depths[tree_depth];
+}
+
+
+
+
+// Static private method
+OptocStatistics Statistics::reduce(Histograms& histograms) {
+    OptocStatistics statistics = std::move(histograms.statistics);
+
+    for (std::size_t lane = 0; lane < lanes; ++lane) {
+        for (std::size_t value = 0; value < 256; ++value) {
+            statistics.material_leaves[value] += histograms.material_leaves[lane][value];
+            statistics.material_volume[value] += histograms.material_volume[lane][value];
+            statistics.distance_leaves[value] += histograms.distance_leaves[lane][value];
+        }
+    }
+
+    return statistics;
+}
+
+} // namespace optoctreeparser
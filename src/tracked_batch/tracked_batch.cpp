@@ -0,0 +1,192 @@
+/**
+ * @brief Batch that remembers its encoded bytes and which trees changed
+ *
+ * @copyright maksimshchavelev © 2025 maksimshchavelev@gmail.com
+ * @license MIT
+ */
+
+#include "tracked_batch/tracked_batch.hpp"
+#include "parser/codec.hpp"
+#include <cstring>
+#include <format>
+#include <span>
+#include <stdexcept>
+
+namespace optoctreeparser {
+
+// Public constructor
+TrackedBatch::TrackedBatch(OptocTreeView source) : source_(std::move(source)) {
+    root_ = Codec::read_batch(source_);
+    offsets_ = Codec::find_tree_offsets(source_);
+}
+
+
+
+
+// Public constructor
+TrackedBatch::TrackedBatch(OptocRoot root) : root_(std::move(root)) {
+    if (root_.trees.size() != Octree::trees_per_batch) {
+        throw std::invalid_argument(std::format(
+            "Batch must have {} trees, got {}", Octree::trees_per_batch, root_.trees.size()));
+    }
+
+    source_ = Codec::write_batch(root_);
+    offsets_ = Codec::find_tree_offsets(source_);
+}
+
+
+
+
+// Public method
+const OptocRoot& TrackedBatch::root() const {
+    return root_;
+}
+
+
+
+
+// Public method
+const OptocTreeView& TrackedBatch::source() const {
+    return source_;
+}
+
+
+
+
+// Public method
+int32_t TrackedBatch::version() const {
+    return root_.version;
+}
+
+
+
+
+// Public method
+void TrackedBatch::set_version(int32_t version) {
+    root_.version = version;
+}
+
+
+
+
+// Public method
+const OptocTree& TrackedBatch::tree(std::size_t index) const {
+    check_index(index);
+    return root_.trees[index];
+}
+
+
+
+
+// Public method
+OptocTree& TrackedBatch::mutable_tree(std::size_t index) {
+    check_index(index);
+    dirty_.set(index);
+    return root_.trees[index];
+}
+
+
+
+
+// Public method
+void TrackedBatch::set_tree(std::size_t index, OptocTree tree) {
+    mutable_tree(index) = std::move(tree);
+}
+
+
+
+
+// Public method
+bool TrackedBatch::is_dirty(std::size_t index) const {
+    check_index(index);
+    return dirty_.test(index);
+}
+
+
+
+
+// Public method
+std::size_t TrackedBatch::dirty_count() const {
+    return dirty_.count();
+}
+
+
+
+
+// Public method
+OptocTreeView TrackedBatch::pack() const {
+    // Size of clean trees is known from offsets, dirty trees are measured
+    std::size_t size = Codec::version_size;
+    for (std::size_t tree = 0; tree < Octree::trees_per_batch; ++tree) {
+        size += dirty_.test(tree) ? Codec::tree_header_size +
+                                        root_.trees[tree].nodes.size() * Codec::node_size
+                                  : offsets_[tree + 1] - offsets_[tree];
+    }
+
+    OptocTreeView   view(size);
+    std::span<byte> buffer(view);
+
+    Codec::write_i32_le(buffer, 0, root_.version);
+    std::size_t offset = Codec::version_size;
+
+    for (std::size_t tree = 0; tree < Octree::trees_per_batch;) {
+        if (!dirty_.test(tree)) {
+            // Run of clean trees is one range of the source
+            std::size_t end = tree + 1;
+            while (end < Octree::trees_per_batch && !dirty_.test(end)) {
+                ++end;
+            }
+
+            std::size_t length = offsets_[end] - offsets_[tree];
+            std::memcpy(view.data() + offset, source_.data() + offsets_[tree], length);
+
+            offset += length;
+            tree = end;
+            continue;
+        }
+
+        const OptocTree& dirty_tree = root_.trees[tree];
+
+        Codec::write_u16_le(buffer, offset, dirty_tree.node_count);
+        offset += Codec::tree_header_size;
+
+        for (const auto& node : dirty_tree.nodes) {
+            Codec::write_node(buffer, offset, node);
+            offset += Codec::node_size;
+        }
+
+        ++tree;
+    }
+
+    return view;
+}
+
+
+
+
+// Public method
+const OptocTreeView& TrackedBatch::repack() {
+    if (dirty_.none()) {
+        Codec::write_i32_le(source_, 0, root_.version);
+        return source_;
+    }
+
+    source_ = pack();
+    offsets_ = Codec::find_tree_offsets(source_);
+    dirty_.reset();
+
+    return source_;
+}
+
+
+
+
+// Static private method
+void TrackedBatch::check_index(std::size_t index) {
+    if (index >= Octree::trees_per_batch) {
+        throw std::out_of_range(std::format(
+            "Tree index {} is out of range, batch has {} trees", index, Octree::trees_per_batch));
+    }
+}
+
+} // namespace optoctreeparser
@@ -0,0 +1,206 @@
+/**
+ * @brief Summed-area tables of material volume for constant-time box queries
+ *
+ * @copyright maksimshchavelev © 2025 maksimshchavelev@gmail.com
+ * @license MIT
+ */
+
+#include "volume_index/volume_index.hpp"
+#include <algorithm>
+#include <bit>
+#include <cmath>
+#include <format>
+#include <stdexcept>
+
+namespace optoctreeparser {
+
+// Static public method
+OptocVolumeIndex VolumeIndex::build(const OptocRoot& batch, std::size_t cell_size) {
+    if (!std::has_single_bit(cell_size) || cell_size > Octree::tree_size) {
+        throw std::invalid_argument(std::format(
+            "Cell size must be a power of two up to {}, got {}", Octree::tree_size, cell_size));
+    }
+
+    OptocVolumeIndex index{};
+    index.cell_size = cell_size;
+    index.cells = Octree::batch_size / cell_size;
+    index.table_of_material.fill(-1);
+
+    // Rasterize leaves, cell (i, j, k) goes to table entry (i + 1, j + 1, k + 1)
+    std::size_t tree_count = std::min(batch.trees.size(), Octree::trees_per_batch);
+    for (std::size_t tree = 0; tree < tree_count; ++tree) {
+        if (batch.trees[tree].nodes.empty())
+            continue;
+
+        OptocVoxel origin = Octree::tree_origin(tree);
+        OptocPoint corner{static_cast<float>(origin.x),
+                          static_cast<float>(origin.y),
+                          static_cast<float>(origin.z)};
+
+        rasterize(batch.trees[tree], 0, corner, static_cast<float>(Octree::tree_size), index);
+    }
+
+    // 3D prefix sums, one axis at a time
+    std::size_t side = index.cells + 1;
+    for (auto& table : index.tables) {
+        for (std::size_t k = 0; k < side; ++k) {
+            for (std::size_t j = 0; j < side; ++j) {
+                for (std::size_t i = 1; i < side; ++i) {
+                    std::size_t at = i + side * (j + side * k);
+                    table[at] += table[at - 1];
+                }
+            }
+        }
+        for (std::size_t k = 0; k < side; ++k) {
+            for (std::size_t j = 1; j < side; ++j) {
+                for (std::size_t i = 0; i < side; ++i) {
+                    std::size_t at = i + side * (j + side * k);
+                    table[at] += table[at - side];
+                }
+            }
+        }
+        for (std::size_t k = 1; k < side; ++k) {
+            for (std::size_t j = 0; j < side; ++j) {
+                for (std::size_t i = 0; i < side; ++i) {
+                    std::size_t at = i + side * (j + side * k);
+                    table[at] += table[at - side * side];
+                }
+            }
+        }
+    }
+
+    return index;
+}
+
+
+
+
+// Static public method
+double VolumeIndex::volume(const OptocVolumeIndex& index,
+                           byte                    material_type,
+                           const OptocPoint&       min,
+                           const OptocPoint&       max) {
+    int16_t table_index = index.table_of_material[material_type];
+    if (table_index < 0 || max.x <= min.x || max.y <= min.y || max.z <= min.z)
+        return 0.0;
+
+    const auto& table = index.tables[static_cast<std::size_t>(table_index)];
+
+    // Inclusion-exclusion over 8 corners of the box
+    return cumulative(index, table, {max.x, max.y, max.z}) -
+           cumulative(index, table, {min.x, max.y, max.z}) -
+           cumulative(index, table, {max.x, min.y, max.z}) -
+           cumulative(index, table, {max.x, max.y, min.z}) +
+           cumulative(index, table, {min.x, min.y, max.z}) +
+           cumulative(index, table, {min.x, max.y, min.z}) +
+           cumulative(index, table, {max.x, min.y, min.z}) -
+           cumulative(index, table, {min.x, min.y, min.z});
+}
+
+
+
+
+// Static public method
+std::vector<byte> VolumeIndex::materials(const OptocVolumeIndex& index) {
+    std::vector<byte> materials;
+
+    for (std::size_t material = 0; material < index.table_of_material.size(); ++material) {
+        if (index.table_of_material[material] >= 0)
+            materials.push_back(static_cast<byte>(material));
+    }
+
+    return materials;
+}
+
+
+
+
+// Static private method
+void VolumeIndex::rasterize(const OptocTree&  tree,
+                            std::size_t       node,
+                            const OptocPoint& origin,
+                            float             edge,
+                            OptocVolumeIndex& index) {
+    if (Octree::has_children(tree, node)) {
+        std::size_t first_child = tree.nodes[node].first_child_node;
+        float       half = edge / 2;
+
+        for (std::size_t child = 0; child < Octree::children_count; ++child) {
+            OptocVoxel offset = Octree::child_offset(child);
+            rasterize(tree,
+                      first_child + child,
+                      {origin.x + static_cast<float>(offset.x) * half,
+                       origin.y + static_cast<float>(offset.y) * half,
+                       origin.z + static_cast<float>(offset.z) * half},
+                      half,
+                      index);
+        }
+        return;
+    }
+
+    byte material = tree.nodes[node].material_type;
+    if (index.table_of_material[material] < 0) {
+        index.table_of_material[material] = static_cast<int16_t>(index.tables.size());
+        index.tables.emplace_back((index.cells + 1) * (index.cells + 1) * (index.cells + 1), 0.0);
+    }
+
+    auto&       table = index.tables[static_cast<std::size_t>(index.table_of_material[material])];
+    auto        cell = static_cast<float>(index.cell_size);
+    std::size_t side = index.cells + 1;
+
+    // Sizes are powers of two, so leaf covers whole cells or its whole volume is inside one cell
+    auto first = [cell](float coordinate) { return static_cast<std::size_t>(coordinate / cell); };
+    std::size_t count = edge >= cell ? static_cast<std::size_t>(edge / cell) : 1;
+    double      volume = edge >= cell ? double{cell} * cell * cell : double{edge} * edge * edge;
+
+    std::size_t i0 = first(origin.x);
+    std::size_t j0 = first(origin.y);
+    std::size_t k0 = first(origin.z);
+
+    for (std::size_t k = k0; k < k0 + count; ++k) {
+        for (std::size_t j = j0; j < j0 + count; ++j) {
+            for (std::size_t i = i0; i < i0 + count; ++i) {
+                table[(i + 1) + side * ((j + 1) + side * (k + 1))] += volume;
+            }
+        }
+    }
+}
+
+
+
+
+// Static private method
+double VolumeIndex::cumulative(const OptocVolumeIndex&    index,
+                               const std::vector<double>& table,
+                               const OptocPoint&          point) {
+    std::size_t side = index.cells + 1;
+    auto        cells = static_cast<float>(index.cells);
+    auto        cell = static_cast<float>(index.cell_size);
+
+    // Cell of corner and position inside it. Cumulative volume is trilinear inside a cell
+    auto split = [&](float coordinate) {
+        float u = std::clamp(coordinate / cell, 0.0f, cells);
+        float base = std::min(std::floor(u), cells - 1);
+        return std::pair{static_cast<std::size_t>(base), static_cast<double>(u - base)};
+    };
+
+    auto [i, fx] = split(point.x);
+    auto [j, fy] = split(point.y);
+    auto [k, fz] = split(point.z);
+
+    auto at = [&](std::size_t di, std::size_t dj, std::size_t dk) {
+        return table[(i + di) + side * ((j + dj) + side * (k + dk))];
+    };
+
+    double c00 = at(0, 0, 0) * (1 - fx) + at(1, 0, 0) * fx;
+    double c10 = at(0, 1, 0) * (1 - fx) + at(1, 1, 0) * fx;
+    double c01 = at(0, 0, 1) * (1 - fx) + at(1, 0, 1) * fx;
+    double c11 = at(0, 1, 1) * (1 - fx) + at(1, 1, 1) * fx;
+
+    double c0 = c00 * (1 - fy) + c10 * fy;
+    double c1 = c01 * (1 - fy) + c11 * fy;
+
+    return c0 * (1 - fz) + c1 * fz;
+}
+
+} // namespace optoctreeparser
@@ -0,0 +1,379 @@
+/**
+ * @brief Sparse hash index of the batches of a world
+ *
+ * @copyright maksimshchavelev © 2025 maksimshchavelev@gmail.com
+ * @license MIT
+ */
+
+#include "world_index/world_index.hpp"
+#include <algorithm>
+#include <bit>
+#include <format>
+#include <limits>
+#include <optional>
+#include <stdexcept>
+#include <utility>
+
+namespace optoctreeparser {
+
+// Public constructor
+WorldIndex::WorldIndex(std::size_t capacity) {
+    rehash(16);
+    reserve(capacity);
+}
+
+
+
+
+// Public method
+OptocRoot& WorldIndex::insert(const OptocBatchCoordinate& coordinate, OptocRoot batch) {
+    uint64_t key = pack(coordinate);
+    if (key == empty_key) {
+        throw std::out_of_range(std::format("Batch coordinate ({}, {}, {}) does not fit into int16",
+                                            coordinate.x,
+                                            coordinate.y,
+                                            coordinate.z));
+    }
+
+    std::size_t slot = find_slot(key);
+    if (slots_[slot].key == key) {
+        batches_[slots_[slot].index] = std::move(batch);
+        return batches_[slots_[slot].index];
+    }
+
+    // Keep the table at most half full
+    if ((batches_.size() + 1) * 2 > slots_.size()) {
+        rehash(slots_.size() * 2);
+        slot = find_slot(key);
+    }
+
+    slots_[slot] = {key, batches_.size()};
+    coordinates_.push_back(coordinate);
+    batches_.push_back(std::move(batch));
+
+    return batches_.back();
+}
+
+
+
+
+// Public method
+OptocRoot* WorldIndex::find(const OptocBatchCoordinate& coordinate) {
+    return const_cast<OptocRoot*>(std::as_const(*this).find(coordinate));
+}
+
+
+
+
+// Public method
+const OptocRoot* WorldIndex::find(const OptocBatchCoordinate& coordinate) const {
+    uint64_t key = pack(coordinate);
+    if (key == empty_key)
+        return nullptr;
+
+    const Slot& slot = slots_[find_slot(key)];
+    return slot.key == key ? &batches_[slot.index] : nullptr;
+}
+
+
+
+
+// Public method
+bool WorldIndex::erase(const OptocBatchCoordinate& coordinate) {
+    uint64_t key = pack(coordinate);
+    if (key == empty_key)
+        return false;
+
+    std::size_t hole = find_slot(key);
+    if (slots_[hole].key != key)
+        return false;
+
+    // Move the last batch into the place of the erased one
+    std::size_t index = slots_[hole].index;
+    std::size_t last = batches_.size() - 1;
+
+    if (index != last) {
+        slots_[find_slot(pack(coordinates_[last]))].index = index;
+        coordinates_[index] = coordinates_[last];
+        batches_[index] = std::move(batches_[last]);
+    }
+
+    coordinates_.pop_back();
+    batches_.pop_back();
+
+    // Backward shift: move following entries of the probe chain into the hole
+    std::size_t mask = slots_.size() - 1;
+    for (std::size_t next = (hole + 1) & mask; slots_[next].key != empty_key;
+         next = (next + 1) & mask) {
+        std::size_t ideal = home(slots_[next].key, mask);
+
+        // Entry can move back if its home is not in (hole, next] (cyclically)
+        if (((next - ideal) & mask) >= ((next - hole) & mask)) {
+            slots_[hole] = slots_[next];
+            hole = next;
+        }
+    }
+
+    slots_[hole] = {empty_key, 0};
+    return true;
+}
+
+
+
+
+// Public method
+std::size_t WorldIndex::size() const {
+    return batches_.size();
+}
+
+
+
+
+// Public method
+void WorldIndex::reserve(std::size_t capacity) {
+    coordinates_.reserve(capacity);
+    batches_.reserve(capacity);
+
+    if (capacity * 2 > slots_.size())
+        rehash(std::bit_ceil(capacity * 2));
+}
+
+
+
+
+// Public method
+std::span<const OptocBatchCoordinate> WorldIndex::coordinates() const {
+    return coordinates_;
+}
+
+
+
+
+// Public method
+std::span<const OptocRoot> WorldIndex::batches() const {
+    return batches_;
+}
+
+
+
+
+// Public method
+OptocNeighbourhood WorldIndex::neighbourhood(const OptocBatchCoordinate& coordinate) const {
+    OptocNeighbourhood neighbourhood{};
+
+    for (int32_t dz = -1; dz <= 1; ++dz) {
+        for (int32_t dy = -1; dy <= 1; ++dy) {
+            for (int32_t dx = -1; dx <= 1; ++dx) {
+                auto index = static_cast<std::size_t>((dx + 1) + 3 * (dy + 1) + 9 * (dz + 1));
+                if (auto neighbour = neighbour_of(coordinate, dx, dy, dz))
+                    neighbourhood[index] = find(*neighbour);
+            }
+        }
+    }
+
+    return neighbourhood;
+}
+
+
+
+
+// Public method
+void WorldIndex::for_each_neighbour(
+    const OptocBatchCoordinate&                                                coordinate,
+    Connectivity                                                               connectivity,
+    const std::function<void(const OptocBatchCoordinate&, const OptocRoot&)>& function) const {
+    for (int32_t dz = -1; dz <= 1; ++dz) {
+        for (int32_t dy = -1; dy <= 1; ++dy) {
+            for (int32_t dx = -1; dx <= 1; ++dx) {
+                int32_t distance = std::abs(dx) + std::abs(dy) + std::abs(dz);
+
+                // Skip the center, and edges and corners for face connectivity
+                if (distance == 0 || (connectivity == Connectivity::six && distance > 1))
+                    continue;
+
+                auto neighbour = neighbour_of(coordinate, dx, dy, dz);
+                if (!neighbour)
+                    continue;
+
+                if (const OptocRoot* batch = find(*neighbour))
+                    function(*neighbour, *batch);
+            }
+        }
+    }
+}
+
+
+
+
+// Public method
+std::vector<OptocBatchCoordinate> WorldIndex::region(const OptocBatchCoordinate& min,
+                                                     const OptocBatchCoordinate& max) const {
+    constexpr int32_t key_low = std::numeric_limits<int16_t>::min();
+    constexpr int32_t key_high = std::numeric_limits<int16_t>::max();
+
+    if (min.x > max.x || min.y > max.y || min.z > max.z)
+        return {};
+
+    if (max.x < key_low || max.y < key_low || max.z < key_low || min.x > key_high ||
+        min.y > key_high || min.z > key_high) {
+        return {};
+    }
+
+    // Batches exist only inside int16 range, so the box is clamped to it. Offsets then take at
+    // most 16 bits and the volume at most 48
+    auto clamp = [&](int32_t value) { return std::clamp(value, key_low, key_high); };
+    OptocBatchCoordinate low{clamp(min.x), clamp(min.y), clamp(min.z)};
+    OptocBatchCoordinate high{clamp(max.x), clamp(max.y), clamp(max.z)};
+
+    std::vector<std::pair<uint64_t, OptocBatchCoordinate>> found;
+
+    auto offset = [](int32_t value, int32_t from) {
+        return static_cast<uint64_t>(int64_t{value} - int64_t{from});
+    };
+    auto add = [&](const OptocBatchCoordinate& coordinate) {
+        found.emplace_back(morton_code(offset(coordinate.x, low.x),
+                                       offset(coordinate.y, low.y),
+                                       offset(coordinate.z, low.z)),
+                           coordinate);
+    };
+
+    auto inside = [&](const OptocBatchCoordinate& coordinate) {
+        return coordinate.x >= low.x && coordinate.x <= high.x && coordinate.y >= low.y &&
+               coordinate.y <= high.y && coordinate.z >= low.z && coordinate.z <= high.z;
+    };
+
+    uint64_t volume = (offset(high.x, low.x) + 1) * (offset(high.y, low.y) + 1) *
+                      (offset(high.z, low.z) + 1);
+
+    // Probe every coordinate of a small box, scan all batches for a big one
+    if (volume <= batches_.size()) {
+        for (int32_t z = low.z; z <= high.z; ++z) {
+            for (int32_t y = low.y; y <= high.y; ++y) {
+                for (int32_t x = low.x; x <= high.x; ++x) {
+                    if (find({x, y, z}) != nullptr)
+                        add({x, y, z});
+                }
+            }
+        }
+    } else {
+        for (const auto& coordinate : coordinates_) {
+            if (inside(coordinate))
+                add(coordinate);
+        }
+    }
+
+    std::ranges::sort(found, {}, &std::pair<uint64_t, OptocBatchCoordinate>::first);
+
+    std::vector<OptocBatchCoordinate> result;
+    result.reserve(found.size());
+    for (const auto& [code, coordinate] : found) {
+        result.push_back(coordinate);
+    }
+
+    return result;
+}
+
+
+
+
+// Static private method
+uint64_t WorldIndex::pack(const OptocBatchCoordinate& coordinate) {
+    constexpr int32_t low = std::numeric_limits<int16_t>::min();
+    constexpr int32_t high = std::numeric_limits<int16_t>::max();
+
+    for (int32_t value : {coordinate.x, coordinate.y, coordinate.z}) {
+        if (value < low || value > high)
+            return empty_key;
+    }
+
+    return static_cast<uint64_t>(static_cast<uint16_t>(coordinate.x)) |
+           (static_cast<uint64_t>(static_cast<uint16_t>(coordinate.y)) << 16) |
+           (static_cast<uint64_t>(static_cast<uint16_t>(coordinate.z)) << 32);
+}
+
+
+
+
+// Static private method
+std::optional<OptocBatchCoordinate> WorldIndex::neighbour_of(const OptocBatchCoordinate& coordinate,
+                                                             int32_t                     dx,
+                                                             int32_t                     dy,
+                                                             int32_t                     dz) {
+    constexpr int64_t low = std::numeric_limits<int16_t>::min();
+    constexpr int64_t high = std::numeric_limits<int16_t>::max();
+
+    // Sum in int64, coordinates at the edge of int32 would overflow
+    std::array<int64_t, 3> sum{
+        int64_t{coordinate.x} + dx, int64_t{coordinate.y} + dy, int64_t{coordinate.z} + dz};
+
+    for (int64_t value : sum) {
+        if (value < low || value > high)
+            return std::nullopt;
+    }
+
+    return OptocBatchCoordinate{static_cast<int32_t>(sum[0]),
+                                static_cast<int32_t>(sum[1]),
+                                static_cast<int32_t>(sum[2])};
+}
+
+
+
+
+// Static private method
+std::size_t WorldIndex::home(uint64_t key, std::size_t mask) {
+    // Finalizer of SplitMix64, neighbouring coordinates land in unrelated slots
+    key ^= key >> 30;
+    key *= 0xBF58476D1CE4E5B9ULL;
+    key ^= key >> 27;
+    key *= 0x94D049BB133111EBULL;
+    key ^= key >> 31;
+
+    return key & mask;
+}
+
+
+
+
+// Static private method
+uint64_t WorldIndex::morton_code(uint64_t x, uint64_t y, uint64_t z) {
+    uint64_t code{0};
+
+    // Offsets inside int16 range take at most 16 bits
+    for (std::size_t bit = 0; bit < 16; ++bit) {
+        code |= ((x >> bit) & 1) << (3 * bit);
+        code |= ((y >> bit) & 1) << (3 * bit + 1);
+        code |= ((z >> bit) & 1) << (3 * bit + 2);
+    }
+
+    return code;
+}
+
+
+
+
+// Private method
+std::size_t WorldIndex::find_slot(uint64_t key) const {
+    std::size_t mask = slots_.size() - 1;
+    std::size_t slot = home(key, mask);
+
+    while (slots_[slot].key != key && slots_[slot].key != empty_key) {
+        slot = (slot + 1) & mask;
+    }
+
+    return slot;
+}
+
+
+
+
+// Private method
+void WorldIndex::rehash(std::size_t capacity) {
+    slots_.assign(capacity, Slot{empty_key, 0});
+
+    for (std::size_t index = 0; index < coordinates_.size(); ++index) {
+        uint64_t key = pack(coordinates_[index]);
+        slots_[find_slot(key)] = {key, index};
+    }
+}
+
+} // namespace optoctreeparser
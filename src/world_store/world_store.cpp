@@ -0,0 +1,243 @@
+/**
+ * @brief Thread-safe store of the batches of a world
+ *
+ * @copyright maksimshchavelev © 2025 maksimshchavelev@gmail.com
+ * @license MIT
+ */
+
+#include "world_store/world_store.hpp"
+#include <algorithm>
+
+namespace optoctreeparser {
+
+// Public constructor
+WorldStore::WorldStore(std::size_t shard_count) {
+    shards_.resize(std::max<std::size_t>(1, shard_count));
+
+    for (auto& shard : shards_) {
+        shard = std::make_unique<Shard>();
+        shard->map.store(std::make_shared<const Map>());
+    }
+}
+
+
+
+
+// Public method
+WorldStore::BatchPointer WorldStore::find(const OptocBatchCoordinate& coordinate) const {
+    while (true) {
+        std::shared_ptr<Slot> slot = find_slot(coordinate);
+        if (!slot)
+            return nullptr;
+
+        // Retired slot is being replaced by a new map, which is loaded on the next iteration
+        BatchPointer batch = slot->batch.load();
+        if (batch != retired())
+            return batch;
+    }
+}
+
+
+
+
+// Public method
+WorldStore::BatchPointer WorldStore::publish(const OptocBatchCoordinate& coordinate,
+                                             Snapshot                    batch) {
+    auto pointer = std::make_shared<const Snapshot>(std::move(batch));
+
+    while (true) {
+        std::shared_ptr<Slot> slot = make_slot(coordinate);
+        BatchPointer          current = slot->batch.load();
+
+        while (current != retired()) {
+            if (slot->batch.compare_exchange_weak(current, pointer))
+                return pointer;
+        }
+    }
+}
+
+
+
+
+// Public method
+bool WorldStore::compare_and_publish(const OptocBatchCoordinate& coordinate,
+                                     const BatchPointer&         expected,
+                                     Snapshot                    batch) {
+    auto pointer = std::make_shared<const Snapshot>(std::move(batch));
+
+    while (true) {
+        BatchPointer current = expected;
+        if (make_slot(coordinate)->batch.compare_exchange_strong(current, pointer))
+            return true;
+
+        // Retired slot was empty, so `expected` is compared again with the new slot
+        if (current != retired())
+            return false;
+    }
+}
+
+
+
+
+// Public method
+WorldStore::BatchPointer WorldStore::update(const OptocBatchCoordinate&           coordinate,
+                                            const std::function<void(Snapshot&)>& edit) {
+    std::shared_ptr<Slot> slot = make_slot(coordinate);
+    BatchPointer          current = slot->batch.load();
+
+    while (true) {
+        if (current == retired()) {
+            slot = make_slot(coordinate);
+            current = slot->batch.load();
+            continue;
+        }
+
+        Snapshot copy = current ? *current : Snapshot();
+        edit(copy);
+
+        auto pointer = std::make_shared<const Snapshot>(std::move(copy));
+
+        // On failure `current` is reloaded with the version published by another thread
+        if (slot->batch.compare_exchange_weak(current, pointer))
+            return pointer;
+    }
+}
+
+
+
+
+// Public method
+bool WorldStore::erase(const OptocBatchCoordinate& coordinate) {
+    while (true) {
+        std::shared_ptr<Slot> slot = find_slot(coordinate);
+        if (!slot)
+            return false;
+
+        BatchPointer current = slot->batch.load();
+        while (current != nullptr && current != retired()) {
+            if (slot->batch.compare_exchange_weak(current, nullptr))
+                return true;
+        }
+
+        if (current == nullptr)
+            return false;
+    }
+}
+
+
+
+
+// Public method
+std::vector<std::pair<OptocBatchCoordinate, WorldStore::BatchPointer>> WorldStore::entries()
+    const {
+    std::vector<std::pair<OptocBatchCoordinate, BatchPointer>> result;
+
+    for (const auto& shard : shards_) {
+        std::shared_ptr<const Map> map = shard->map.load();
+
+        for (const auto& [coordinate, slot] : *map) {
+            BatchPointer batch = slot->batch.load();
+            if (batch != nullptr && batch != retired())
+                result.emplace_back(coordinate, std::move(batch));
+        }
+    }
+
+    return result;
+}
+
+
+
+
+// Public method
+std::size_t WorldStore::size() const {
+    std::size_t count{0};
+
+    for (const auto& shard : shards_) {
+        std::shared_ptr<const Map> map = shard->map.load();
+        count += static_cast<std::size_t>(std::ranges::count_if(*map, [](const auto& entry) {
+            BatchPointer batch = entry.second->batch.load();
+            return batch != nullptr && batch != retired();
+        }));
+    }
+
+    return count;
+}
+
+
+
+
+// Public method
+std::size_t WorldStore::slot_count() const {
+    std::size_t count{0};
+
+    for (const auto& shard : shards_) {
+        count += shard->map.load()->size();
+    }
+
+    return count;
+}
+
+
+
+
+// Static private method
+const WorldStore::BatchPointer& WorldStore::retired() {
+    static const BatchPointer marker = std::make_shared<const Snapshot>();
+    return marker;
+}
+
+
+
+
+// Private method
+WorldStore::Shard& WorldStore::shard_of(const OptocBatchCoordinate& coordinate) const {
+    return *shards_[OptocBatchCoordinateHash{}(coordinate) % shards_.size()];
+}
+
+
+
+
+// Private method
+std::shared_ptr<WorldStore::Slot> WorldStore::find_slot(
+    const OptocBatchCoordinate& coordinate) const {
+    std::shared_ptr<const Map> map = shard_of(coordinate).map.load();
+
+    auto found = map->find(coordinate);
+    return found == map->end() ? nullptr : found->second;
+}
+
+
+
+
+// Private method
+std::shared_ptr<WorldStore::Slot> WorldStore::make_slot(const OptocBatchCoordinate& coordinate) {
+    if (std::shared_ptr<Slot> slot = find_slot(coordinate))
+        return slot;
+
+    Shard&           shard = shard_of(coordinate);
+    std::scoped_lock lock(shard.write_mutex);
+
+    // Another writer could have added the coordinate while we were waiting
+    std::shared_ptr<const Map> map = shard.map.load();
+    if (auto found = map->find(coordinate); found != map->end())
+        return found->second;
+
+    // Readers keep using the old map until the new one is stored. Empty slots are retired and
+    // left out, writers that still hold one retry with the new map
+    auto copy = std::make_shared<Map>();
+    copy->reserve(map->size() + 1);
+
+    for (const auto& [key, old_slot] : *map) {
+        BatchPointer empty;
+        if (!old_slot->batch.compare_exchange_strong(empty, retired()))
+            copy->emplace(key, old_slot);
+    }
+
+    auto slot = std::make_shared<Slot>();
+    copy->emplace(coordinate, slot);
+    shard.map.store(std::move(copy));
+
+    return slot;
+}
+
+} // namespace optoctreeparser
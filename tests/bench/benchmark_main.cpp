@@ -0,0 +1,248 @@
+/// GPLv3 LICENSE, Copyright (©) 2025, Maksim Shchavelev <maksimshchavelev@gmail.com>
+/// See LICENSE for details
+///
+/// Measures throughput of hot paths of the library on a generated world:
+///   benchmark [--repetitions N] [--save <file>] [--compare <file>] [--threshold T]
+/// Prints `<name> <MB/s>` per workload. `--save` writes the same lines as a baseline,
+/// `--compare` fails (exit code 2) when a workload is slower than `(1 - T)` of its baseline
+
+#include "differ/differ.hpp"
+#include "editor/editor.hpp"
+#include "hasher/hasher.hpp"
+#include "parser/parser.hpp"
+#include "tracked_batch/tracked_batch.hpp"
+#include <algorithm>
+#include <chrono>
+#include <format>
+#include <fstream>
+#include <functional>
+#include <iostream>
+#include <map>
+#include <random>
+#include <string>
+#include <string_view>
+#include <vector>
+
+using namespace optoctreeparser;
+
+namespace {
+
+/// Batch with a few random spheres and boxes, the shape of edited terrain
+OptocRoot make_batch(std::mt19937& random) {
+    std::uniform_real_distribution<float> position(0.0f, 160.0f);
+    std::uniform_real_distribution<float> radius(4.0f, 30.0f);
+    std::uniform_int_distribution<int>    material(1, 80);
+
+    OptocNode leaf{.material_type = 0, .signed_distance = 1, .first_child_node = 0};
+    OptocTree tree{.node_count = 1, .nodes = {leaf}};
+    OptocRoot batch{.version = 4, .trees = std::vector<OptocTree>(125, tree)};
+
+    std::vector<EditOperation> operations;
+    for (std::size_t shape = 0; shape < 6; ++shape) {
+        auto     shape_material = static_cast<byte>(material(random));
+        OptocPoint center{position(random), position(random), position(random)};
+        float      size = radius(random);
+
+        if (shape % 2 == 0) {
+            operations.push_back(Editor::sphere(EditMode::add, shape_material, center, size));
+        } else {
+            operations.push_back(Editor::box(EditMode::add,
+                                             shape_material,
+                                             {center.x - size, center.y - size, center.z - size},
+                                             {center.x + size, center.y + size, center.z + size}));
+        }
+    }
+
+    Editor::apply(batch, operations);
+    return batch;
+}
+
+
+/// Runs workload `repetitions` times and returns the best throughput in MB/s
+double measure(std::size_t repetitions, std::size_t bytes, const std::function<void()>& workload) {
+    double best{0};
+
+    for (std::size_t repetition = 0; repetition < repetitions; ++repetition) {
+        auto start = std::chrono::steady_clock::now();
+        workload();
+        std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+
+        best = std::max(best, static_cast<double>(bytes) / elapsed.count() / 1e6);
+    }
+
+    return best;
+}
+
+
+std::map<std::string, double> read_results(const std::string& path) {
+    std::map<std::string, double> results;
+    std::ifstream                 file(path);
+    std::string                   name;
+    double                        value{};
+
+    while (file >> name >> value) {
+        results[name] = value;
+    }
+
+    return results;
+}
+
+} // namespace
+
+
+int main(int argc, char** argv) {
+    std::size_t repetitions = 5;
+    std::string save_path;
+    std::string compare_path;
+    double      threshold = 0.05;
+
+    auto usage = [&] {
+        std::cerr << "Usage: " << argv[0]
+                  << " [--repetitions N] [--save <file>] [--compare <file>] [--threshold T]\n";
+        return 1;
+    };
+
+    for (int argument = 1; argument < argc; argument += 2) {
+        // Every option takes a value. A dangling one would silently skip e.g. the comparison
+        if (argument + 1 == argc)
+            return usage();
+
+        std::string_view option(argv[argument]);
+        std::string      value(argv[argument + 1]);
+
+        if (option == "--repetitions") {
+            repetitions = std::stoul(value);
+        } else if (option == "--save") {
+            save_path = value;
+        } else if (option == "--compare") {
+            compare_path = value;
+        } else if (option == "--threshold") {
+            threshold = std::stod(value);
+        } else {
+            return usage();
+        }
+    }
+
+    // Fixed seed: every run and every build measures the same world
+    std::mt19937                  random(2025);
+    std::vector<OptocRoot>        batches;
+    std::vector<OptocRoot>        edited;
+    std::vector<OptocTreeView>    views;
+    std::size_t                   batch_bytes{0};
+    std::vector<OptocPatchTree>   difference;
+    std::map<std::string, double> results;
+
+    for (std::size_t i = 0; i < 32; ++i) {
+        batches.push_back(make_batch(random));
+        views.push_back(Parser::pack_optoctree_batch(batches.back()));
+        batch_bytes += views.back().size();
+    }
+
+    edited = batches;
+    for (auto& batch : edited) {
+        std::vector<EditOperation> operations = {
+            Editor::sphere(EditMode::remove, 0, {80.0f, 80.0f, 80.0f}, 12.0f)};
+        Editor::apply(batch, operations);
+    }
+
+    OptocPatchRoot patch{.version = 0, .batches = {}};
+    for (std::size_t i = 0; i < batches.size(); ++i) {
+        auto trees = Differ::find_difference(batches[i], edited[i]);
+        patch.batches.push_back({.x_position = static_cast<int16_t>(i),
+                                 .y_position = 0,
+                                 .z_position = 0,
+                                 .octree_count = static_cast<byte>(trees.size()),
+                                 .octrees = std::move(trees)});
+    }
+    OptocTreeView patch_view = Parser::pack_optoctreepatch(patch);
+
+    std::size_t sink{0};
+
+    results["parse_batch"] = measure(repetitions, batch_bytes, [&] {
+        for (const auto& view : views) {
+            sink += Parser::parse_optoctree_batch(view).trees.size();
+        }
+    });
+
+    results["pack_batch"] = measure(repetitions, batch_bytes, [&] {
+        for (const auto& batch : batches) {
+            sink += Parser::pack_optoctree_batch(batch).size();
+        }
+    });
+
+    // Autosave of barely edited batches: one dirty tree per batch
+    std::vector<TrackedBatch> tracked(views.begin(), views.end());
+    for (auto& batch : tracked) {
+        batch.mutable_tree(62);
+    }
+
+    results["pack_batch_one_dirty"] = measure(repetitions, batch_bytes, [&] {
+        for (const auto& batch : tracked) {
+            sink += batch.pack().size();
+        }
+    });
+
+    results["hash_batch"] = measure(repetitions, batch_bytes, [&] {
+        for (const auto& batch : batches) {
+            sink += Hasher::hash_root(batch).root_hash;
+        }
+    });
+
+    results["find_difference"] = measure(repetitions, batch_bytes, [&] {
+        for (std::size_t i = 0; i < batches.size(); ++i) {
+            sink += Differ::find_difference(batches[i], edited[i]).size();
+        }
+    });
+
+    results["parse_patch"] = measure(repetitions, patch_view.size(), [&] {
+        sink += Parser::parse_optoctreepatch(patch_view).batches.size();
+    });
+
+    results["parse_patch_flat"] = measure(repetitions, patch_view.size(), [&] {
+        sink += Parser::parse_optoctreepatch_flat(patch_view).nodes.size();
+    });
+
+    for (const auto& [name, value] : results) {
+        std::cout << std::format("{} {:.1f}\n", name, value);
+    }
+
+    if (!save_path.empty()) {
+        std::ofstream file(save_path);
+        for (const auto& [name, value] : results) {
+            file << std::format("{} {:.1f}\n", name, value);
+        }
+    }
+
+    // Keeps the workloads from being optimized away
+    if (sink == 0)
+        std::cerr << "Empty workload\n";
+
+    if (compare_path.empty())
+        return 0;
+
+    auto baseline = read_results(compare_path);
+    if (baseline.empty()) {
+        std::cerr << std::format("No baseline in {}\n", compare_path);
+        return 1;
+    }
+
+    bool regressed = false;
+    for (const auto& [name, expected] : baseline) {
+        auto found = results.find(name);
+        if (found == results.end())
+            continue;
+
+        double change = found->second / expected - 1.0;
+        bool   slower = change < -threshold;
+        regressed = regressed || slower;
+
+        std::cout << std::format("{} {:.1f} -> {:.1f} MB/s ({:+.1f}%){}\n",
+                                 name,
+                                 expected,
+                                 found->second,
+                                 change * 100.0,
+                                 slower ? " REGRESSION" : "");
+    }
+
+    return regressed ? 2 : 0;
+}
@@ -0,0 +1,27 @@
+/// GPLv3 LICENSE, Copyright (©) 2025, Maksim Shchavelev <maksimshchavelev@gmail.com>
+/// See LICENSE for details
+
+#include "parser/parser.hpp"
+#include <cstddef>
+#include <cstdint>
+#include <stdexcept>
+
+using namespace optoctreeparser;
+
+extern "C" int LLVMFuzzerTestOneInput(const uint8_t* data, size_t size) {
+    OptocTreeView view(data, data + size);
+
+    try {
+        OptocRoot batch = Parser::parse_optoctree_batch(view);
+
+        // Trees must hold exactly the declared nodes
+        for (const auto& tree : batch.trees) {
+            if (tree.nodes.size() != tree.node_count)
+                __builtin_trap();
+        }
+    } catch (const std::out_of_range&) {
+        // Truncated input is rejected, that's expected
+    }
+
+    return 0;
+}
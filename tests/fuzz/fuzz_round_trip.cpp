@@ -0,0 +1,51 @@
+/// GPLv3 LICENSE, Copyright (©) 2025, Maksim Shchavelev <maksimshchavelev@gmail.com>
+/// See LICENSE for details
+
+#include "parser/parser.hpp"
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <stdexcept>
+
+using namespace optoctreeparser;
+
+namespace {
+
+/// Packed data must be the prefix of input that was consumed by parser
+void check_prefix(const OptocTreeView& packed, const uint8_t* data, size_t size) {
+    if (packed.size() > size || !std::equal(packed.begin(), packed.end(), data))
+        __builtin_trap();
+}
+
+} // namespace
+
+/// The first byte selects the format, the rest is parsed, packed and compared with the input
+extern "C" int LLVMFuzzerTestOneInput(const uint8_t* data, size_t size) {
+    if (size == 0)
+        return 0;
+
+    bool          patch = (data[0] & 1) != 0;
+    OptocTreeView view(data + 1, data + size);
+
+    try {
+        if (patch) {
+            OptocPatchRoot parsed = Parser::parse_optoctreepatch(view);
+            OptocTreeView  packed = Parser::pack_optoctreepatch(parsed);
+            check_prefix(packed, data + 1, size - 1);
+
+            if (Parser::parse_optoctreepatch(packed) != parsed)
+                __builtin_trap();
+        } else {
+            OptocRoot     parsed = Parser::parse_optoctree_batch(view);
+            OptocTreeView packed = Parser::pack_optoctree_batch(parsed);
+            check_prefix(packed, data + 1, size - 1);
+
+            if (Parser::parse_optoctree_batch(packed) != parsed)
+                __builtin_trap();
+        }
+    } catch (const std::out_of_range&) {
+        // Truncated input is rejected, that's expected
+    }
+
+    return 0;
+}
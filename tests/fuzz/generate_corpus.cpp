@@ -0,0 +1,135 @@
+/// GPLv3 LICENSE, Copyright (©) 2025, Maksim Shchavelev <maksimshchavelev@gmail.com>
+/// See LICENSE for details
+///
+/// Generates seed corpus for fuzz targets:
+///   generate_corpus <output directory> [count = 64] [seed = 1]
+/// Creates `batch`, `patch` and `round_trip` subdirectories with valid inputs
+
+#include "parser/parser.hpp"
+#include "writer/writer.hpp"
+#include <filesystem>
+#include <format>
+#include <iostream>
+#include <random>
+#include <string>
+
+using namespace optoctreeparser;
+
+namespace {
+
+/// Random tree with children stored contiguously after their parent
+OptocTree random_tree(std::mt19937& random) {
+    std::uniform_int_distribution<int> byte_value(0, 255);
+    std::uniform_int_distribution<int> max_depth(0, 3);
+    std::bernoulli_distribution        split(0.4);
+
+    OptocTree tree{};
+    tree.nodes.push_back({static_cast<byte>(byte_value(random)),
+                          static_cast<byte>(byte_value(random)),
+                          0});
+
+    int                                      depth_limit = max_depth(random);
+    std::vector<std::pair<std::size_t, int>> pending{{0, 0}};
+
+    while (!pending.empty()) {
+        auto [node, depth] = pending.back();
+        pending.pop_back();
+
+        if (depth >= depth_limit || !split(random))
+            continue;
+
+        std::size_t first_child = tree.nodes.size();
+        tree.nodes[node].first_child_node = static_cast<uint16_t>(first_child);
+
+        for (std::size_t child = 0; child < 8; ++child) {
+            tree.nodes.push_back({static_cast<byte>(byte_value(random)),
+                                  static_cast<byte>(byte_value(random)),
+                                  0});
+            pending.emplace_back(first_child + child, depth + 1);
+        }
+    }
+
+    tree.node_count = static_cast<uint16_t>(tree.nodes.size());
+    return tree;
+}
+
+
+OptocRoot random_batch(std::mt19937& random) {
+    OptocRoot batch{.version = 4, .trees = {}};
+
+    for (std::size_t tree = 0; tree < 125; ++tree) {
+        batch.trees.push_back(random_tree(random));
+    }
+
+    return batch;
+}
+
+
+OptocPatchRoot random_patch(std::mt19937& random) {
+    std::uniform_int_distribution<int> position(-32, 32);
+    std::uniform_int_distribution<int> batch_count(1, 8);
+    std::uniform_int_distribution<int> tree_count(1, 10);
+    std::uniform_int_distribution<int> tree_number(0, 124);
+
+    OptocPatchRoot patch{.version = 0, .batches = {}};
+
+    for (int batch_index = batch_count(random); batch_index > 0; --batch_index) {
+        OptocPatchBatch batch{};
+        batch.x_position = static_cast<int16_t>(position(random));
+        batch.y_position = static_cast<int16_t>(position(random));
+        batch.z_position = static_cast<int16_t>(position(random));
+
+        for (int tree_index = tree_count(random); tree_index > 0; --tree_index) {
+            OptocTree tree = random_tree(random);
+            batch.octrees.push_back({static_cast<byte>(tree_number(random)),
+                                     tree.node_count,
+                                     std::move(tree.nodes)});
+        }
+
+        batch.octree_count = static_cast<byte>(batch.octrees.size());
+        patch.batches.push_back(std::move(batch));
+    }
+
+    return patch;
+}
+
+} // namespace
+
+
+int main(int argc, char** argv) {
+    if (argc < 2) {
+        std::cerr << "Usage: " << argv[0] << " <output directory> [count] [seed]\n";
+        return 1;
+    }
+
+    std::filesystem::path output(argv[1]);
+    std::size_t           count = argc > 2 ? std::stoul(argv[2]) : 64;
+    unsigned              seed = argc > 3 ? static_cast<unsigned>(std::stoul(argv[3])) : 1;
+
+    std::mt19937 random(seed);
+
+    for (const char* directory : {"batch", "patch", "round_trip"}) {
+        std::filesystem::create_directories(output / directory);
+    }
+
+    for (std::size_t index = 0; index < count; ++index) {
+        OptocTreeView batch = Parser::pack_optoctree_batch(random_batch(random));
+        OptocTreeView patch = Parser::pack_optoctreepatch(random_patch(random));
+
+        Writer::optoctreeview_to_file(
+            (output / "batch" / std::format("seed_{:04}.optoctree", index)).string(), batch);
+        Writer::optoctreeview_to_file(
+            (output / "patch" / std::format("seed_{:04}.optoctreepatch", index)).string(), patch);
+
+        // Round trip target selects format by the lowest bit of the first byte
+        batch.insert(batch.begin(), 0x00);
+        patch.insert(patch.begin(), 0x01);
+        Writer::optoctreeview_to_file(
+            (output / "round_trip" / std::format("batch_{:04}.bin", index)).string(), batch);
+        Writer::optoctreeview_to_file(
+            (output / "round_trip" / std::format("patch_{:04}.bin", index)).string(), patch);
+    }
+
+    std::cout << std::format("Generated {} seeds per target in '{}'\n", count, output.string());
+    return 0;
+}
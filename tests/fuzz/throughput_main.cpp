@@ -0,0 +1,70 @@
+/// GPLv3 LICENSE, Copyright (©) 2025, Maksim Shchavelev <maksimshchavelev@gmail.com>
+/// See LICENSE for details
+///
+/// Runs a fuzz target over a corpus without libFuzzer and reports throughput:
+///   <target>_throughput [--iterations N] <file or directory>...
+
+#include "reader/reader.hpp"
+#include <chrono>
+#include <cstdint>
+#include <filesystem>
+#include <format>
+#include <iostream>
+#include <string_view>
+#include <vector>
+
+extern "C" int LLVMFuzzerTestOneInput(const uint8_t* data, size_t size);
+
+int main(int argc, char** argv) {
+    std::size_t                                 iterations = 10;
+    std::vector<optoctreeparser::OptocTreeView> inputs;
+    std::size_t                                 total_bytes{0};
+
+    for (int argument = 1; argument < argc; ++argument) {
+        std::string_view value(argv[argument]);
+
+        if (value == "--iterations" && argument + 1 < argc) {
+            iterations = std::stoul(argv[++argument]);
+            continue;
+        }
+
+        std::vector<std::filesystem::path> files;
+        if (std::filesystem::is_directory(value)) {
+            for (const auto& entry : std::filesystem::recursive_directory_iterator(value)) {
+                if (entry.is_regular_file())
+                    files.push_back(entry.path());
+            }
+        } else {
+            files.emplace_back(value);
+        }
+
+        for (const auto& file : files) {
+            inputs.push_back(optoctreeparser::Reader::optoctreeview_from_file(file.string()));
+            total_bytes += inputs.back().size();
+        }
+    }
+
+    if (inputs.empty()) {
+        std::cerr << "Usage: " << argv[0] << " [--iterations N] <file or directory>...\n";
+        return 1;
+    }
+
+    auto start = std::chrono::steady_clock::now();
+
+    for (std::size_t iteration = 0; iteration < iterations; ++iteration) {
+        for (const auto& input : inputs) {
+            LLVMFuzzerTestOneInput(input.data(), input.size());
+        }
+    }
+
+    std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+
+    double bytes = static_cast<double>(total_bytes) * static_cast<double>(iterations);
+    std::cout << std::format("{} inputs, {} bytes, {} iterations: {:.3f} s, {:.1f} MB/s\n",
+                             inputs.size(),
+                             total_bytes,
+                             iterations,
+                             elapsed.count(),
+                             bytes / elapsed.count() / 1e6);
+    return 0;
+}
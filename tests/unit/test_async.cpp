@@ -0,0 +1,104 @@
+/// GPLv3 LICENSE, Copyright (©) 2025, Maksim Shchavelev <maksimshchavelev@gmail.com>
+/// See LICENSE for details
+
+#include "async/async.hpp"
+#include "parser/parser.hpp"
+#include "reader/reader.hpp"
+#include "writer/writer.hpp"
+#include <atomic>
+#include <gtest/gtest.h>
+#include <stdexcept>
+#include <string>
+#include <system_error>
+
+using namespace optoctreeparser;
+
+namespace {
+
+Task<int> add(Scheduler& scheduler, int a, int b) {
+    co_await scheduler.schedule();
+    co_return a + b;
+}
+
+
+Task<int> add_three(Scheduler& scheduler) {
+    int sum = co_await add(scheduler, 1, 2);
+    co_return co_await add(scheduler, sum, 3);
+}
+
+} // namespace
+
+
+TEST(Async, pipeline_is_bounded) {
+    Scheduler io(2);
+    Scheduler cpu(3);
+
+    constexpr std::size_t    count = 6;
+    std::vector<std::string> inputs;
+    std::vector<std::string> outputs;
+
+    OptocRoot batch = Parser::parse_optoctree_batch(
+        Reader::optoctreeview_from_file("resources/read_real_optoctree.optoctree"));
+
+    for (std::size_t i = 0; i < count; ++i) {
+        inputs.push_back("resources/async_in_" + std::to_string(i) + ".optoctree");
+        outputs.push_back("resources/async_out_" + std::to_string(i) + ".optoctree");
+
+        batch.version = static_cast<int32_t>(i);
+        Writer::optoctreeview_to_file(inputs[i], Parser::pack_optoctree_batch(batch));
+    }
+
+    std::atomic<std::size_t> in_flight{0};
+    std::atomic<std::size_t> max_in_flight{0};
+
+    Async::sync_wait(Async::for_each(count, 2, [&](std::size_t i) -> Task<void> {
+        std::size_t now = in_flight.fetch_add(1) + 1;
+        std::size_t seen = max_in_flight.load();
+        while (now > seen && !max_in_flight.compare_exchange_weak(seen, now)) {
+        }
+
+        OptocRoot root = co_await Async::parse_batch(cpu, co_await Async::read(io, inputs[i]));
+        root.version += 100;
+        co_await Async::write(io, outputs[i], co_await Async::pack_batch(cpu, std::move(root)));
+
+        in_flight.fetch_sub(1);
+    }));
+
+    ASSERT_LE(max_in_flight.load(), 2);
+
+    for (std::size_t i = 0; i < count; ++i) {
+        OptocRoot written =
+            Parser::parse_optoctree_batch(Reader::optoctreeview_from_file(outputs[i]));
+        ASSERT_EQ(written.version, static_cast<int32_t>(i) + 100);
+        ASSERT_EQ(written.trees, batch.trees);
+    }
+}
+
+
+TEST(Async, tasks_compose_and_rethrow) {
+    Scheduler scheduler(2);
+
+    ASSERT_EQ(Async::sync_wait(add_three(scheduler)), 6);
+
+    Task<int> task = add(scheduler, 1, 2);
+    Task<int> owner = std::move(task);
+    ASSERT_THROW(Async::sync_wait(std::move(task)), std::logic_error);
+    ASSERT_EQ(Async::sync_wait(std::move(owner)), 3);
+
+    ASSERT_THROW(Async::sync_wait(Async::read(scheduler, "resources/no_such_file.optoctree")),
+                 std::system_error);
+
+    std::vector<Task<void>> tasks;
+    std::atomic<int>        finished{0};
+    for (int i = 0; i < 4; ++i) {
+        tasks.push_back([](Scheduler& on, std::atomic<int>& counter, int index) -> Task<void> {
+            co_await on.schedule();
+            counter.fetch_add(1);
+            if (index == 2)
+                throw std::runtime_error("failed");
+        }(scheduler, finished, i));
+    }
+
+    ASSERT_THROW(Async::sync_wait(Async::when_all(std::move(tasks))), std::runtime_error);
+    ASSERT_EQ(finished.load(), 4); // Other tasks still finish
+}
@@ -2,8 +2,11 @@
 /// See LICENSE for details
 
 #include "differ/differ.hpp"
+#include "octree/octree.hpp"
 #include "parser/parser.hpp"
+#include "reader/reader.hpp"
 #include <gtest/gtest.h>
+#include <stdexcept>
 
 using namespace optoctreeparser;
 
@@ -82,3 +85,56 @@ TEST(Differ, modified_tree) {
     ASSERT_EQ(difference[0].nodes[0].material_type, 23);
     ASSERT_EQ(difference[0].nodes[0].signed_distance, 0);
 }
+
+
+TEST(Differ, modified_tree_by_hashes) {
+    OptocRoot parsed{.version = 4, .trees = std::vector<OptocTree>(Octree::trees_per_batch)};
+
+    OptocRoot patched = parsed;
+    patched.trees[7] = OptocTree{
+        .node_count = 1,
+        .nodes = {OptocNode{.material_type = 23, .signed_distance = 0, .first_child_node = 0}}};
+
+    OptocRootHashes old_hashes = Hasher::hash_root(parsed);
+
+    ASSERT_TRUE(Differ::find_difference(old_hashes, parsed).empty());
+
+    auto difference = Differ::find_difference(old_hashes, patched);
+    ASSERT_EQ(difference.size(), 1);
+    ASSERT_EQ(difference[0].octree_number, 7);
+    ASSERT_EQ(difference[0].nodes, patched.trees[7].nodes);
+
+    OptocRootHashes short_hashes = Hasher::hash_root(patched);
+    short_hashes.tree_hashes.pop_back();
+    ASSERT_THROW(Differ::find_difference(old_hashes, patched, short_hashes),
+                 std::invalid_argument);
+}
+
+
+TEST(Differ, append_difference_of_encoded_batches) {
+    OptocTreeView old_view =
+        Reader::optoctreeview_from_file("resources/read_real_subnautica_optoctree.optoctrees");
+    OptocRoot old_root = Parser::parse_optoctree_batch(old_view);
+
+    OptocRoot new_root = old_root;
+    new_root.trees[3].nodes[0].material_type = 23;
+    new_root.trees[100] = OptocTree{
+        .node_count = 1,
+        .nodes = {OptocNode{.material_type = 37, .signed_distance = 200, .first_child_node = 0}}};
+    OptocTreeView new_view = Parser::pack_optoctree_batch(new_root);
+
+    OptocTreeView patch = Parser::pack_optoctreepatch({.version = 1, .batches = {}});
+    ASSERT_EQ(Differ::append_difference(old_view, old_view, 1, 2, 3, patch), 0);
+    ASSERT_EQ(patch.size(), 4);
+
+    ASSERT_EQ(Differ::append_difference(old_view, new_view, -4, 2, 3, patch), 2);
+
+    OptocPatchRoot parsed = Parser::parse_optoctreepatch(patch);
+    ASSERT_EQ(parsed.batches.size(), 1);
+    ASSERT_EQ(parsed.batches[0].x_position, -4);
+    ASSERT_EQ(parsed.batches[0].octree_count, 2);
+    ASSERT_EQ(parsed.batches[0].octrees, Differ::find_difference(old_root, new_root));
+
+    old_view.pop_back();
+    ASSERT_THROW(Differ::append_difference(old_view, new_view, 0, 0, 0, patch), std::out_of_range);
+}
@@ -0,0 +1,183 @@
+/// GPLv3 LICENSE, Copyright (©) 2025, Maksim Shchavelev <maksimshchavelev@gmail.com>
+/// See LICENSE for details
+
+#include "distance_field/distance_field.hpp"
+#include "editor/editor.hpp"
+#include "memory/memory.hpp"
+#include "parser/parser.hpp"
+#include "signed_distance/signed_distance.hpp"
+#include "test_helpers.hpp"
+#include "world_index/world_index.hpp"
+#include <cmath>
+#include <gtest/gtest.h>
+#include <random>
+
+using namespace optoctreeparser;
+
+namespace {
+
+/// Signed distance of voxel by checking every other voxel
+byte brute_force(const OptocGrid& grid, std::size_t x, std::size_t y, std::size_t z) {
+    bool  solid = grid.material_type[Grid::index(grid, x, y, z)] != 0;
+    float nearest = 256.0f;
+
+    for (std::size_t k = 0; k < grid.size; ++k) {
+        for (std::size_t j = 0; j < grid.size; ++j) {
+            for (std::size_t i = 0; i < grid.size; ++i) {
+                if ((grid.material_type[Grid::index(grid, i, j, k)] != 0) == solid)
+                    continue;
+
+                float dx = static_cast<float>(i) - static_cast<float>(x);
+                float dy = static_cast<float>(j) - static_cast<float>(y);
+                float dz = static_cast<float>(k) - static_cast<float>(z);
+                nearest = std::min(nearest, std::sqrt(dx * dx + dy * dy + dz * dz));
+            }
+        }
+    }
+
+    return SignedDistance::encode(solid ? 0.5f - nearest : nearest - 0.5f);
+}
+
+
+/// Calls `check(leaf, center, size)` for every leaf of tree
+template <typename Check>
+void for_each_leaf(const OptocTree& tree,
+                   std::size_t      node,
+                   OptocPoint       low,
+                   float            size,
+                   const Check&     check) {
+    if (size > 1.0f && Octree::has_children(tree, node)) {
+        float half = size / 2;
+        for (std::size_t child = 0; child < Octree::children_count; ++child) {
+            OptocVoxel offset = Octree::child_offset(child);
+            for_each_leaf(tree,
+                          tree.nodes[node].first_child_node + child,
+                          {low.x + static_cast<float>(offset.x) * half,
+                           low.y + static_cast<float>(offset.y) * half,
+                           low.z + static_cast<float>(offset.z) * half},
+                          half,
+                          check);
+        }
+        return;
+    }
+
+    float half = size / 2;
+    check(tree.nodes[node], OptocPoint{low.x + half, low.y + half, low.z + half}, size);
+}
+
+} // namespace
+
+
+TEST(DistanceField, matches_brute_force) {
+    OptocGrid grid{.size = 12,
+                   .material_type = std::vector<byte>(12 * 12 * 12, 0),
+                   .signed_distance = std::vector<byte>(12 * 12 * 12, 0)};
+
+    std::mt19937                    random(7);
+    std::uniform_int_distribution<> chance(0, 9);
+    for (auto& material : grid.material_type) {
+        material = chance(random) == 0 ? 37 : 0;
+    }
+
+    DistanceField::recompute(grid, 3);
+
+    for (std::size_t z = 0; z < grid.size; ++z) {
+        for (std::size_t y = 0; y < grid.size; ++y) {
+            for (std::size_t x = 0; x < grid.size; ++x) {
+                ASSERT_EQ(grid.signed_distance[Grid::index(grid, x, y, z)],
+                          brute_force(grid, x, y, z));
+            }
+        }
+    }
+
+    grid.signed_distance.pop_back();
+    ASSERT_THROW(DistanceField::recompute(grid), std::invalid_argument);
+}
+
+
+TEST(DistanceField, repairs_batch_after_edit) {
+    OptocRoot batch = test::make_leaf_batch();
+
+    std::vector<EditOperation> operations = {
+        Editor::sphere(EditMode::add, 37, {80.0f, 80.0f, 80.0f}, 20.0f)};
+    Editor::apply(batch, operations);
+
+    // Break distances, keep materials
+    for (auto& batch_tree : batch.trees) {
+        for (auto& node : batch_tree.nodes) {
+            node.signed_distance = node.material_type != 0 ? 252 : 1;
+        }
+    }
+
+    std::size_t   used = Memory::of_batch(batch).used;
+    OptocTreeView packed = Parser::pack_optoctree_batch(batch);
+
+    DistanceField::recompute(batch);
+
+    // Shape of trees is kept, so the batch does not grow
+    ASSERT_EQ(Memory::of_batch(batch).used, used);
+    ASSERT_EQ(Parser::pack_optoctree_batch(batch).size(), packed.size());
+
+    // Every leaf gets the distance of its center to the surface of the sphere
+    for (std::size_t tree = 0; tree < batch.trees.size(); ++tree) {
+        OptocVoxel origin = Octree::tree_origin(tree);
+        OptocPoint low{static_cast<float>(origin.x),
+                       static_cast<float>(origin.y),
+                       static_cast<float>(origin.z)};
+
+        for_each_leaf(
+            batch.trees[tree], 0, low, 32.0f, [](const OptocNode& leaf, OptocPoint center, float) {
+                float dx = center.x - 80.0f;
+                float dy = center.y - 80.0f;
+                float dz = center.z - 80.0f;
+                float expected = std::sqrt(dx * dx + dy * dy + dz * dz) - 20.0f;
+                float distance = SignedDistance::decode(leaf.signed_distance, leaf.material_type);
+
+                ASSERT_EQ(distance < 0, leaf.material_type != 0);
+                ASSERT_NEAR(distance, expected, 1.5f);
+            });
+    }
+}
+
+
+TEST(DistanceField, sees_neighbouring_batches) {
+    // Empty batch {0, 0, 0} and solid batch {1, 0, 0}: the surface is their common face x = 160
+    WorldIndex world;
+    world.insert({0, 0, 0}, test::make_leaf_batch());
+    world.insert({1, 0, 0}, test::make_leaf_batch(37, SignedDistance::encode(-1.0f)));
+
+    OptocRoot empty = *world.find({0, 0, 0});
+    OptocRoot solid = *world.find({1, 0, 0});
+    OptocRoot alone = empty;
+
+    DistanceField::recompute(empty, world, {0, 0, 0}, 2);
+    DistanceField::recompute(solid, world, {1, 0, 0}, 2);
+    DistanceField::recompute(alone, 2);
+
+    // Trees next to the face have centers 16 voxels away from it, on both sides
+    for (std::size_t tree = 0; tree < Octree::trees_per_batch; ++tree) {
+        OptocVoxel origin = Octree::tree_origin(tree);
+
+        if (origin.x == 128) {
+            float distance = SignedDistance::decode(empty.trees[tree].nodes[0].signed_distance, 0);
+            ASSERT_NEAR(distance, 16.0f, 1.0f);
+            ASSERT_EQ(alone.trees[tree].nodes[0].signed_distance, SignedDistance::min_encoded);
+        }
+
+        if (origin.x == 0) {
+            float distance = SignedDistance::decode(solid.trees[tree].nodes[0].signed_distance, 37);
+            ASSERT_NEAR(distance, -16.0f, 1.0f);
+        }
+    }
+
+    // Without neighbours the result is the same as for a lone batch
+    OptocRoot                  sphere = test::make_leaf_batch();
+    std::vector<EditOperation> operations = {
+        Editor::sphere(EditMode::add, 37, {70.0f, 90.0f, 80.0f}, 20.0f)};
+    Editor::apply(sphere, operations);
+
+    OptocRoot padded = sphere;
+    DistanceField::recompute(sphere, 2);
+    DistanceField::recompute(padded, WorldIndex{}, {0, 0, 0}, 2);
+    ASSERT_EQ(padded, sphere);
+}
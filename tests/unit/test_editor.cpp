@@ -0,0 +1,69 @@
+/// GPLv3 LICENSE, Copyright (©) 2025, Maksim Shchavelev <maksimshchavelev@gmail.com>
+/// See LICENSE for details
+
+#include "differ/differ.hpp"
+#include "editor/editor.hpp"
+#include "grid/grid.hpp"
+#include "test_helpers.hpp"
+#include <algorithm>
+#include <gtest/gtest.h>
+
+using namespace optoctreeparser;
+
+
+TEST(Editor, grid_round_trip) {
+    OptocRoot batch = test::make_leaf_batch();
+    std::vector<EditOperation> operations = {
+        Editor::sphere(EditMode::add, 37, {16.0f, 16.0f, 16.0f}, 5.0f)};
+
+    Editor::apply(batch, operations);
+
+    OptocGrid grid = Grid::from_tree(batch.trees[0]);
+    ASSERT_EQ(Grid::to_tree(grid), batch.trees[0]);
+    ASSERT_EQ(Grid::from_tree(Grid::to_tree(grid)), grid);
+}
+
+
+TEST(Editor, sphere_changes_only_touched_trees) {
+    OptocRoot original = test::make_leaf_batch();
+    OptocRoot edited = original;
+
+    // Center of tree 0, far from other trees
+    std::vector<EditOperation> operations = {
+        Editor::sphere(EditMode::add, 37, {16.0f, 16.0f, 16.0f}, 5.0f),
+        Editor::sphere(EditMode::add, 37, {16.0f, 16.0f, 16.0f}, 3.0f),
+    };
+
+    std::vector<std::size_t> changed = Editor::apply(edited, operations);
+    ASSERT_EQ(changed, std::vector<std::size_t>{0});
+
+    OptocGrid grid = Grid::from_tree(edited.trees[0]);
+    ASSERT_EQ(grid.material_type[Grid::index(grid, 16, 16, 16)], 37);
+    ASSERT_EQ(grid.material_type[Grid::index(grid, 16, 16, 22)], 0);
+    ASSERT_EQ(grid.material_type[Grid::index(grid, 0, 0, 0)], 0);
+
+    auto difference = Differ::find_difference(original, edited, changed);
+    ASSERT_EQ(difference, Differ::find_difference(original, edited));
+    ASSERT_EQ(difference.size(), 1);
+    ASSERT_EQ(difference[0].octree_number, 0);
+}
+
+
+TEST(Editor, box_remove_and_paint) {
+    OptocRoot batch = test::make_leaf_batch();
+
+    // Fill the whole tree 1 (x in [32, 64)) and carve a box out of it
+    std::vector<EditOperation> operations = {
+        Editor::box(EditMode::add, 37, {32.0f, 0.0f, 0.0f}, {64.0f, 32.0f, 32.0f}),
+        Editor::box(EditMode::remove, 0, {40.0f, 8.0f, 8.0f}, {48.0f, 16.0f, 16.0f}),
+        Editor::box(EditMode::paint, 12, {32.0f, 0.0f, 0.0f}, {64.0f, 2.0f, 32.0f}),
+    };
+
+    std::vector<std::size_t> changed = Editor::apply(batch, operations, 2);
+    ASSERT_TRUE(std::ranges::find(changed, 1) != changed.end());
+
+    OptocGrid grid = Grid::from_tree(batch.trees[1]);
+    ASSERT_EQ(grid.material_type[Grid::index(grid, 0, 20, 20)], 37);
+    ASSERT_EQ(grid.material_type[Grid::index(grid, 10, 10, 10)], 0);
+    ASSERT_EQ(grid.material_type[Grid::index(grid, 20, 1, 20)], 12);
+}
@@ -0,0 +1,65 @@
+/// GPLv3 LICENSE, Copyright (©) 2025, Maksim Shchavelev <maksimshchavelev@gmail.com>
+/// See LICENSE for details
+
+#include "editor/editor.hpp"
+#include "grid/grid.hpp"
+#include "parser/parser.hpp"
+#include "reader/reader.hpp"
+#include "test_helpers.hpp"
+#include <gtest/gtest.h>
+#include <stdexcept>
+
+using namespace optoctreeparser;
+
+TEST(Grid, batch_round_trip) {
+    OptocRoot batch = test::make_leaf_batch();
+
+    // Sphere crosses 8 trees
+    std::vector<EditOperation> operations = {
+        Editor::sphere(EditMode::add, 37, {64.0f, 64.0f, 64.0f}, 20.0f)};
+    Editor::apply(batch, operations);
+
+    OptocGrid grid = Grid::from_batch(batch, 32, 4);
+    ASSERT_EQ(grid.size, 160);
+    ASSERT_EQ(grid.material_type[Grid::index(grid, 64, 64, 64)], 37);
+    ASSERT_EQ(grid.material_type[Grid::index(grid, 64, 64, 90)], 0);
+
+    for (std::size_t tree = 0; tree < Octree::trees_per_batch; ++tree) {
+        OptocGrid  tree_grid = Grid::from_tree(batch.trees[tree]);
+        OptocVoxel origin = Octree::tree_origin(tree);
+        auto       x = static_cast<std::size_t>(origin.x);
+        auto       y = static_cast<std::size_t>(origin.y);
+        auto       z = static_cast<std::size_t>(origin.z);
+
+        ASSERT_EQ(tree_grid.material_type[Grid::index(tree_grid, 3, 17, 30)],
+                  grid.material_type[Grid::index(grid, x + 3, y + 17, z + 30)]);
+    }
+
+    ASSERT_EQ(Grid::to_batch(grid, 4, 4), batch);
+    ASSERT_EQ(Grid::to_batch(grid, 4, 1), batch);
+}
+
+
+TEST(Grid, lower_resolution) {
+    OptocRoot batch = Parser::parse_optoctree_batch(
+        Reader::optoctreeview_from_file("resources/read_real_subnautica_optoctree.optoctrees"));
+
+    // Resolution 1 is the root of every tree
+    OptocGrid roots = Grid::from_batch(batch, 1);
+    ASSERT_EQ(roots.size, 5);
+    for (std::size_t tree = 0; tree < Octree::trees_per_batch; ++tree) {
+        if (!batch.trees[tree].nodes.empty()) {
+            ASSERT_EQ(roots.material_type[tree], batch.trees[tree].nodes[0].material_type);
+        }
+    }
+
+    // Coarse grid of a tree built from a grid is the grid of its coarse levels
+    OptocGrid fine = Grid::from_tree(batch.trees[62]);
+    OptocGrid coarse = Grid::from_tree(Grid::to_tree(fine), 8);
+    ASSERT_EQ(coarse.size, 8);
+    ASSERT_EQ(Grid::from_tree(Grid::to_tree(coarse), 8), coarse);
+
+    ASSERT_THROW(Grid::from_tree(batch.trees[0], 12), std::invalid_argument);
+    ASSERT_THROW(Grid::from_batch(batch, 64), std::invalid_argument);
+    ASSERT_THROW(Grid::to_batch(fine, 4), std::invalid_argument);
+}
@@ -0,0 +1,70 @@
+/// GPLv3 LICENSE, Copyright (©) 2025, Maksim Shchavelev <maksimshchavelev@gmail.com>
+/// See LICENSE for details
+
+#include "hasher/hasher.hpp"
+#include "parser/parser.hpp"
+#include <gtest/gtest.h>
+#include <string_view>
+
+using namespace optoctreeparser;
+
+namespace {
+
+std::vector<byte> bytes_of(std::string_view text) {
+    return std::vector<byte>(text.begin(), text.end());
+}
+
+} // namespace
+
+
+
+TEST(Hasher, xxh64_reference_values) {
+    ASSERT_EQ(Hasher::hash_bytes(bytes_of("")), 0xEF46DB3751D8E999ULL);
+    ASSERT_EQ(Hasher::hash_bytes(bytes_of("abc")), 0x44BC2CF5AD770999ULL);
+    ASSERT_EQ(Hasher::hash_bytes(bytes_of("Nobody inspects the spammish repetition")),
+              0xFBCEA83C8A378BF1ULL);
+}
+
+
+
+TEST(Hasher, hashes_while_parsing_match_hash_root) {
+    OptocTreeView batch = {
+        // ---- Version (int32 LE = 4) ----
+        0x04, 0x00, 0x00, 0x00,
+
+        // ---- node_count (uint16 LE = 2) ----
+        0x02, 0x00,
+
+        // ---- Node 0 ----
+        0x25,       // material_type = 37
+        0x80,       // signed_distance = 128
+        0x02, 0x00, // first_child_node = 2
+
+        // ---- Node 1 ----
+        0x00,       // material_type = 0
+        0x7E,       // signed_distance = 126
+        0x00, 0x00  // first_child_node = 0
+    };
+
+    batch.resize(batch.size() + (124 * 2), 0x00); // Fill empty trees
+
+    OptocRootHashes hashes{};
+    OptocRoot       parsed = Parser::parse_optoctree_batch(batch, hashes);
+
+    ASSERT_EQ(hashes.tree_hashes.size(), 125);
+    ASSERT_EQ(hashes, Hasher::hash_root(parsed));
+    ASSERT_NE(hashes.tree_hashes[0], hashes.tree_hashes[1]);
+    ASSERT_EQ(hashes.tree_hashes[1], hashes.tree_hashes[124]);
+}
+
+
+
+TEST(Hasher, tree_hash_depends_on_content) {
+    OptocTree tree{.node_count = 1,
+                   .nodes = {OptocNode{.material_type = 23, .signed_distance = 0, .first_child_node = 0}}};
+    OptocTree changed = tree;
+    changed.nodes[0].signed_distance = 1;
+
+    ASSERT_EQ(Hasher::hash_tree(tree), Hasher::hash_tree(OptocTree(tree)));
+    ASSERT_NE(Hasher::hash_tree(tree), Hasher::hash_tree(changed));
+}
@@ -0,0 +1,22 @@
+/// GPLv3 LICENSE, Copyright (©) 2025, Maksim Shchavelev <maksimshchavelev@gmail.com>
+/// See LICENSE for details
+
+#pragma once
+
+#include "base_struct/base_struct.hpp"
+#include "octree/octree.hpp"
+
+namespace optoctreeparser::test {
+
+/// Batch where every tree is one leaf. Defaults give an empty batch (material 0, outside)
+inline OptocRoot make_leaf_batch(byte    material_type = 0,
+                                 byte    signed_distance = 1,
+                                 int32_t version = 4) {
+    OptocNode leaf{
+        .material_type = material_type, .signed_distance = signed_distance, .first_child_node = 0};
+    OptocTree tree{.node_count = 1, .nodes = {leaf}};
+    return OptocRoot{.version = version,
+                     .trees = std::vector<OptocTree>(Octree::trees_per_batch, tree)};
+}
+
+} // namespace optoctreeparser::test
@@ -0,0 +1,81 @@
+/// GPLv3 LICENSE, Copyright (©) 2025, Maksim Shchavelev <maksimshchavelev@gmail.com>
+/// See LICENSE for details
+
+#include "differ/differ.hpp"
+#include "layout/layout.hpp"
+#include "parser/parser.hpp"
+#include "reader/reader.hpp"
+#include <concepts>
+#include <gtest/gtest.h>
+
+using namespace optoctreeparser;
+
+namespace {
+
+/// Node with a flag that lives only in memory
+struct FlaggedNode {
+    OptocNode node;
+    bool      dirty;
+
+    bool operator==(const FlaggedNode& other) const = default;
+};
+
+
+struct FlaggedLayout {
+    using node_type = FlaggedNode;
+
+    static constexpr FlaggedNode decode(const OptocNode& encoded) {
+        return {.node = encoded, .dirty = false};
+    }
+
+    static constexpr OptocNode encode(const FlaggedNode& node) {
+        return node.node;
+    }
+};
+
+static_assert(NodeLayout<DefaultLayout>);
+static_assert(NodeLayout<FlaggedLayout>);
+static_assert(std::same_as<LayoutCodec<DefaultLayout>::root_type, OptocRoot>);
+static_assert(std::same_as<LayoutCodec<FlaggedLayout>::root_type, BasicOptocRoot<FlaggedLayout>>);
+
+} // namespace
+
+
+TEST(Layout, same_bytes_as_parser) {
+    OptocTreeView view =
+        Reader::optoctreeview_from_file("resources/read_real_subnautica_optoctree.optoctrees");
+
+    auto flagged = LayoutCodec<FlaggedLayout>::parse_batch(view);
+    auto plain = LayoutCodec<DefaultLayout>::parse_batch(view);
+    ASSERT_EQ(LayoutCodec<FlaggedLayout>::to_root(flagged), Parser::parse_optoctree_batch(view));
+    ASSERT_EQ(LayoutCodec<DefaultLayout>::to_root(plain), Parser::parse_optoctree_batch(view));
+
+    flagged.trees[3].nodes[0].dirty = true;
+    ASSERT_EQ(LayoutCodec<FlaggedLayout>::pack_batch(flagged), view);
+    ASSERT_EQ(LayoutCodec<FlaggedLayout>::from_root(Parser::parse_optoctree_batch(view)).trees[3],
+              LayoutCodec<FlaggedLayout>::parse_batch(view).trees[3]);
+
+    OptocTreeView truncated(view.begin(), view.end() - 1);
+    ASSERT_THROW(LayoutCodec<FlaggedLayout>::parse_batch(truncated), std::out_of_range);
+}
+
+
+TEST(Layout, difference_ignores_in_memory_data) {
+    OptocTreeView view =
+        Reader::optoctreeview_from_file("resources/read_real_subnautica_optoctree.optoctrees");
+
+    auto old_batch = LayoutCodec<FlaggedLayout>::parse_batch(view);
+    auto new_batch = old_batch;
+
+    new_batch.trees[5].nodes[0].dirty = true;
+    ASSERT_TRUE(LayoutCodec<FlaggedLayout>::find_difference(old_batch, new_batch).empty());
+
+    new_batch.trees[7].nodes[0].node.material_type ^= 1;
+    auto difference = LayoutCodec<FlaggedLayout>::find_difference(old_batch, new_batch);
+
+    ASSERT_EQ(difference,
+              Differ::find_difference(LayoutCodec<FlaggedLayout>::to_root(old_batch),
+                                      LayoutCodec<FlaggedLayout>::to_root(new_batch)));
+    ASSERT_EQ(difference.size(), 1);
+    ASSERT_EQ(difference[0].octree_number, 7);
+}
@@ -0,0 +1,81 @@
+/// GPLv3 LICENSE, Copyright (©) 2025, Maksim Shchavelev <maksimshchavelev@gmail.com>
+/// See LICENSE for details
+
+#include "lod/lod.hpp"
+#include "octree/octree.hpp"
+#include "parser/parser.hpp"
+#include <gtest/gtest.h>
+
+using namespace optoctreeparser;
+
+namespace {
+
+/// Root with 8 children, the first child has 8 children: 6 of sand (37) and 2 empty
+OptocTree make_two_level_tree() {
+    OptocTree tree{};
+    tree.nodes.push_back({.material_type = 37, .signed_distance = 126, .first_child_node = 1});
+
+    for (std::size_t child = 0; child < 8; ++child) {
+        tree.nodes.push_back({.material_type = 37, .signed_distance = 130, .first_child_node = 0});
+    }
+    tree.nodes[1].first_child_node = 9;
+
+    for (std::size_t child = 0; child < 8; ++child) {
+        byte material = child < 6 ? 37 : 0;
+        byte distance = child < 6 ? 140 : 120;
+        tree.nodes.push_back(
+            {.material_type = material, .signed_distance = distance, .first_child_node = 0});
+    }
+
+    tree.node_count = static_cast<uint16_t>(tree.nodes.size());
+    return tree;
+}
+
+} // namespace
+
+
+TEST(Lod, truncate_tree) {
+    OptocTree tree = make_two_level_tree();
+    ASSERT_EQ(Octree::depth(tree), 2);
+
+    OptocTree same = Lod::truncate_tree(tree, 2, DistanceAggregation::min);
+    ASSERT_EQ(same, tree);
+
+    OptocTree coarse = Lod::truncate_tree(tree, 1, DistanceAggregation::min);
+    ASSERT_EQ(coarse.node_count, 9);
+    ASSERT_EQ(Octree::depth(coarse), 1);
+    ASSERT_EQ(coarse.nodes[1].first_child_node, 0);
+    ASSERT_EQ(coarse.nodes[1].material_type, 37);
+    ASSERT_EQ(coarse.nodes[1].signed_distance, 140); // min distance is the most solid one
+
+    OptocTree average = Lod::truncate_tree(tree, 1, DistanceAggregation::average);
+    ASSERT_EQ(average.nodes[1].signed_distance, 135); // (6 * 140 + 2 * 120) / 8
+
+    OptocTree root_only = Lod::truncate_tree(tree, 0, DistanceAggregation::min);
+    ASSERT_EQ(root_only.node_count, 1);
+    ASSERT_EQ(root_only.nodes[0].material_type, 37);
+    ASSERT_EQ(root_only.nodes[0].first_child_node, 0);
+}
+
+
+TEST(Lod, pack_truncated_batches) {
+    std::vector<OptocRoot> batches(
+        3, OptocRoot{.version = 4, .trees = std::vector<OptocTree>(Octree::trees_per_batch)});
+    for (auto& batch : batches) {
+        for (auto& tree : batch.trees) {
+            tree = make_two_level_tree();
+        }
+    }
+
+    std::vector<OptocTreeView> views =
+        Lod::pack_truncated_batches(batches, 1, DistanceAggregation::min, 2);
+    std::vector<OptocRoot> truncated =
+        Lod::truncate_batches(batches, 1, DistanceAggregation::min, 2);
+
+    ASSERT_EQ(views.size(), 3);
+    for (std::size_t batch = 0; batch < views.size(); ++batch) {
+        OptocRoot parsed = Parser::parse_optoctree_batch(views[batch]);
+        ASSERT_EQ(parsed, truncated[batch]);
+        ASSERT_EQ(parsed.trees[124].node_count, 9);
+    }
+}
@@ -0,0 +1,83 @@
+/// GPLv3 LICENSE, Copyright (©) 2025, Maksim Shchavelev <maksimshchavelev@gmail.com>
+/// See LICENSE for details
+
+#include "differ/differ.hpp"
+#include "manifest/manifest.hpp"
+#include "parser/parser.hpp"
+#include "reader/reader.hpp"
+#include "writer/writer.hpp"
+#include <gtest/gtest.h>
+#include <stdexcept>
+
+using namespace optoctreeparser;
+
+
+TEST(Manifest, pack_parse_manifest) {
+    std::vector<std::string> paths = {"resources/read_real_optoctree.optoctree",
+                                      "resources/read_real_subnautica_optoctree.optoctrees"};
+
+    OptocManifest manifest = Manifest::make(paths);
+
+    ASSERT_EQ(manifest.batches.size(), 2);
+    ASSERT_EQ(manifest.batches[0].file_size, 262);
+    ASSERT_EQ(manifest.batches[0].hashes.tree_hashes.size(), 125);
+    ASSERT_TRUE(Manifest::is_up_to_date(manifest.batches[0]));
+
+    OptocManifest parsed = Manifest::parse_manifest(Manifest::pack_manifest(manifest));
+    ASSERT_EQ(parsed, manifest);
+}
+
+
+TEST(Manifest, parse_truncated_manifest) {
+    std::vector<std::string> paths = {"resources/read_real_optoctree.optoctree"};
+
+    OptocTreeView view = Manifest::pack_manifest(Manifest::make(paths));
+
+    for (std::size_t size : {std::size_t{0}, std::size_t{6}, std::size_t{12}, view.size() - 1}) {
+        OptocTreeView truncated(view.begin(), view.begin() + static_cast<std::ptrdiff_t>(size));
+        ASSERT_THROW(Manifest::parse_manifest(truncated), std::out_of_range);
+    }
+
+    // Corrupted batch count must not reserve memory for billions of batches
+    OptocTreeView corrupted = view;
+    corrupted[4] = corrupted[5] = corrupted[6] = corrupted[7] = 0xFF;
+    ASSERT_THROW(Manifest::parse_manifest(corrupted), std::out_of_range);
+
+    OptocManifest long_path{.version = Manifest::current_version, .batches = {{}}};
+    long_path.batches[0].path.assign(70000, 'a');
+    ASSERT_THROW(Manifest::pack_manifest(long_path), std::invalid_argument);
+}
+
+
+TEST(Manifest, update_rereads_only_changed_files) {
+    std::vector<std::string> paths = {"resources/manifest_batch_0.optoctree",
+                                      "resources/manifest_batch_1.optoctree"};
+
+    OptocTreeView original =
+        Reader::optoctreeview_from_file("resources/read_real_optoctree.optoctree");
+    Writer::optoctreeview_to_file(paths[0], original);
+    Writer::optoctreeview_to_file(paths[1], original);
+
+    OptocManifest manifest = Manifest::make(paths);
+    ASSERT_EQ(Manifest::update(manifest, paths), 0);
+
+    // Change one tree of the second batch
+    OptocRoot changed = Parser::parse_optoctree_batch(original);
+    changed.trees[5] = OptocTree{
+        .node_count = 1,
+        .nodes = {OptocNode{.material_type = 23, .signed_distance = 0, .first_child_node = 0}}};
+    OptocTreeView changed_view = Parser::pack_optoctree_batch(changed);
+    Writer::optoctreeview_to_file(paths[1], changed_view);
+
+    OptocManifest baseline = manifest;
+    ASSERT_EQ(Manifest::update(manifest, paths), 1); // size of second file has changed
+    ASSERT_EQ(manifest.batches[0], baseline.batches[0]);
+    ASSERT_NE(manifest.batches[1].hashes.tree_hashes[5], baseline.batches[1].hashes.tree_hashes[5]);
+
+    ASSERT_TRUE(Differ::find_difference(baseline.batches[0], original).empty());
+
+    auto difference = Differ::find_difference(baseline.batches[1], changed_view);
+    ASSERT_EQ(difference.size(), 1);
+    ASSERT_EQ(difference[0].octree_number, 5);
+    ASSERT_EQ(difference[0].nodes[0].material_type, 23);
+}
@@ -0,0 +1,64 @@
+/// GPLv3 LICENSE, Copyright (©) 2025, Maksim Shchavelev <maksimshchavelev@gmail.com>
+/// See LICENSE for details
+
+#include "memory/memory.hpp"
+#include "parser/parser.hpp"
+#include "statistics/statistics.hpp"
+#include "test_helpers.hpp"
+#include <gtest/gtest.h>
+
+using namespace optoctreeparser;
+
+
+TEST(Memory, shrink_and_usage) {
+    OptocRoot batch = test::make_leaf_batch(37, 130);
+    batch.trees[7].nodes.reserve(100);
+
+    OptocMemoryUsage usage = Memory::of_batch(batch);
+    std::size_t tree_size = sizeof(OptocTree) + sizeof(OptocNode);
+    ASSERT_EQ(usage.used, sizeof(OptocRoot) + Octree::trees_per_batch * tree_size);
+    ASSERT_EQ(usage.reserved - usage.used, 99 * sizeof(OptocNode));
+
+    ASSERT_EQ(Memory::shrink(batch), 99 * sizeof(OptocNode));
+    usage = Memory::of_batch(batch);
+    ASSERT_EQ(usage.used, usage.reserved);
+
+    // Parsed patch reserves exactly what it declares
+    OptocPatchTree patch_tree{.octree_number = 3, .node_count = 1, .nodes = batch.trees[0].nodes};
+    OptocPatchBatch patch_batch{
+        .x_position = 1, .y_position = -2, .z_position = 3, .octree_count = 2, .octrees = {}};
+    patch_batch.octrees = {patch_tree, patch_tree};
+    OptocPatchRoot patch{.version = 0, .batches = {patch_batch, patch_batch, patch_batch}};
+
+    OptocPatchRoot parsed = Parser::parse_optoctreepatch(Parser::pack_optoctreepatch(patch));
+    ASSERT_EQ(parsed, patch);
+
+    OptocMemoryUsage patch_usage = Memory::of_patch(parsed);
+    ASSERT_EQ(patch_usage.used, patch_usage.reserved);
+    ASSERT_EQ(Memory::shrink(parsed), 0);
+}
+
+
+TEST(Memory, compact_drops_unreachable_nodes) {
+    // Root with 8 leaves, one of them is inner with children behind 5 orphaned nodes
+    OptocNode leaf{.material_type = 37, .signed_distance = 130, .first_child_node = 0};
+    OptocNode orphan{.material_type = 1, .signed_distance = 1, .first_child_node = 0};
+    OptocNode grandchild{.material_type = 2, .signed_distance = 140, .first_child_node = 0};
+
+    OptocTree tree{};
+    tree.nodes.push_back({.material_type = 37, .signed_distance = 130, .first_child_node = 1});
+    tree.nodes.insert(tree.nodes.end(), 8, leaf);
+    tree.nodes.insert(tree.nodes.end(), 5, orphan);
+    tree.nodes.insert(tree.nodes.end(), 8, grandchild);
+    tree.nodes[4].first_child_node = 14;
+    tree.node_count = static_cast<uint16_t>(tree.nodes.size());
+    Memory::shrink(tree);
+
+    OptocStatistics before = Statistics::of_tree(tree);
+
+    ASSERT_EQ(Memory::compact(tree), 5 * sizeof(OptocNode));
+    ASSERT_EQ(tree.node_count, 17);
+    ASSERT_EQ(tree.nodes.size(), 17);
+    ASSERT_EQ(tree.nodes[4].first_child_node, 9);
+    ASSERT_EQ(Statistics::of_tree(tree), before);
+}
@@ -0,0 +1,88 @@
+/// GPLv3 LICENSE, Copyright (©) 2025, Maksim Shchavelev <maksimshchavelev@gmail.com>
+/// See LICENSE for details
+
+#include "grid/grid.hpp"
+#include "morton/morton.hpp"
+#include <algorithm>
+#include <gtest/gtest.h>
+#include <stdexcept>
+
+using namespace optoctreeparser;
+
+namespace {
+
+/// Tree with a sand ball of radius 10 around `{12, 20, 16}`
+OptocTree make_ball_tree() {
+    OptocGrid grid{};
+    grid.size = Octree::tree_size;
+    grid.material_type.resize(grid.size * grid.size * grid.size, 0);
+    grid.signed_distance.resize(grid.size * grid.size * grid.size, 1);
+
+    for (std::size_t z = 0; z < grid.size; ++z) {
+        for (std::size_t y = 0; y < grid.size; ++y) {
+            for (std::size_t x = 0; x < grid.size; ++x) {
+                auto dx = static_cast<int>(x) - 12;
+                auto dy = static_cast<int>(y) - 20;
+                auto dz = static_cast<int>(z) - 16;
+                if (dx * dx + dy * dy + dz * dz <= 100) {
+                    grid.material_type[Grid::index(grid, x, y, z)] = 37;
+                    grid.signed_distance[Grid::index(grid, x, y, z)] = 200;
+                }
+            }
+        }
+    }
+
+    return Grid::to_tree(grid);
+}
+
+} // namespace
+
+
+TEST(Morton, linearize_round_trip) {
+    OptocTree tree = make_ball_tree();
+    auto      leaves = Morton::linearize(tree);
+
+    ASSERT_TRUE(std::ranges::is_sorted(leaves, {}, &OptocMortonLeaf::code));
+    ASSERT_EQ(Morton::to_tree(leaves), tree);
+
+    ASSERT_EQ(Morton::encode({1, 0, 0}), 1);
+    ASSERT_EQ(Morton::encode({0, 0, 16}), 4 << 12);
+    ASSERT_EQ(Morton::decode(Morton::encode({31, 7, 22})), (OptocVoxel{31, 7, 22}));
+
+    // Every voxel is found in the leaf that the grid has for it
+    OptocGrid grid = Grid::from_tree(tree);
+    for (int32_t z = 0; z < 32; ++z) {
+        for (int32_t y = 0; y < 32; ++y) {
+            for (int32_t x = 0; x < 32; ++x) {
+                const OptocMortonLeaf* leaf = Morton::find(leaves, {x, y, z});
+                ASSERT_NE(leaf, nullptr);
+
+                auto i = static_cast<std::size_t>(x + 32 * (y + 32 * z));
+                ASSERT_EQ(leaf->material_type, grid.material_type[i]);
+            }
+        }
+    }
+}
+
+
+TEST(Morton, subtree_and_invalid_leaves) {
+    OptocTree tree = make_ball_tree();
+    auto      leaves = Morton::linearize(tree);
+
+    // The eight octants split the list into contiguous runs
+    std::size_t total{0};
+    for (std::size_t child = 0; child < 8; ++child) {
+        OptocVoxel offset = Octree::child_offset(child);
+        auto       run = Morton::subtree(leaves, {offset.x * 16, offset.y * 16, offset.z * 16}, 1);
+        total += run.size();
+    }
+    ASSERT_EQ(total, leaves.size());
+    ASSERT_EQ(Morton::subtree(leaves, {0, 0, 0}, 0).size(), leaves.size());
+
+    std::vector<OptocMortonLeaf> gap = {
+        {.code = 0, .depth = 1, .material_type = 0, .signed_distance = 1}};
+    ASSERT_THROW(Morton::to_tree(gap), std::invalid_argument);
+
+    std::vector<OptocMortonLeaf> unsorted(leaves.rbegin(), leaves.rend());
+    ASSERT_THROW(Morton::to_tree(unsorted), std::invalid_argument);
+}
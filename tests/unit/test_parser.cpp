@@ -1,11 +1,55 @@
 /// GPLv3 LICENSE, Copyright (©) 2025, Maksim Shchavelev <maksimshchavelev@gmail.com>
 /// See LICENSE for details
 
+#include "memory/memory.hpp"
+#include "parser/codec.hpp"
 #include "parser/parser.hpp"
+#include <algorithm>
+#include <array>
 #include <gtest/gtest.h>
+#include <stdexcept>
 
 using namespace optoctreeparser;
 
+namespace {
+
+/// Batch with 2 nodes in the first tree and 124 empty trees
+constexpr std::array<byte, 262> golden_batch = [] {
+    std::array<byte, 262> bytes{};
+    std::array<byte, 14>  head = {0x04, 0x00, 0x00, 0x00, // Version
+                                  0x02, 0x00,             // Node count
+                                  0x25, 0x80, 0x01, 0x00, // Node 0
+                                  0x00, 0x7E, 0x00, 0x00};
+    std::ranges::copy(head, bytes.begin());
+    return bytes;
+}();
+
+/// One batch with one tree of one node
+constexpr std::array<byte, 18> golden_patch = {
+    0x00, 0x00, 0x00, 0x00,             // Version
+    0x0C, 0x00, 0x12, 0x00, 0xFE, 0xFF, // Position 12, 18, -2
+    0x01,                               // Octree count
+    0x03, 0x01, 0x00,                   // Octree number and node count
+    0x23, 0x81, 0x00, 0x00};            // Node
+
+// Golden vectors are checked while compiling
+static_assert(Codec::read_batch(golden_batch).version == 4);
+static_assert(Codec::read_batch(golden_batch).trees.size() == 125);
+static_assert(Codec::read_batch(golden_batch).trees[0].nodes[1] ==
+              OptocNode{.material_type = 0, .signed_distance = 0x7E, .first_child_node = 0});
+static_assert(std::ranges::equal(Codec::write_batch(Codec::read_batch(golden_batch)),
+                                 golden_batch));
+static_assert(Codec::find_tree_offsets(golden_batch)[1] == 14);
+
+static_assert(Codec::read_patch(golden_patch).batches[0].z_position == -2);
+static_assert(Codec::read_patch(golden_patch).batches[0].octrees[0].nodes[0].material_type ==
+              0x23);
+static_assert(Codec::count_patch(golden_patch).nodes == 1);
+static_assert(std::ranges::equal(Codec::write_patch(Codec::read_patch(golden_patch)),
+                                 golden_patch));
+
+} // namespace
+
 TEST(Parser, parse_1_tree_2_nodes) {
     OptocTreeView batch = {
         // ---- Version (int32 LE = 4) ----
@@ -261,3 +305,92 @@ TEST(Parser, pack_optoctreepatch) {
     ASSERT_EQ(raw.size(), packed.size());
     ASSERT_EQ(raw, packed);
 }
+
+
+
+TEST(Parser, parse_truncated_input_throws) {
+    OptocTreeView batch = {
+        0x04, 0x00, 0x00, 0x00, // Version
+        0x02, 0x00,             // node_count = 2, but only one node follows
+        0x25, 0x80, 0x00, 0x00,
+    };
+
+    ASSERT_THROW(Parser::parse_optoctree_batch(batch), std::out_of_range);
+    ASSERT_THROW(Parser::parse_optoctree_batch(OptocTreeView{0x04}), std::out_of_range);
+
+    OptocTreeView patch = {
+        0x00, 0x00, 0x00, 0x00,             // Version
+        0x01, 0x00, 0x02, 0x00, 0x03, 0x00, // Position
+        0x01,                               // Octree count
+        0x05, 0x01,                         // Octree number and half of node count
+    };
+
+    ASSERT_THROW(Parser::parse_optoctreepatch(patch), std::out_of_range);
+}
+
+
+
+TEST(Parser, parse_optoctreepatch_tree_with_children) {
+    OptocPatchRoot patch{.version = 0, .batches = {}};
+
+    OptocPatchTree tree{.octree_number = 7, .node_count = 9, .nodes = {}};
+    tree.nodes.push_back({.material_type = 37, .signed_distance = 126, .first_child_node = 1});
+    for (byte child = 0; child < 8; ++child) {
+        tree.nodes.push_back(
+            {.material_type = child, .signed_distance = 120, .first_child_node = 0});
+    }
+
+    patch.batches.push_back({.x_position = -1,
+                             .y_position = 2,
+                             .z_position = 3,
+                             .octree_count = 2,
+                             .octrees = {tree, tree}});
+
+    OptocTreeView packed = Parser::pack_optoctreepatch(patch);
+
+    ASSERT_EQ(Parser::parse_optoctreepatch(packed), patch);
+}
+
+
+
+TEST(Parser, flat_optoctreepatch) {
+    OptocTreeView raw = {
+                         0x00, 0x00, 0x00, 0x00, 0x0C, 0x00, 0x12, 0x00, 0x0C, 0x00, 0x03, 0x00, 0x01, 0x00, 0x00,
+                         0x00, 0x00, 0x00, 0x01, 0x01, 0x00, 0x00, 0x00, 0x00, 0x00, 0x02, 0x01, 0x00, 0x00, 0x00,
+                         0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x01, 0x7C, 0x01, 0x00, 0x23, 0x00, 0x00,
+                         0x00, 0xFE, 0xFF, 0x13, 0x00, 0xFC, 0xFF, 0x02, 0x23, 0x01, 0x00, 0x01, 0x00, 0x00, 0x00,
+                         0x4C, 0x01, 0x00, 0x01, 0x00, 0x00, 0x00, 0x1C, 0x00, 0x13, 0x00, 0x1C, 0x00, 0x02, 0x64,
+                         0x01, 0x00, 0x23, 0x00, 0x00, 0x00, 0x03, 0x01, 0x00, 0x23, 0x00, 0x00, 0x00};
+
+    OptocFlatPatchRoot flat = Parser::parse_optoctreepatch_flat(raw);
+    OptocPatchRoot     nested = Parser::parse_optoctreepatch(raw);
+
+    ASSERT_EQ(flat.batches.size(), nested.batches.size());
+
+    OptocMemoryUsage usage = Memory::of_flat_patch(flat);
+    ASSERT_EQ(usage.used, usage.reserved);
+    ASSERT_EQ(Parser::flatten_patch(nested), flat);
+    ASSERT_EQ(Parser::expand_patch(flat), nested);
+    ASSERT_EQ(Parser::pack_optoctreepatch_flat(flat), raw);
+
+    // Batches are written in their order, trees are gathered from wherever they are
+    std::swap(flat.batches[0], flat.batches[1]);
+    std::swap(nested.batches[0], nested.batches[1]);
+    ASSERT_EQ(Parser::parse_optoctreepatch(Parser::pack_optoctreepatch_flat(flat)), nested);
+
+    flat.trees.back().node_count = 1000;
+    ASSERT_THROW(Parser::pack_optoctreepatch_flat(flat), std::out_of_range);
+    ASSERT_THROW(Parser::parse_optoctreepatch_flat(OptocTreeView(raw.begin(), raw.end() - 1)),
+                 std::out_of_range);
+}
+
+
+
+TEST(Parser, codec_matches_parser) {
+    OptocTreeView batch(golden_batch.begin(), golden_batch.end());
+    OptocTreeView patch(golden_patch.begin(), golden_patch.end());
+
+    ASSERT_EQ(Codec::read_batch(batch), Parser::parse_optoctree_batch(batch));
+    ASSERT_EQ(Codec::read_patch(patch), Parser::parse_optoctreepatch(patch));
+    ASSERT_THROW(Codec::read_batch(std::span(batch).first(20)), std::out_of_range);
+}
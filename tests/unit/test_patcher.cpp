@@ -0,0 +1,107 @@
+/// GPLv3 LICENSE, Copyright (©) 2025, Maksim Shchavelev <maksimshchavelev@gmail.com>
+/// See LICENSE for details
+
+#include "octree/octree.hpp"
+#include "parser/parser.hpp"
+#include "patcher/patcher.hpp"
+#include "reader/reader.hpp"
+#include <gtest/gtest.h>
+#include <stdexcept>
+
+using namespace optoctreeparser;
+
+namespace {
+
+OptocPatchTree make_patch_tree(byte octree_number, byte material) {
+    return {.octree_number = octree_number,
+            .node_count = 1,
+            .nodes = {{.material_type = material, .signed_distance = 200, .first_child_node = 0}}};
+}
+
+
+/// Two batches from the real file, the second one with all trees empty
+OptocWorld make_world() {
+    OptocRoot batch = Parser::parse_optoctree_batch(
+        Reader::optoctreeview_from_file("resources/read_real_subnautica_optoctree.optoctrees"));
+
+    OptocWorld world;
+    world[{10, 12, 14}] = batch;
+    world[{-1, 0, 3}] =
+        OptocRoot{.version = 4, .trees = std::vector<OptocTree>(Octree::trees_per_batch)};
+    return world;
+}
+
+} // namespace
+
+
+TEST(Patcher, inverse_restores_world) {
+    OptocWorld original = make_world();
+
+    // Tree 5 of the first batch is patched twice, in two different batch records
+    OptocPatchRoot patch{
+        .version = 1,
+        .batches = {{10, 12, 14, 2, {make_patch_tree(5, 37), make_patch_tree(90, 23)}},
+                    {-1, 0, 3, 1, {make_patch_tree(0, 37)}},
+                    {10, 12, 14, 1, {make_patch_tree(5, 41)}}}};
+
+    OptocPatchRoot expected_inverse = Patcher::make_inverse(original, patch);
+
+    OptocWorld     world = original;
+    OptocPatchRoot inverse = Patcher::apply_with_inverse(world, patch);
+
+    ASSERT_EQ(inverse, expected_inverse);
+    ASSERT_EQ(inverse.batches.size(), 2); // The third record has nothing new to restore
+    ASSERT_EQ(inverse.batches[0].octrees[0].nodes, (original[{10, 12, 14}].trees[5].nodes));
+
+    ASSERT_EQ((world[{10, 12, 14}].trees[5].nodes[0].material_type), 41);
+    ASSERT_EQ((world[{-1, 0, 3}].trees[0].node_count), 1);
+
+    // Inverse survives packing, like any other patch
+    Patcher::apply(world, Parser::parse_optoctreepatch(Parser::pack_optoctreepatch(inverse)));
+    ASSERT_EQ(world, original);
+}
+
+
+TEST(Patcher, invalid_patch_changes_nothing) {
+    OptocWorld original = make_world();
+    OptocWorld world = original;
+
+    OptocPatchRoot absent_batch{.version = 1,
+                                .batches = {{10, 12, 14, 1, {make_patch_tree(1, 37)}},
+                                            {7, 7, 7, 1, {make_patch_tree(1, 37)}}}};
+    ASSERT_THROW(Patcher::apply(world, absent_batch), std::out_of_range);
+    ASSERT_THROW(Patcher::apply_with_inverse(world, absent_batch), std::out_of_range);
+
+    OptocPatchRoot absent_tree{.version = 1,
+                               .batches = {{10, 12, 14, 1, {make_patch_tree(200, 37)}}}};
+    ASSERT_THROW(Patcher::apply(world, absent_tree), std::out_of_range);
+
+    ASSERT_EQ(world, original);
+}
+
+
+TEST(Patcher, patches_world_index) {
+    WorldIndex original;
+    for (const auto& [coordinate, batch] : make_world()) {
+        original.insert(coordinate, batch);
+    }
+
+    OptocPatchRoot patch{
+        .version = 1,
+        .batches = {{10, 12, 14, 1, {make_patch_tree(5, 37)}},
+                    {-1, 0, 3, 1, {make_patch_tree(0, 23)}}}};
+
+    WorldIndex     world = original;
+    OptocPatchRoot inverse = Patcher::apply_with_inverse(world, patch);
+
+    ASSERT_EQ(inverse, Patcher::make_inverse(original, patch));
+    ASSERT_EQ(world.find({10, 12, 14})->trees[5].nodes[0].material_type, 37);
+    ASSERT_EQ(world.find({-1, 0, 3})->trees[0].nodes[0].material_type, 23);
+
+    Patcher::apply(world, inverse);
+    ASSERT_EQ(*world.find({10, 12, 14}), *original.find({10, 12, 14}));
+    ASSERT_EQ(*world.find({-1, 0, 3}), *original.find({-1, 0, 3}));
+
+    OptocPatchRoot absent_batch{.version = 1, .batches = {{7, 7, 7, 1, {make_patch_tree(1, 37)}}}};
+    ASSERT_THROW(Patcher::apply(world, absent_batch), std::out_of_range);
+}
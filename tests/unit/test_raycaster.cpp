@@ -0,0 +1,120 @@
+/// GPLv3 LICENSE, Copyright (©) 2025, Maksim Shchavelev <maksimshchavelev@gmail.com>
+/// See LICENSE for details
+
+#include "editor/editor.hpp"
+#include "grid/grid.hpp"
+#include "raycaster/raycaster.hpp"
+#include "test_helpers.hpp"
+#include <cmath>
+#include <gtest/gtest.h>
+#include <random>
+#include <stdexcept>
+
+using namespace optoctreeparser;
+
+namespace {
+
+/// Empty batch with a sand box `[40, 60) × [40, 60) × [40, 60)` and a sphere of material 23
+OptocRoot make_batch() {
+    OptocRoot batch = test::make_leaf_batch();
+
+    std::vector<EditOperation> operations = {
+        Editor::box(EditMode::add, 37, {40.0f, 40.0f, 40.0f}, {60.0f, 60.0f, 60.0f}),
+        Editor::sphere(EditMode::add, 23, {110.0f, 100.0f, 90.0f}, 12.0f)};
+    Editor::apply(batch, operations);
+
+    return batch;
+}
+
+} // namespace
+
+
+TEST(Raycaster, hits_box_and_world) {
+    OptocRoot batch = make_batch();
+
+    auto hit = Raycaster::cast(batch, {.origin = {-10.0f, 50.5f, 50.5f}, .direction = {2, 0, 0}});
+    ASSERT_TRUE(hit.has_value());
+    ASSERT_NEAR(hit->distance, 50.0f, 1e-4f);
+    ASSERT_NEAR(hit->position.x, 40.0f, 1e-4f);
+    ASSERT_EQ(hit->material_type, 37);
+    ASSERT_EQ(hit->tree, Octree::tree_index({40, 50, 50}));
+
+    ASSERT_FALSE(Raycaster::cast(batch, {{-10.0f, 50.5f, 50.5f}, {1, 0, 0}}, 40.0f).has_value());
+    ASSERT_FALSE(Raycaster::cast(batch, {{-10.0f, 5.5f, 50.5f}, {1, 0, 0}}).has_value());
+    ASSERT_THROW(Raycaster::cast(batch, {{0, 0, 0}, {0, 0, 0}}), std::invalid_argument);
+
+    // Same batch at {-1, 0, 0} of world, ray goes through batch {0, 0, 0} which is absent
+    OptocWorld world;
+    world[{-1, 0, 0}] = batch;
+
+    auto world_hit =
+        Raycaster::cast(world, {.origin = {300.0f, 50.5f, 50.5f}, .direction = {-1, 0, 0}}, 1000);
+    ASSERT_TRUE(world_hit.has_value());
+    ASSERT_NEAR(world_hit->position.x, -160.0f + 60.0f, 1e-3f);
+    ASSERT_EQ(world_hit->batch, (OptocBatchCoordinate{-1, 0, 0}));
+    ASSERT_EQ(world_hit->material_type, 37);
+
+    ASSERT_FALSE(Raycaster::cast(world, {{300.0f, 50.5f, 50.5f}, {-1, 0, 0}}, 350).has_value());
+
+    // WorldIndex is cast against directly, with the same hits
+    WorldIndex index;
+    index.insert({-1, 0, 0}, batch);
+
+    ASSERT_EQ(Raycaster::cast(index, {{300.0f, 50.5f, 50.5f}, {-1, 0, 0}}, 1000), world_hit);
+    ASSERT_FALSE(Raycaster::cast(index, {{300.0f, 50.5f, 50.5f}, {-1, 0, 0}}, 350).has_value());
+    ASSERT_THROW(Raycaster::cast(world, {{0, 0, 0}, {1, 0, 0}}, Raycaster::infinity),
+                 std::invalid_argument);
+}
+
+
+TEST(Raycaster, matches_ray_marching) {
+    OptocRoot batch = make_batch();
+    OptocGrid grid = Grid::from_batch(batch);
+
+    std::mt19937                          random(7);
+    std::uniform_real_distribution<float> position(-20.0f, 180.0f);
+    std::uniform_real_distribution<float> direction(-1.0f, 1.0f);
+
+    std::vector<OptocRay> rays;
+    for (int i = 0; i < 300; ++i) {
+        rays.push_back({{position(random), position(random), position(random)},
+                        {direction(random), direction(random), direction(random)}});
+    }
+
+    auto hits = Raycaster::cast(batch, rays, Raycaster::infinity, 4);
+
+    auto material_at = [&grid](float x, float y, float z) -> int {
+        if (x < 0 || y < 0 || z < 0 || x >= 160 || y >= 160 || z >= 160)
+            return 0;
+        return grid.material_type[Grid::index(grid,
+                                              static_cast<std::size_t>(x),
+                                              static_cast<std::size_t>(y),
+                                              static_cast<std::size_t>(z))];
+    };
+
+    std::size_t hit_count{0};
+    for (std::size_t i = 0; i < rays.size(); ++i) {
+        const OptocRay& ray = rays[i];
+        float length = std::sqrt(ray.direction.x * ray.direction.x +
+                                 ray.direction.y * ray.direction.y +
+                                 ray.direction.z * ray.direction.z);
+        OptocPoint d{ray.direction.x / length, ray.direction.y / length, ray.direction.z / length};
+
+        float end = hits[i] ? hits[i]->distance - 1e-2f : 400.0f;
+        for (float t = 0; t < end; t += 0.05f) {
+            ASSERT_EQ(material_at(ray.origin.x + d.x * t, ray.origin.y + d.y * t,
+                                  ray.origin.z + d.z * t),
+                      0);
+        }
+
+        if (hits[i]) {
+            float t = hits[i]->distance + 1e-2f;
+            ASSERT_EQ(material_at(ray.origin.x + d.x * t, ray.origin.y + d.y * t,
+                                  ray.origin.z + d.z * t),
+                      hits[i]->material_type);
+            ++hit_count;
+        }
+    }
+
+    ASSERT_GT(hit_count, 0);
+}
@@ -0,0 +1,97 @@
+/// GPLv3 LICENSE, Copyright (©) 2025, Maksim Shchavelev <maksimshchavelev@gmail.com>
+/// See LICENSE for details
+
+#include "editor/editor.hpp"
+#include "grid/grid.hpp"
+#include "sampler/sampler.hpp"
+#include "signed_distance/signed_distance.hpp"
+#include "test_helpers.hpp"
+#include <cmath>
+#include <gtest/gtest.h>
+#include <limits>
+
+using namespace optoctreeparser;
+
+
+TEST(Sampler, continuous_across_batches) {
+    WorldIndex world;
+    world.insert({-1, 0, 0}, test::make_leaf_batch(0, SignedDistance::encode(10.0f)));
+    world.insert({0, 0, 0}, test::make_leaf_batch(0, SignedDistance::encode(20.0f)));
+
+    Sampler sampler(world);
+    ASSERT_FLOAT_EQ(sampler.distance({-0.5f, 10.0f, 10.0f}), 10.0f);
+    ASSERT_FLOAT_EQ(sampler.distance({0.5f, 10.0f, 10.0f}), 20.0f);
+    ASSERT_FLOAT_EQ(sampler.distance({0.0f, 10.0f, 10.0f}), 15.0f);
+
+    // Absent batch {1, 0, 0} is empty space
+    ASSERT_FLOAT_EQ(sampler.voxel_distance({160, 10, 10}), SignedDistance::max_outside);
+
+    // No jumps when crossing the border
+    float previous = sampler.distance({-5.0f, 80.3f, 80.7f});
+    for (float x = -5.0f; x < 5.0f; x += 0.01f) {
+        float current = sampler.distance({x, 80.3f, 80.7f});
+        ASSERT_LE(std::abs(current - previous), 10.0f * 0.011f);
+        previous = current;
+    }
+
+    ASSERT_GT(sampler.cache_hits(), sampler.cache_misses());
+}
+
+
+TEST(Sampler, matches_grid) {
+    OptocRoot batch = test::make_leaf_batch();
+
+    std::vector<EditOperation> operations = {
+        Editor::sphere(EditMode::add, 37, {40.0f, 70.0f, 100.0f}, 15.0f)};
+    Editor::apply(batch, operations);
+
+    OptocGrid  grid = Grid::from_batch(batch);
+    WorldIndex world;
+    world.insert({2, -3, 1}, batch);
+
+    Sampler    sampler(world);
+    OptocVoxel origin{2 * 160, -3 * 160, 1 * 160};
+
+    for (int32_t z = 80; z < 120; ++z) {
+        for (int32_t y = 50; y < 90; ++y) {
+            for (int32_t x = 20; x < 60; ++x) {
+                auto i = Grid::index(grid,
+                                     static_cast<std::size_t>(x),
+                                     static_cast<std::size_t>(y),
+                                     static_cast<std::size_t>(z));
+
+                OptocVoxel voxel{origin.x + x, origin.y + y, origin.z + z};
+                ASSERT_EQ(sampler.material(voxel), grid.material_type[i]);
+                ASSERT_FLOAT_EQ(
+                    sampler.voxel_distance(voxel),
+                    SignedDistance::decode(grid.signed_distance[i], grid.material_type[i]));
+            }
+        }
+    }
+}
+
+
+TEST(Sampler, far_voxels_are_empty) {
+    constexpr int32_t low = std::numeric_limits<int32_t>::min();
+    constexpr int32_t high = std::numeric_limits<int32_t>::max();
+
+    // Batches at both ends of int16 range
+    WorldIndex world;
+    world.insert({-32768, 0, 0}, test::make_leaf_batch(5, SignedDistance::encode(-3.0f)));
+    world.insert({32767, 0, 0}, test::make_leaf_batch(7, SignedDistance::encode(-3.0f)));
+
+    Sampler sampler(world);
+    ASSERT_EQ(sampler.material({-32768 * 160, 0, 0}), 5);
+    ASSERT_EQ(sampler.material({32768 * 160 - 1, 0, 0}), 7);
+
+    // Voxels of batches past int16 range neither overflow nor alias batches inside it
+    ASSERT_EQ(sampler.material({-32768 * 160 - 1, 0, 0}), 0);
+    ASSERT_EQ(sampler.material({32768 * 160, 0, 0}), 0);
+    ASSERT_EQ(sampler.material({low, 0, 0}), 0);
+    ASSERT_EQ(sampler.material({high, high, high}), 0);
+    ASSERT_FLOAT_EQ(sampler.voxel_distance({low, low, low}), SignedDistance::max_outside);
+
+    ASSERT_FLOAT_EQ(sampler.distance({1e30f, 0.0f, 0.0f}), SignedDistance::max_outside);
+    ASSERT_FLOAT_EQ(sampler.distance({-1e30f, -1e30f, -1e30f}), SignedDistance::max_outside);
+    ASSERT_FLOAT_EQ(sampler.distance({-32768.0f * 160.0f + 0.5f, 0.5f, 0.5f}), -3.0f);
+}
@@ -0,0 +1,68 @@
+/// GPLv3 LICENSE, Copyright (©) 2025, Maksim Shchavelev <maksimshchavelev@gmail.com>
+/// See LICENSE for details
+
+#include "differ/differ.hpp"
+#include "snapshot/snapshot.hpp"
+#include "test_helpers.hpp"
+#include <gtest/gtest.h>
+#include <thread>
+
+using namespace optoctreeparser;
+
+
+TEST(Snapshot, copy_on_write) {
+    OptocRoot root = test::make_leaf_batch(37, 130);
+    Snapshot  current(root);
+    Snapshot  previous = current;
+
+    ASSERT_EQ(previous.tree_pointer(12), current.tree_pointer(12));
+
+    current.mutable_tree(12).nodes[0].material_type = 23;
+
+    ASSERT_EQ(previous.tree(12).nodes[0].material_type, 37);
+    ASSERT_EQ(current.tree(12).nodes[0].material_type, 23);
+    ASSERT_NE(previous.tree_pointer(12), current.tree_pointer(12));
+    ASSERT_EQ(previous.tree_pointer(13), current.tree_pointer(13));
+    ASSERT_EQ(previous.to_root(), root);
+
+    auto difference = Differ::find_difference(previous, current);
+    ASSERT_EQ(difference.size(), 1);
+    ASSERT_EQ(difference[0].octree_number, 12);
+    ASSERT_EQ(difference, Differ::find_difference(previous.to_root(), current.to_root()));
+}
+
+
+TEST(Snapshot, deduplicate) {
+    std::vector<Snapshot> snapshots = {Snapshot(test::make_leaf_batch(37, 130)),
+                                       Snapshot(test::make_leaf_batch(37, 130))};
+    snapshots[1].set_tree(0, OptocTree{.node_count = 0, .nodes = {}});
+
+    // Every tree but one is identical to the first tree of the first snapshot
+    ASSERT_EQ(Snapshot::deduplicate(snapshots), 124 + 124);
+    ASSERT_EQ(snapshots[0].tree_pointer(0), snapshots[1].tree_pointer(1));
+    ASSERT_EQ(snapshots[0].to_root(), test::make_leaf_batch(37, 130));
+    ASSERT_EQ(snapshots[1].tree(0).node_count, 0);
+}
+
+
+TEST(Snapshot, copies_mutated_from_different_threads) {
+    constexpr int32_t thread_count = 4;
+    Snapshot          original(test::make_leaf_batch(37, 130));
+
+    {
+        std::vector<std::jthread> threads;
+        for (int32_t thread = 0; thread < thread_count; ++thread) {
+            threads.emplace_back([original, thread]() mutable {
+                for (int32_t i = 0; i < 200; ++i) {
+                    Snapshot copy = original; // Dropped at the end of iteration
+                    original.mutable_tree(static_cast<std::size_t>(i) % original.size())
+                        .nodes[0]
+                        .material_type = static_cast<byte>(thread);
+                    EXPECT_EQ(copy.tree(0).nodes[0].signed_distance, 130);
+                }
+            });
+        }
+    }
+
+    ASSERT_EQ(original.to_root(), test::make_leaf_batch(37, 130));
+}
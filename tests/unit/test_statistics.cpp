@@ -0,0 +1,54 @@
+/// GPLv3 LICENSE, Copyright (©) 2025, Maksim Shchavelev <maksimshchavelev@gmail.com>
+/// See LICENSE for details
+
+#include "statistics/statistics.hpp"
+#include "test_helpers.hpp"
+#include <gtest/gtest.h>
+
+using namespace optoctreeparser;
+
+
+TEST(Statistics, of_tree) {
+    // Root with 8 children: 6 of sand (37), 2 empty
+    OptocTree tree{};
+    tree.nodes.push_back({.material_type = 37, .signed_distance = 126, .first_child_node = 1});
+    for (std::size_t child = 0; child < 8; ++child) {
+        byte material = child < 6 ? 37 : 0;
+        tree.nodes.push_back(
+            {.material_type = material, .signed_distance = 130, .first_child_node = 0});
+    }
+    tree.node_count = 9;
+
+    OptocStatistics statistics = Statistics::of_tree(tree);
+
+    ASSERT_EQ(statistics.tree_count, 1);
+    ASSERT_EQ(statistics.leaf_count, 8);
+    ASSERT_EQ(statistics.inner_count, 1);
+    ASSERT_EQ(statistics.material_leaves[37], 6);
+    ASSERT_EQ(statistics.material_leaves[0], 2);
+    ASSERT_DOUBLE_EQ(statistics.material_volume[37], 6 * 16 * 16 * 16);
+    ASSERT_EQ(statistics.distance_leaves[130], 8);
+    ASSERT_EQ(statistics.tree_depths, (std::vector<uint64_t>{0, 1}));
+    ASSERT_EQ(statistics.leaf_depths, (std::vector<uint64_t>{0, 8}));
+}
+
+
+TEST(Statistics, of_world_equals_sum_of_batches) {
+    std::vector<OptocRoot> batches;
+    for (byte material = 0; material < 10; ++material) {
+        batches.push_back(test::make_leaf_batch(material, 0));
+    }
+
+    std::vector<OptocStatistics> per_batch = Statistics::of_batches(batches, 3);
+    OptocStatistics              sum{};
+    for (const auto& statistics : per_batch) {
+        Statistics::merge(sum, statistics);
+    }
+
+    OptocStatistics world = Statistics::of_world(batches, 3);
+    ASSERT_EQ(world, sum);
+    ASSERT_EQ(world.tree_count, 10 * Octree::trees_per_batch);
+    ASSERT_EQ(world.material_leaves[9], Octree::trees_per_batch);
+    ASSERT_DOUBLE_EQ(world.material_volume[9], Octree::trees_per_batch * 32.0 * 32 * 32);
+    ASSERT_EQ(world, Statistics::of_world(batches, 1));
+}
@@ -0,0 +1,59 @@
+/// GPLv3 LICENSE, Copyright (©) 2025, Maksim Shchavelev <maksimshchavelev@gmail.com>
+/// See LICENSE for details
+
+#include "parser/parser.hpp"
+#include "reader/reader.hpp"
+#include "test_helpers.hpp"
+#include "tracked_batch/tracked_batch.hpp"
+#include <gtest/gtest.h>
+#include <stdexcept>
+
+using namespace optoctreeparser;
+
+
+TEST(TrackedBatch, pack_equals_full_pack) {
+    OptocTreeView source =
+        Reader::optoctreeview_from_file("resources/read_real_subnautica_optoctree.optoctrees");
+    TrackedBatch batch(source);
+
+    ASSERT_EQ(batch.dirty_count(), 0);
+    ASSERT_EQ(batch.pack(), source);
+
+    // Grow one tree, shrink another and replace the last one
+    OptocNode leaf{.material_type = 37, .signed_distance = 130, .first_child_node = 0};
+    OptocTree split{.node_count = 9, .nodes = {}};
+    split.nodes.push_back({.material_type = 37, .signed_distance = 126, .first_child_node = 1});
+    split.nodes.insert(split.nodes.end(), 8, leaf);
+
+    batch.set_tree(3, split);
+    batch.mutable_tree(40).nodes.clear();
+    batch.mutable_tree(40).node_count = 0;
+    batch.set_tree(124, {.node_count = 1, .nodes = {leaf}});
+    batch.set_version(5);
+
+    ASSERT_EQ(batch.dirty_count(), 3);
+    ASSERT_TRUE(batch.is_dirty(40));
+    ASSERT_FALSE(batch.is_dirty(41));
+    ASSERT_EQ(batch.pack(), Parser::pack_optoctree_batch(batch.root()));
+    ASSERT_EQ(batch.source(), source);
+
+    ASSERT_THROW(batch.mutable_tree(Octree::trees_per_batch), std::out_of_range);
+}
+
+
+TEST(TrackedBatch, repack_makes_trees_clean) {
+    TrackedBatch batch(test::make_leaf_batch());
+
+    batch.mutable_tree(7).nodes[0].material_type = 12;
+    OptocTreeView packed = batch.repack();
+
+    ASSERT_EQ(batch.dirty_count(), 0);
+    ASSERT_EQ(packed, Parser::pack_optoctree_batch(batch.root()));
+    ASSERT_EQ(TrackedBatch(packed).root(), batch.root());
+
+    batch.set_version(9);
+    ASSERT_EQ(Parser::parse_optoctree_batch(batch.repack()).version, 9);
+
+    ASSERT_THROW(TrackedBatch(OptocRoot{.version = 4, .trees = {batch.tree(0)}}),
+                 std::invalid_argument);
+}
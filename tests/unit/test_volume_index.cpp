@@ -0,0 +1,63 @@
+/// GPLv3 LICENSE, Copyright (©) 2025, Maksim Shchavelev <maksimshchavelev@gmail.com>
+/// See LICENSE for details
+
+#include "editor/editor.hpp"
+#include "grid/grid.hpp"
+#include "test_helpers.hpp"
+#include "volume_index/volume_index.hpp"
+#include <gtest/gtest.h>
+#include <stdexcept>
+
+using namespace optoctreeparser;
+
+namespace {
+
+/// Empty batch with a sand box `[8, 24) × [8, 24) × [8, 40)` (crosses trees 0 and 25)
+OptocRoot make_batch() {
+    OptocRoot batch = test::make_leaf_batch();
+
+    std::vector<EditOperation> operations = {
+        Editor::box(EditMode::add, 37, {8.0f, 8.0f, 8.0f}, {24.0f, 24.0f, 40.0f})};
+    Editor::apply(batch, operations);
+
+    return batch;
+}
+
+} // namespace
+
+
+TEST(VolumeIndex, exact_on_aligned_boxes) {
+    OptocRoot        batch = make_batch();
+    OptocVolumeIndex index = VolumeIndex::build(batch, 4);
+
+    ASSERT_EQ(VolumeIndex::materials(index), (std::vector<byte>{0, 37}));
+
+    ASSERT_DOUBLE_EQ(VolumeIndex::volume(index, 37, {0, 0, 0}, {160, 160, 160}), 16.0 * 16 * 32);
+    ASSERT_DOUBLE_EQ(VolumeIndex::volume(index, 37, {0, 0, 0}, {16, 16, 16}), 8.0 * 8 * 8);
+    ASSERT_DOUBLE_EQ(VolumeIndex::volume(index, 0, {0, 0, 0}, {16, 16, 16}),
+                     16.0 * 16 * 16 - 8 * 8 * 8);
+    ASSERT_DOUBLE_EQ(VolumeIndex::volume(index, 37, {100, 100, 100}, {160, 160, 160}), 0.0);
+    ASSERT_DOUBLE_EQ(VolumeIndex::volume(index, 23, {0, 0, 0}, {160, 160, 160}), 0.0);
+}
+
+
+TEST(VolumeIndex, matches_voxel_count) {
+    OptocRoot        batch = make_batch();
+    OptocVolumeIndex exact = VolumeIndex::build(batch, 1);
+    OptocVolumeIndex coarse = VolumeIndex::build(batch, 8);
+
+    // Count voxels of tree 0 directly
+    OptocGrid grid = Grid::from_tree(batch.trees[0]);
+    double    expected{0};
+    for (std::size_t z = 3; z < 13; ++z) {
+        for (std::size_t y = 5; y < 30; ++y) {
+            for (std::size_t x = 0; x < 11; ++x) {
+                expected += grid.material_type[Grid::index(grid, x, y, z)] == 37 ? 1 : 0;
+            }
+        }
+    }
+
+    ASSERT_DOUBLE_EQ(VolumeIndex::volume(exact, 37, {0, 5, 3}, {11, 30, 13}), expected);
+    ASSERT_NEAR(VolumeIndex::volume(coarse, 37, {0, 5, 3}, {11, 30, 13}), expected, 8.0 * 8 * 8);
+    ASSERT_THROW(VolumeIndex::build(batch, 5), std::invalid_argument);
+}
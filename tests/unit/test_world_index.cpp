@@ -0,0 +1,111 @@
+/// GPLv3 LICENSE, Copyright (©) 2025, Maksim Shchavelev <maksimshchavelev@gmail.com>
+/// See LICENSE for details
+
+#include "world_index/world_index.hpp"
+#include <algorithm>
+#include <gtest/gtest.h>
+#include <limits>
+#include <random>
+#include <stdexcept>
+
+using namespace optoctreeparser;
+
+namespace {
+
+OptocRoot make_batch(int32_t version) {
+    return {.version = version, .trees = {}};
+}
+
+} // namespace
+
+
+TEST(WorldIndex, insert_find_erase) {
+    WorldIndex                    world;
+    OptocWorld                    reference;
+    std::mt19937                  random(3);
+    std::uniform_int_distribution coordinate(-6, 6);
+    std::uniform_int_distribution action(0, 2);
+
+    // Compare with unordered_map under random inserts and erases
+    for (int32_t step = 0; step < 5000; ++step) {
+        OptocBatchCoordinate at{coordinate(random), coordinate(random), coordinate(random)};
+
+        if (action(random) == 0) {
+            ASSERT_EQ(world.erase(at), reference.erase(at) == 1);
+        } else {
+            world.insert(at, make_batch(step));
+            reference[at] = make_batch(step);
+        }
+    }
+
+    ASSERT_EQ(world.size(), reference.size());
+    for (const auto& [at, batch] : reference) {
+        ASSERT_NE(world.find(at), nullptr);
+        ASSERT_EQ(world.find(at)->version, batch.version);
+    }
+    for (std::size_t i = 0; i < world.size(); ++i) {
+        ASSERT_EQ(reference.at(world.coordinates()[i]).version, world.batches()[i].version);
+    }
+
+    ASSERT_EQ(world.find({100, 0, 0}), nullptr);
+    ASSERT_EQ(world.find({100000, 0, 0}), nullptr);
+    ASSERT_THROW(world.insert({0, 40000, 0}, make_batch(0)), std::out_of_range);
+}
+
+
+TEST(WorldIndex, neighbours_and_region) {
+    WorldIndex world;
+    for (int32_t z = 0; z < 4; ++z) {
+        for (int32_t y = 0; y < 4; ++y) {
+            for (int32_t x = 0; x < 4; ++x) {
+                world.insert({x - 2, y, z}, make_batch(x + 4 * (y + 4 * z)));
+            }
+        }
+    }
+
+    std::size_t faces{0};
+    std::size_t all{0};
+    auto        count_faces = [&](const auto&, const auto&) { ++faces; };
+    auto        count_all = [&](const auto&, const auto&) { ++all; };
+
+    world.for_each_neighbour({-1, 1, 1}, Connectivity::six, count_faces);
+    world.for_each_neighbour({-1, 1, 1}, Connectivity::twenty_six, count_all);
+    ASSERT_EQ(faces, 6);
+    ASSERT_EQ(all, 26);
+
+    // Corner batch has 7 of 26 neighbours
+    OptocNeighbourhood corner = world.neighbourhood({-2, 0, 0});
+    ASSERT_EQ(corner[13], world.find({-2, 0, 0}));
+    ASSERT_EQ(corner[14], world.find({-1, 0, 0}));
+    ASSERT_EQ(corner[12], nullptr);
+    ASSERT_EQ(std::ranges::count(corner, nullptr), 27 - 8);
+
+    auto small = world.region({-2, 0, 0}, {-1, 1, 0});
+    ASSERT_EQ(small,
+              (std::vector<OptocBatchCoordinate>{{-2, 0, 0}, {-1, 0, 0}, {-2, 1, 0}, {-1, 1, 0}}));
+
+    auto whole = world.region({-100, -100, -100}, {100, 100, 100});
+    ASSERT_EQ(whole.size(), 64);
+    ASSERT_TRUE(world.region({5, 5, 5}, {6, 6, 6}).empty());
+
+    // Boxes outside of int16 are clamped to it, so their offsets neither overflow nor wrap
+    constexpr int32_t low = std::numeric_limits<int32_t>::min();
+    constexpr int32_t high = std::numeric_limits<int32_t>::max();
+    auto widest = world.region({low, low, low}, {high, high, high});
+    ASSERT_EQ(widest, world.region({-32768, -32768, -32768}, {32767, 32767, 32767}));
+    ASSERT_EQ(widest.size(), 64);
+    ASSERT_EQ(world.region({-40000, 0, 0}, {-1, 1, 0}), world.region({-32768, 0, 0}, {-1, 1, 0}));
+    ASSERT_TRUE(world.region({40000, 0, 0}, {high, 1, 0}).empty());
+
+    // Neighbours of coordinates at the edge of int32 are outside of int16 and never overflow
+    world.insert({-32768, 0, 0}, make_batch(0));
+    std::vector<OptocBatchCoordinate> edge;
+    auto collect = [&](const auto& at, const auto&) { edge.push_back(at); };
+
+    world.for_each_neighbour({high, 0, 0}, Connectivity::twenty_six, collect);
+    world.for_each_neighbour({low, low, low}, Connectivity::twenty_six, collect);
+    world.for_each_neighbour({-32767, 0, 0}, Connectivity::six, collect);
+    ASSERT_EQ(edge, (std::vector<OptocBatchCoordinate>{{-32768, 0, 0}}));
+    ASSERT_EQ(std::ranges::count(world.neighbourhood({high, high, high}), nullptr), 27);
+    ASSERT_EQ(world.neighbourhood({-32769, 0, 0})[14], world.find({-32768, 0, 0}));
+}
@@ -0,0 +1,109 @@
+/// GPLv3 LICENSE, Copyright (©) 2025, Maksim Shchavelev <maksimshchavelev@gmail.com>
+/// See LICENSE for details
+
+#include "test_helpers.hpp"
+#include "world_store/world_store.hpp"
+#include <gtest/gtest.h>
+#include <thread>
+
+using namespace optoctreeparser;
+
+
+TEST(WorldStore, publish_find_erase) {
+    WorldStore world(4);
+    ASSERT_EQ(world.find({0, 0, 0}), nullptr);
+
+    auto first = world.publish({0, 0, 0}, Snapshot(test::make_leaf_batch(0, 1, 1)));
+    world.publish({-3, 7, 2}, Snapshot(test::make_leaf_batch(0, 1, 2)));
+
+    ASSERT_EQ(world.size(), 2);
+    ASSERT_EQ(world.find({0, 0, 0}), first);
+    ASSERT_EQ(world.find({-3, 7, 2})->version(), 2);
+
+    // Old version stays valid for its reader after a new one is published
+    auto second = world.update({0, 0, 0}, [](Snapshot& batch) {
+        batch.mutable_tree(3).nodes[0].material_type = 37;
+    });
+    ASSERT_EQ(first->tree(3).nodes[0].material_type, 0);
+    ASSERT_EQ(second->tree(3).nodes[0].material_type, 37);
+    ASSERT_EQ(second->tree_pointer(4), first->tree_pointer(4));
+
+    ASSERT_FALSE(
+        world.compare_and_publish({0, 0, 0}, first, Snapshot(test::make_leaf_batch(0, 1, 5))));
+    ASSERT_TRUE(
+        world.compare_and_publish({0, 0, 0}, second, Snapshot(test::make_leaf_batch(0, 1, 5))));
+    ASSERT_EQ(world.find({0, 0, 0})->version(), 5);
+
+    ASSERT_TRUE(world.erase({0, 0, 0}));
+    ASSERT_FALSE(world.erase({0, 0, 0}));
+    ASSERT_EQ(world.find({0, 0, 0}), nullptr);
+    ASSERT_EQ(world.entries().size(), 1);
+}
+
+
+TEST(WorldStore, concurrent_updates) {
+    WorldStore world(2);
+    world.publish({1, 1, 1}, Snapshot(test::make_leaf_batch(0, 1, 0)));
+
+    constexpr int32_t thread_count = 8;
+    constexpr int32_t updates = 500;
+
+    std::atomic<bool> stop{false};
+    std::jthread      reader([&]() {
+        int32_t last = 0;
+        while (!stop.load()) {
+            int32_t version = world.find({1, 1, 1})->version();
+            EXPECT_GE(version, last); // Readers never see an older version
+            last = version;
+        }
+    });
+
+    {
+        std::vector<std::jthread> writers;
+        for (int32_t thread = 0; thread < thread_count; ++thread) {
+            writers.emplace_back([&world, thread]() {
+                for (int32_t i = 0; i < updates; ++i) {
+                    world.update({1, 1, 1},
+                                 [](Snapshot& batch) { batch.set_version(batch.version() + 1); });
+                    world.publish({thread, 0, 0}, Snapshot(test::make_leaf_batch(0, 1, i)));
+                }
+            });
+        }
+    }
+    stop.store(true);
+
+    ASSERT_EQ(world.find({1, 1, 1})->version(), thread_count * updates);
+    ASSERT_EQ(world.size(), thread_count + 1);
+}
+
+
+TEST(WorldStore, erased_slots_are_dropped) {
+    constexpr int32_t thread_count = 4;
+    constexpr int32_t batches = 300;
+
+    WorldStore world(1); // One shard, so every insert copies the map the other threads use
+
+    {
+        std::vector<std::jthread> threads;
+        for (int32_t thread = 0; thread < thread_count; ++thread) {
+            threads.emplace_back([&world, thread]() {
+                for (int32_t i = 0; i < batches; ++i) {
+                    OptocBatchCoordinate coordinate{thread, i, 0};
+
+                    auto published =
+                        world.publish(coordinate, Snapshot(test::make_leaf_batch(0, 1, i)));
+                    EXPECT_EQ(world.find(coordinate), published);
+                    EXPECT_NE(world.update(coordinate, [](Snapshot&) {}), nullptr);
+                    EXPECT_TRUE(world.erase(coordinate));
+                    EXPECT_EQ(world.find(coordinate), nullptr);
+                }
+            });
+        }
+    }
+
+    ASSERT_EQ(world.size(), 0);
+    ASSERT_LE(world.slot_count(), thread_count);
+
+    world.publish({9, 9, 9}, Snapshot(test::make_leaf_batch()));
+    ASSERT_EQ(world.slot_count(), 1);
+}